@@ -29,11 +29,16 @@
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
 #include "2d/CCDrawingPrimitives.h"
+#include "2d/CCDrawNode.h"
+#include "2d/CCSprite.h"
 #include "base/CCDirector.h"
 
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/ccGLStateCache.h"
+
+#include <typeinfo>
 
 NS_CC_BEGIN
 
@@ -69,6 +74,7 @@ ClippingNode::ClippingNode()
 ,  _currentAlphaTestEnabled(GL_FALSE)
 , _currentAlphaTestFunc(GL_ALWAYS)
 , _currentAlphaTestRef(1)
+, _contentSkipped(false)
 {
 
 }
@@ -223,6 +229,12 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
         return;
     
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
+    if (_contentSkipped)
+    {
+        // the transforms of the content were not updated while it was clipped out
+        flags |= FLAGS_DIRTY_MASK;
+        _contentSkipped = false;
+    }
 
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
@@ -239,6 +251,26 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
 
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
+    Rect scissorRect;
+    if (getScissorRect(renderer, &scissorRect))
+    {
+        // no stencil: the content is skipped when the clip is empty, e.g. scrolled out of its parent clip
+        if (renderer->pushClipRect(&_beforeVisitScissorCmd, _globalZOrder, scissorRect))
+        {
+            visitContent(renderer, flags);
+        }
+        else
+        {
+            _contentSkipped = true;
+        }
+        renderer->popClipRect(&_afterVisitScissorCmd, _globalZOrder);
+
+        renderer->popGroup();
+
+        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        return;
+    }
+
     _beforeVisitCmd.init(_globalZOrder);
     _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisit, this);
     renderer->addCommand(&_beforeVisitCmd);
@@ -269,6 +301,19 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     _afterDrawStencilCmd.func = CC_CALLBACK_0(ClippingNode::onAfterDrawStencil, this);
     renderer->addCommand(&_afterDrawStencilCmd);
 
+    visitContent(renderer, flags);
+
+    _afterVisitCmd.init(_globalZOrder);
+    _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisit, this);
+    renderer->addCommand(&_afterVisitCmd);
+
+    renderer->popGroup();
+    
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+}
+
+void ClippingNode::visitContent(Renderer *renderer, uint32_t flags)
+{
     int i = 0;
     
     if(!_children.empty())
@@ -294,14 +339,41 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
+}
 
-    _afterVisitCmd.init(_globalZOrder);
-    _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisit, this);
-    renderer->addCommand(&_afterVisitCmd);
+bool ClippingNode::getScissorRect(Renderer *renderer, Rect *rect)
+{
+    if (_inverted || _alphaThreshold < 1 || !_stencil || !_stencil->isVisible() || _stencil->getChildrenCount() > 0)
+        return false;
 
-    renderer->popGroup();
-    
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    // only the nodes whose drawing fills exactly their rect, subclasses may draw anything
+    Rect stencilRect;
+    if (typeid(*_stencil) == typeid(DrawNode))
+    {
+        if (!static_cast<DrawNode*>(_stencil)->getRectShape(&stencilRect))
+            return false;
+    }
+    else if (typeid(*_stencil) == typeid(Sprite))
+    {
+        auto sprite = static_cast<Sprite*>(_stencil);
+        if (sprite->getBatchNode())
+            return false;
+
+        auto quad = sprite->getQuad();
+        float minX = std::min(quad.bl.vertices.x, quad.tr.vertices.x);
+        float minY = std::min(quad.bl.vertices.y, quad.tr.vertices.y);
+        stencilRect.setRect(minX, minY, fabsf(quad.tr.vertices.x - quad.bl.vertices.x), fabsf(quad.tr.vertices.y - quad.bl.vertices.y));
+    }
+    else
+    {
+        return false;
+    }
+
+    if (!renderer->isClipRectAvailable())
+        return false;
+
+    Mat4 stencilTransform = _modelViewTransform * _stencil->getNodeToParentTransform();
+    return Renderer::transformClipRect(stencilRect, stencilTransform, rect);
 }
 
 Node* ClippingNode::getStencil() const
@@ -354,27 +426,23 @@ void ClippingNode::onBeforeVisit()
 
     // manually save the stencil state
 
-    _currentStencilEnabled = glIsEnabled(GL_STENCIL_TEST);
-    glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&_currentStencilWriteMask);
-    glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&_currentStencilFunc);
-    glGetIntegerv(GL_STENCIL_REF, &_currentStencilRef);
-    glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint *)&_currentStencilValueMask);
-    glGetIntegerv(GL_STENCIL_FAIL, (GLint *)&_currentStencilFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)&_currentStencilPassDepthFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&_currentStencilPassDepthPass);
+    _currentStencilEnabled = GL::isStencilTestEnabled();
+    _currentStencilWriteMask = GL::getStencilMask();
+    GL::getStencilFunc(&_currentStencilFunc, &_currentStencilRef, &_currentStencilValueMask);
+    GL::getStencilOp(&_currentStencilFail, &_currentStencilPassDepthFail, &_currentStencilPassDepthPass);
 
     // enable stencil use
-    glEnable(GL_STENCIL_TEST);
+    GL::enableStencilTest(true);
     // check for OpenGL error while enabling stencil test
     CHECK_GL_ERROR_DEBUG();
 
     // all bits on the stencil buffer are readonly, except the current layer bit,
     // this means that operation like glClear or glStencilOp will be masked with this value
-    glStencilMask(mask_layer);
+    GL::stencilMask(mask_layer);
 
     // manually save the depth test state
 
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_currentDepthWriteMask);
+    _currentDepthWriteMask = GL::getDepthMask();
 
     // disable depth test while drawing the stencil
     //glDisable(GL_DEPTH_TEST);
@@ -382,7 +450,7 @@ void ClippingNode::onBeforeVisit()
     // as the stencil is not meant to be rendered in the real scene,
     // it should never prevent something else to be drawn,
     // only disabling depth buffer update should do
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 
     ///////////////////////////////////
     // CLEAR STENCIL BUFFER
@@ -393,8 +461,8 @@ void ClippingNode::onBeforeVisit()
     //     never draw it into the frame buffer
     //     if not in inverted mode: set the current layer value to 0 in the stencil buffer
     //     if in inverted mode: set the current layer value to 1 in the stencil buffer
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(!_inverted ? GL_ZERO : GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(!_inverted ? GL_ZERO : GL_REPLACE, GL_KEEP, GL_KEEP);
 
     // draw a fullscreen solid rectangle to clear the stencil buffer
     //ccDrawSolidRect(Vec2::ZERO, ccpFromSize([[Director sharedDirector] winSize]), Color4F(1, 1, 1, 1));
@@ -408,8 +476,8 @@ void ClippingNode::onBeforeVisit()
     //     never draw it into the frame buffer
     //     if not in inverted mode: set the current layer value to 1 in the stencil buffer
     //     if in inverted mode: set the current layer value to 0 in the stencil buffer
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(!_inverted ? GL_REPLACE : GL_ZERO, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(!_inverted ? GL_REPLACE : GL_ZERO, GL_KEEP, GL_KEEP);
 
     // enable alpha test only if the alpha threshold < 1,
     // indeed if alpha threshold == 1, every pixel will be drawn anyways
@@ -427,8 +495,8 @@ void ClippingNode::onBeforeVisit()
 		glAlphaFunc(GL_GREATER, _alphaThreshold);
 #else
 		NOT_SUPPORTED();
-	}
 #endif
+	}
 #else
 	NOT_SUPPORTED();
 #endif
@@ -454,7 +522,7 @@ void ClippingNode::onAfterDrawStencil()
     }
 
     // restore the depth test state
-    glDepthMask(_currentDepthWriteMask);
+    GL::depthMask(_currentDepthWriteMask);
     //if (currentDepthTestEnabled) {
     //    glEnable(GL_DEPTH_TEST);
     //}
@@ -468,8 +536,8 @@ void ClippingNode::onAfterDrawStencil()
     //         draw the pixel and keep the current layer in the stencil buffer
     //     else
     //         do not draw the pixel but keep the current layer in the stencil buffer
-    glStencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
     // draw (according to the stencil test func) this node and its childs
 #endif
@@ -483,12 +551,12 @@ void ClippingNode::onAfterVisit()
     // CLEANUP
 
     // manually restore the stencil state
-    glStencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
-    glStencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
-    glStencilMask(_currentStencilWriteMask);
+    GL::stencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
+    GL::stencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
+    GL::stencilMask(_currentStencilWriteMask);
     if (!_currentStencilEnabled)
     {
-        glDisable(GL_STENCIL_TEST);
+        GL::enableStencilTest(false);
     }
 
     // we are done using this layer, decrement
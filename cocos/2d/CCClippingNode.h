@@ -32,6 +32,7 @@
 #include "CCGL.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCScissorCommand.h"
 
 NS_CC_BEGIN
 
@@ -39,6 +40,9 @@ NS_CC_BEGIN
  It draws its content (childs) clipped using a stencil.
  The stencil is an other Node that will not be drawn.
  The clipping is done using the alpha part of the stencil (adjusted with an alphaThreshold).
+ When the stencil is a single rectangle aligned with the screen (a DrawNode drawing one rectangle, or a Sprite,
+ with an alphaThreshold of 1 and not inverted), the clipping is done with the scissor test instead,
+ which doesn't touch the stencil buffer and keeps batching the content when possible.
  */
 class CC_DLL ClippingNode : public Node
 {
@@ -120,6 +124,13 @@ protected:
     */
     void drawFullScreenQuadClearStencil();
 
+    /** Computes the rect to clip with the scissor test instead of the stencil buffer, in world coordinates.
+     Returns false if the stencil is not a rectangle aligned with the screen.
+     */
+    bool getScissorRect(Renderer* renderer, Rect* rect);
+
+    void visitContent(Renderer* renderer, uint32_t flags);
+
     Node* _stencil;
     GLfloat _alphaThreshold;
     bool    _inverted;
@@ -144,11 +155,16 @@ protected:
     GLclampf _currentAlphaTestRef;
 
     GLint _mask_layer_le;
+
+    // whether the content was not visited last time, because its clip rect was empty
+    bool _contentSkipped;
     
     GroupCommand _groupCommand;
     CustomCommand _beforeVisitCmd;
     CustomCommand _afterDrawStencilCmd;
     CustomCommand _afterVisitCmd;
+    ScissorCommand _beforeVisitScissorCmd;
+    ScissorCommand _afterVisitScissorCmd;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ClippingNode);
@@ -28,6 +28,7 @@
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGLProgramState.h"
+#include "renderer/ccGLStateCache.h"
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
@@ -99,6 +100,31 @@ static inline Tex2F __t(const Vec2 &v)
 	return *(Tex2F*)&v;
 }
 
+// whether the quad `verts` is a rectangle aligned with the axes, with a non empty area
+static bool isAxisAlignedRect(const Vec2* verts, Rect* rect)
+{
+    float minX = std::min(std::min(verts[0].x, verts[1].x), std::min(verts[2].x, verts[3].x));
+    float maxX = std::max(std::max(verts[0].x, verts[1].x), std::max(verts[2].x, verts[3].x));
+    float minY = std::min(std::min(verts[0].y, verts[1].y), std::min(verts[2].y, verts[3].y));
+    float maxY = std::max(std::max(verts[0].y, verts[1].y), std::max(verts[2].y, verts[3].y));
+    if (minX >= maxX || minY >= maxY)
+        return false;
+
+    for (int i = 0; i < 4; i++)
+    {
+        const Vec2& v0 = verts[i];
+        const Vec2& v1 = verts[(i + 1) % 4];
+        // every vertex is a corner, and every edge is either horizontal or vertical
+        if ((v0.x != minX && v0.x != maxX) || (v0.y != minY && v0.y != maxY))
+            return false;
+        if ((v0.x == v1.x) == (v0.y == v1.y))
+            return false;
+    }
+
+    rect->setRect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
 // implementation of DrawNode
 
 DrawNode::DrawNode()
@@ -108,6 +134,10 @@ DrawNode::DrawNode()
 , _bufferCount(0)
 , _buffer(nullptr)
 , _dirty(false)
+, _uploadedCount(0)
+, _vboCapacity(0)
+, _batchingEnabled(false)
+, _shape(Shape::NONE)
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 }
@@ -117,7 +147,7 @@ DrawNode::~DrawNode()
     free(_buffer);
     _buffer = nullptr;
 #if DIRECTX_ENABLED == 0
-    glDeleteBuffers(1, &_vbo);
+    GL::deleteBuffers(1, &_vbo);
     _vbo = 0;
     
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -170,8 +200,10 @@ bool DrawNode::init()
     }
     
     glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, nullptr, GL_DYNAMIC_DRAW);
+    _vboCapacity = _bufferCapacity;
+    _uploadedCount = 0;
     
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
@@ -182,7 +214,7 @@ bool DrawNode::init()
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -209,6 +241,18 @@ bool DrawNode::init()
 
 void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
+    if (_bufferCount == 0)
+        return;
+
+#if DIRECTX_ENABLED == 0
+    if (_batchingEnabled)
+    {
+        _trianglesCommand.init(_globalZOrder, getGLProgramState(), _blendFunc, _buffer, _bufferCount, transform);
+        renderer->addCommand(&_trianglesCommand);
+        return;
+    }
+#endif
+
     _customCommand.init(_globalZOrder);
     _customCommand.func = CC_CALLBACK_0(DrawNode::onDraw, this, transform, flags);
     renderer->addCommand(&_customCommand);
@@ -226,8 +270,17 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t flags)
 
     if (_dirty)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
+        if (_uploadedCount == 0 || _bufferCapacity > _vboCapacity)
+        {
+            // new storage, so that the draws still using the previous geometry don't stall the upload
+            glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, nullptr, GL_DYNAMIC_DRAW);
+            _vboCapacity = _bufferCapacity;
+            _uploadedCount = 0;
+        }
+        // only the vertices added since the last upload
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_uploadedCount, sizeof(V2F_C4B_T2F)*(_bufferCount - _uploadedCount), _buffer + _uploadedCount);
+        _uploadedCount = _bufferCount;
         _dirty = false;
     }
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -238,7 +291,7 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t flags)
     {
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vbo);
         // vertex
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
 
@@ -250,7 +303,7 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t flags)
     }
 
     glDrawArrays(GL_TRIANGLES, 0, _bufferCount);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 #else
 	CCASSERT(false, "Not supported yet.");
 #endif
@@ -278,6 +331,7 @@ void DrawNode::drawDot(const Vec2 &pos, float radius, const Color4F &color)
 	_bufferCount += vertex_count;
 	
 	_dirty = true;
+	_shape = Shape::OTHER;
 }
 
 void DrawNode::drawSegment(const Vec2 &from, const Vec2 &to, float radius, const Color4F &color)
@@ -351,6 +405,7 @@ void DrawNode::drawSegment(const Vec2 &from, const Vec2 &to, float radius, const
 	_bufferCount += vertex_count;
 	
 	_dirty = true;
+	_shape = Shape::OTHER;
 }
 
 void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, float borderWidth, const Color4F &borderColor)
@@ -458,6 +513,19 @@ void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, flo
 	
 	_dirty = true;
 
+    // a single rectangle can be clipped with the scissor test by ClippingNode
+    Rect rect;
+    if (_shape == Shape::NONE && count == 4 && isAxisAlignedRect(verts, &rect))
+    {
+        float extent = (outline ? borderWidth : 0.5f);
+        _shapeRect.setRect(rect.origin.x - extent, rect.origin.y - extent, rect.size.width + 2 * extent, rect.size.height + 2 * extent);
+        _shape = Shape::RECT;
+    }
+    else
+    {
+        _shape = Shape::OTHER;
+    }
+
     free(extrude);
 }
 
@@ -477,6 +545,7 @@ void DrawNode::drawTriangle(const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, cons
 
     _bufferCount += vertex_count;
     _dirty = true;
+    _shape = Shape::OTHER;
 }
 
 void DrawNode::drawCubicBezier(const Vec2& from, const Vec2& control1, const Vec2& control2, const Vec2& to, unsigned int segments, const Color4F &color)
@@ -508,6 +577,7 @@ void DrawNode::drawCubicBezier(const Vec2& from, const Vec2& control1, const Vec
         _bufferCount += 3;
     }
     _dirty = true;
+    _shape = Shape::OTHER;
 }
 
 void DrawNode::drawQuadraticBezier(const Vec2& from, const Vec2& control, const Vec2& to, unsigned int segments, const Color4F &color)
@@ -539,12 +609,24 @@ void DrawNode::drawQuadraticBezier(const Vec2& from, const Vec2& control, const
         _bufferCount += 3;
     }
     _dirty = true;
+    _shape = Shape::OTHER;
 }
 
 void DrawNode::clear()
 {
     _bufferCount = 0;
+    _uploadedCount = 0;
     _dirty = true;
+    _shape = Shape::NONE;
+}
+
+bool DrawNode::getRectShape(Rect* rect) const
+{
+    if (_shape != Shape::RECT)
+        return false;
+
+    *rect = _shapeRect;
+    return true;
 }
 
 const BlendFunc& DrawNode::getBlendFunc() const
@@ -34,6 +34,7 @@
 #include "2d/CCNode.h"
 #include "base/ccTypes.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 
 NS_CC_BEGIN
 
@@ -75,6 +76,13 @@ public:
     
     /** Clear the geometry in the node's buffer. */
     void clear();
+
+    /** Whether the node only draws one axis-aligned rectangle, with a single drawPolygon call.
+     `rect` then receives the area covered by the polygon and its border, in the node's coordinates.
+     ClippingNode uses it to clip with the scissor test instead of the stencil buffer.
+     @since v3.2
+     */
+    bool getRectShape(Rect* rect) const;
     /**
     * @js NA
     * @lua NA
@@ -89,6 +97,16 @@ public:
     */
     void setBlendFunc(const BlendFunc &blendFunc);
 
+    /** When batching is enabled, the geometry is drawn by the renderer together with the geometry of the
+     DrawNodes rendered right before and after it, when they share the same blend function and shader.
+     The vertices are then transformed on the CPU and streamed every frame, which pays off for many small nodes.
+     When it is disabled, the geometry is kept in a vertex buffer of the node, only updated when it changes,
+     and drawn with its own draw call. Default is false.
+     @since v3.2
+     */
+    void setBatchingEnabled(bool enabled) { _batchingEnabled = enabled; }
+    bool isBatchingEnabled() const { return _batchingEnabled; }
+
     void onDraw(const Mat4 &transform, uint32_t flags);
     
     // Overrides
@@ -102,6 +120,13 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     void ensureCapacity(int count);
 
+    enum class Shape
+    {
+        NONE,
+        RECT,
+        OTHER
+    };
+
     GLuint      _vao;
     GLuint      _vbo;
 
@@ -111,8 +136,17 @@ protected:
 
     BlendFunc   _blendFunc;
     CustomCommand _customCommand;
+    TrianglesCommand _trianglesCommand;
 
     bool        _dirty;
+    // vertices of _buffer already in _vbo, and the number of vertices _vbo can hold
+    GLsizei     _uploadedCount;
+    int         _vboCapacity;
+    bool        _batchingEnabled;
+
+    // what was drawn since the last clear
+    Shape       _shape;
+    Rect        _shapeRect;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(DrawNode);
@@ -75,17 +75,17 @@ static void setGLBufferData(void *buf, GLuint bufSize)
     {
         if(s_bufferObject)
         {
-            glDeleteBuffers(1, &s_bufferObject);
+            GL::deleteBuffers(1, &s_bufferObject);
         }
         glGenBuffers(1, &s_bufferObject);
         s_bufferSize = bufSize;
 
-        glBindBuffer(GL_ARRAY_BUFFER, s_bufferObject);
+        GL::bindBuffer(GL_ARRAY_BUFFER, s_bufferObject);
         glBufferData(GL_ARRAY_BUFFER, bufSize, buf, GL_DYNAMIC_DRAW);
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, s_bufferObject);
+        GL::bindBuffer(GL_ARRAY_BUFFER, s_bufferObject);
         glBufferSubData(GL_ARRAY_BUFFER, 0, bufSize, buf);
     }
 }
@@ -46,6 +46,7 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "deprecated/CCString.h"
 #include "renderer/CCGLProgramStateCache.h"
+#include "renderer/ccGLStateCache.h"
 #include <algorithm>
 
 NS_CC_BEGIN
@@ -133,12 +134,12 @@ FastTMXLayer::~FastTMXLayer()
 #if DIRECTX_ENABLED == 0
     if(glIsBuffer(_buffersVBO[0]))
     {
-        glDeleteBuffers(1, &_buffersVBO[0]);
+        GL::deleteBuffers(1, &_buffersVBO[0]);
     }
     
     if(glIsBuffer(_buffersVBO[1]))
     {
-        glDeleteBuffers(1, &_buffersVBO[1]);
+        GL::deleteBuffers(1, &_buffersVBO[1]);
     }
 #endif
 }
@@ -185,16 +186,16 @@ void FastTMXLayer::onDraw(int offset, int count)
     getGLProgramState()->apply(_modelViewTransform);
     
     GL::bindVAO(0);
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     
     GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*)0);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*)offsetof(V3F_C4B_T2F, colors));
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*)offsetof(V3F_C4B_T2F, texCoords));
     glDrawElements(GL_TRIANGLES, (GLsizei)count * 6, GL_UNSIGNED_INT, (GLvoid*)(offset * 6 * sizeof(int)));
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, count * 4);
 #endif
 }
@@ -302,9 +303,9 @@ void FastTMXLayer::updateVertexBuffer()
         glGenBuffers(1, &_buffersVBO[0]);
     }
     
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B_T2F_Quad) * _totalQuads.size(), (GLvoid*)&_totalQuads[0], GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 #endif
 }
 
@@ -315,9 +316,9 @@ void FastTMXLayer::updateIndexBuffer()
     {
         glGenBuffers(1, &_buffersVBO[1]);
     }
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(int) * _indices.size(), &_indices[0], GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 #endif
 }
 
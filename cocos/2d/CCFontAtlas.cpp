@@ -30,11 +30,13 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCThreadPool.h"
 
 NS_CC_BEGIN
 
 const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
+const int FontAtlas::DefaultMaxPageCount = 8;
 const char* FontAtlas::EVENT_PURGE_TEXTURES = "__cc_FontAtlasPurgeTextures";
 
 FontAtlas::FontAtlas(Font &theFont) 
@@ -44,6 +46,10 @@ FontAtlas::FontAtlas(Font &theFont)
 , _toForegroundListener(nullptr)
 , _toBackgroundListener(nullptr)
 , _antialiasEnabled(true)
+, _maxPageCount(DefaultMaxPageCount)
+, _evictionCount(0)
+, _asyncRasterizationEnabled(false)
+, _rasterizing(false)
 {
     _font->retain();
 
@@ -89,6 +95,17 @@ FontAtlas::FontAtlas(Font &theFont)
 
 FontAtlas::~FontAtlas()
 {
+    {
+        // the worker uses the font: wait for it to finish with the letter in progress
+        std::unique_lock<std::mutex> lock(_asyncMutex);
+        _lettersToRasterize.clear();
+        _asyncCondition.wait(lock, [this]{ return !_rasterizing; });
+    }
+    for (auto& letter : _rasterizedLetters)
+    {
+        delete [] letter.bitmap;
+    }
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     FontFreeType* fontTTf = dynamic_cast<FontFreeType*>(_font);
     if (fontTTf)
@@ -224,128 +241,326 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16String)
     if(fontTTf == nullptr)
         return false;
 
-    size_t length = utf16String.length();
-
-    float offsetAdjust = _letterPadding / 2;  
-    long bitmapWidth;
-    long bitmapHeight;
-    Rect tempRect;
-    FontLetterDefinition tempDef;
-
-    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = fontTTf->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8; 
+    if (!_pendingLetters.empty())
+    {
+        collectRasterizedLetters();
+    }
 
+    size_t length = utf16String.length();
+    auto frame = Director::getInstance()->getTotalFrames();
     bool existNewLetter = false;
-    int bottomHeight = _commonLineHeight - _fontAscender;
-
     float startY = _currentPageOrigY;
+    std::vector<char16_t> lettersToRasterize;
+    RasterizedLetter letter;
 
     for (size_t i = 0; i < length; ++i)
     {
         auto outIterator = _fontLetterDefinitions.find(utf16String[i]);
 
-        if (outIterator == _fontLetterDefinitions.end())
-        {  
+        if (outIterator != _fontLetterDefinitions.end())
+        {
+            // keeps the page of the letter from being evicted while it is laid out
+            _atlasTextures[outIterator->second.textureID]->setLastUsedFrame(frame);
+        }
+        else if (_asyncRasterizationEnabled)
+        {
+            if (_pendingLetters.insert(utf16String[i]).second)
+            {
+                lettersToRasterize.push_back(utf16String[i]);
+            }
+        }
+        else
+        {
             existNewLetter = true;
+            rasterizeLetter(fontTTf, utf16String[i], letter);
+            addRasterizedLetter(fontTTf, letter, startY);
+        }
+    }
+
+    if(existNewLetter)
+    {
+        updatePageTexture(startY, _currentPageOrigY - startY + _commonLineHeight);
+    }
+    if (!lettersToRasterize.empty())
+    {
+        rasterizeLettersAsync(lettersToRasterize);
+    }
+    return true;
+}
+
+void FontAtlas::prewarm(const std::u16string& utf16String)
+{
+    prepareLetterDefinitions(utf16String);
+}
 
-            auto bitmap = fontTTf->getGlyphBitmap(utf16String[i],bitmapWidth,bitmapHeight,tempRect,tempDef.xAdvance);
-            if (bitmap)
+void FontAtlas::prewarm(const std::string& utf8String)
+{
+    std::u16string utf16String;
+    if (StringUtils::UTF8ToUTF16(utf8String, utf16String))
+    {
+        prepareLetterDefinitions(utf16String);
+    }
+}
+
+bool FontAtlas::isLetterPending(char16_t letteCharUTF16) const
+{
+    return _pendingLetters.find(letteCharUTF16) != _pendingLetters.end();
+}
+
+bool FontAtlas::hasPendingLetters(const std::u16string& utf16String)
+{
+    if (_pendingLetters.empty())
+    {
+        return false;
+    }
+
+    collectRasterizedLetters();
+
+    for (auto letter : utf16String)
+    {
+        if (isLetterPending(letter))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FontAtlas::rasterizeLetter(FontFreeType* fontTTf, char16_t letter, RasterizedLetter& outLetter)
+{
+    outLetter.letter = letter;
+    outLetter.bitmap = fontTTf->copyGlyphBitmap(letter, outLetter.width, outLetter.height, outLetter.rect, outLetter.xAdvance);
+}
+
+void FontAtlas::addRasterizedLetter(FontFreeType* fontTTf, RasterizedLetter& letter, float& startY)
+{
+    float offsetAdjust = _letterPadding / 2;
+    int bottomHeight = _commonLineHeight - _fontAscender;
+    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+    const Rect& tempRect = letter.rect;
+    FontLetterDefinition tempDef;
+
+    tempDef.letteCharUTF16 = letter.letter;
+    tempDef.xAdvance = letter.xAdvance;
+
+    if (letter.bitmap)
+    {
+        tempDef.validDefinition = true;
+        tempDef.width            = tempRect.size.width + _letterPadding;
+        tempDef.height           = tempRect.size.height + _letterPadding;
+        tempDef.offsetX          = tempRect.origin.x + offsetAdjust;
+        tempDef.offsetY          = _fontAscender + tempRect.origin.y - offsetAdjust;
+        tempDef.clipBottom     = bottomHeight - (tempDef.height + tempRect.origin.y + offsetAdjust);
+
+        if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+        {
+            _currentPageOrigY += _commonLineHeight;
+            _currentPageOrigX = 0;
+            if(_currentPageOrigY + _commonLineHeight >= CacheTextureHeight)
             {
-                tempDef.validDefinition = true;
-                tempDef.letteCharUTF16   = utf16String[i];
-                tempDef.width            = tempRect.size.width + _letterPadding;
-                tempDef.height           = tempRect.size.height + _letterPadding;
-                tempDef.offsetX          = tempRect.origin.x + offsetAdjust;
-                tempDef.offsetY          = _fontAscender + tempRect.origin.y - offsetAdjust;
-                tempDef.clipBottom     = bottomHeight - (tempDef.height + tempRect.origin.y + offsetAdjust);
-
-                if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
-                {
-                    _currentPageOrigY += _commonLineHeight;
-                    _currentPageOrigX = 0;
-                    if(_currentPageOrigY + _commonLineHeight >= CacheTextureHeight)
-                    {
-                        unsigned char *data = nullptr;
-                        if(pixelFormat == Texture2D::PixelFormat::AI88)
-                        {
-                            data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                        }
-                        else
-                        {
-                            data = _currentPageData + CacheTextureWidth * (int)startY;
-                        }
-                        _atlasTextures[_currentPage]->updateWithData(data, 0, startY, 
-                            CacheTextureWidth, CacheTextureHeight - startY);
-
-                        startY = 0.0f;
-
-                        _currentPageOrigY = 0;
-                        memset(_currentPageData, 0, _currentPageDataSize);
-                        _currentPage++;
-                        auto tex = new Texture2D;
-                        if (_antialiasEnabled)
-                        {
-                            tex->setAntiAliasTexParameters();
-                        } 
-                        else
-                        {
-                            tex->setAliasTexParameters();
-                        }
-                        tex->initWithData(_currentPageData, _currentPageDataSize, 
-                            pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
-                        addTexture(tex,_currentPage);
-                        tex->release();
-                    }  
-                }
-                fontTTf->renderCharAt(_currentPageData,_currentPageOrigX,_currentPageOrigY,bitmap,bitmapWidth,bitmapHeight);
-
-                tempDef.U                = _currentPageOrigX;
-                tempDef.V                = _currentPageOrigY;
-                tempDef.textureID        = _currentPage;
-                _currentPageOrigX        += tempDef.width + 1;
-                // take from pixels to points
-                tempDef.width  =    tempDef.width  / scaleFactor;
-                tempDef.height =    tempDef.height / scaleFactor;      
-                tempDef.U      =    tempDef.U      / scaleFactor;
-                tempDef.V      =    tempDef.V      / scaleFactor;
-            }
-            else{
-                if(tempDef.xAdvance)
-                    tempDef.validDefinition = true;
-                else
-                    tempDef.validDefinition = false;
-
-                tempDef.letteCharUTF16   = utf16String[i];
-                tempDef.width            = 0;
-                tempDef.height           = 0;
-                tempDef.U                = 0;
-                tempDef.V                = 0;
-                tempDef.offsetX          = 0;
-                tempDef.offsetY          = 0;
-                tempDef.textureID        = 0;
-                tempDef.clipBottom = 0;
-                _currentPageOrigX += 1;
+                startNewPage(startY);
             }
+        }
+        fontTTf->renderCharAt(_currentPageData,_currentPageOrigX,_currentPageOrigY,letter.bitmap,letter.width,letter.height);
+        // renderCharAt() deletes the outlined bitmaps itself
+        if (fontTTf->isDistanceFieldEnabled() || fontTTf->getOutlineSize() <= 0)
+        {
+            delete [] letter.bitmap;
+        }
+        letter.bitmap = nullptr;
+
+        tempDef.U                = _currentPageOrigX;
+        tempDef.V                = _currentPageOrigY;
+        tempDef.textureID        = _currentPage;
+        _currentPageOrigX        += tempDef.width + 1;
+        // take from pixels to points
+        tempDef.width  =    tempDef.width  / scaleFactor;
+        tempDef.height =    tempDef.height / scaleFactor;
+        tempDef.U      =    tempDef.U      / scaleFactor;
+        tempDef.V      =    tempDef.V      / scaleFactor;
+
+        _atlasTextures[_currentPage]->setLastUsedFrame(Director::getInstance()->getTotalFrames());
+    }
+    else{
+        if(tempDef.xAdvance)
+            tempDef.validDefinition = true;
+        else
+            tempDef.validDefinition = false;
+
+        tempDef.width            = 0;
+        tempDef.height           = 0;
+        tempDef.U                = 0;
+        tempDef.V                = 0;
+        tempDef.offsetX          = 0;
+        tempDef.offsetY          = 0;
+        tempDef.textureID        = 0;
+        tempDef.clipBottom = 0;
+        _currentPageOrigX += 1;
+    }
 
-            _fontLetterDefinitions[tempDef.letteCharUTF16] = tempDef;
-        }       
+    _fontLetterDefinitions[tempDef.letteCharUTF16] = tempDef;
+}
+
+void FontAtlas::startNewPage(float& startY)
+{
+    updatePageTexture(startY, CacheTextureHeight - startY);
+
+    startY = 0.0f;
+    _currentPageOrigY = 0;
+    memset(_currentPageData, 0, _currentPageDataSize);
+
+    int page = findPageToEvict();
+    if (page >= 0)
+    {
+        // the rows are cleared as they are uploaded again
+        evictPage(page);
+        _currentPage = page;
+        return;
     }
 
-    if(existNewLetter)
+    FontFreeType* fontTTf = static_cast<FontFreeType*>(_font);
+    auto  pixelFormat = fontTTf->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+
+    _currentPage = (int)_atlasTextures.size();
+    auto tex = new Texture2D;
+    if (_antialiasEnabled)
+    {
+        tex->setAntiAliasTexParameters();
+    }
+    else
+    {
+        tex->setAliasTexParameters();
+    }
+    tex->initWithData(_currentPageData, _currentPageDataSize,
+        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
+    addTexture(tex,_currentPage);
+    tex->release();
+}
+
+int FontAtlas::findPageToEvict() const
+{
+    if (_maxPageCount <= 0 || (int)_atlasTextures.size() < _maxPageCount)
+    {
+        return -1;
+    }
+
+    auto frame = Director::getInstance()->getTotalFrames();
+    int page = -1;
+    unsigned int oldestFrame = 0;
+    for (const auto& item : _atlasTextures)
+    {
+        auto lastUsedFrame = item.second->getLastUsedFrame();
+        // the pages drawn in the previous frame or laid out in this one are still needed
+        if (item.first == _currentPage || lastUsedFrame + 1 >= frame)
+        {
+            continue;
+        }
+        if (page < 0 || lastUsedFrame < oldestFrame)
+        {
+            page = (int)item.first;
+            oldestFrame = lastUsedFrame;
+        }
+    }
+
+    if (page < 0)
     {
-        unsigned char *data = nullptr;
-        if(pixelFormat == Texture2D::PixelFormat::AI88)
+        CCLOG("cocos2d: FontAtlas: all the %d pages are in use, adding one more", (int)_atlasTextures.size());
+    }
+    return page;
+}
+
+void FontAtlas::evictPage(int page)
+{
+    for (auto iter = _fontLetterDefinitions.begin(); iter != _fontLetterDefinitions.end();)
+    {
+        if (iter->second.textureID == page && iter->second.width > 0)
         {
-            data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+            iter = _fontLetterDefinitions.erase(iter);
         }
         else
         {
-            data = _currentPageData + CacheTextureWidth * (int)startY;
+            ++iter;
         }
-        _atlasTextures[_currentPage]->updateWithData(data, 0, startY, 
-            CacheTextureWidth, _currentPageOrigY - startY + _commonLineHeight);
     }
-    return true;
+    _evictionCount++;
+}
+
+void FontAtlas::updatePageTexture(float startY, float height)
+{
+    FontFreeType* fontTTf = static_cast<FontFreeType*>(_font);
+    unsigned char *data = nullptr;
+    if(fontTTf->getOutlineSize() > 0)
+    {
+        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+    }
+    else
+    {
+        data = _currentPageData + CacheTextureWidth * (int)startY;
+    }
+    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
+        CacheTextureWidth, height);
+}
+
+void FontAtlas::rasterizeLettersAsync(const std::vector<char16_t>& letters)
+{
+    std::lock_guard<std::mutex> lock(_asyncMutex);
+    _lettersToRasterize.insert(_lettersToRasterize.end(), letters.begin(), letters.end());
+    // a single task per atlas drains the queue, so the destructor only waits for one letter
+    if (!_rasterizing)
+    {
+        _rasterizing = true;
+        ThreadPool::getInstance()->pushTask([this]{ rasterizeQueuedLetters(); });
+    }
+}
+
+void FontAtlas::rasterizeQueuedLetters()
+{
+    FontFreeType* fontTTf = static_cast<FontFreeType*>(_font);
+    RasterizedLetter letter;
+
+    std::unique_lock<std::mutex> lock(_asyncMutex);
+    while (!_lettersToRasterize.empty())
+    {
+        auto letteCharUTF16 = _lettersToRasterize.front();
+        _lettersToRasterize.pop_front();
+
+        lock.unlock();
+        rasterizeLetter(fontTTf, letteCharUTF16, letter);
+        lock.lock();
+
+        _rasterizedLetters.push_back(letter);
+    }
+    _rasterizing = false;
+    _asyncCondition.notify_all();
+}
+
+void FontAtlas::collectRasterizedLetters()
+{
+    std::vector<RasterizedLetter> letters;
+    {
+        std::lock_guard<std::mutex> lock(_asyncMutex);
+        letters.swap(_rasterizedLetters);
+    }
+    if (letters.empty())
+    {
+        return;
+    }
+
+    FontFreeType* fontTTf = static_cast<FontFreeType*>(_font);
+    float startY = _currentPageOrigY;
+    for (auto& letter : letters)
+    {
+        _pendingLetters.erase(letter.letter);
+        if (_fontLetterDefinitions.find(letter.letter) == _fontLetterDefinitions.end())
+        {
+            addRasterizedLetter(fontTTf, letter, startY);
+        }
+        else
+        {
+            delete [] letter.bitmap;
+        }
+    }
+    updatePageTexture(startY, _currentPageOrigY - startY + _commonLineHeight);
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
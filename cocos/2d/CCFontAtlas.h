@@ -28,13 +28,20 @@
 #include "base/CCPlatformMacros.h"
 #include "base/CCRef.h"
 #include "CCStdC.h"
+#include "math/CCGeometry.h"
 #include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 #include <unordered_map>
+#include <unordered_set>
 
 NS_CC_BEGIN
 
 //fwd
 class Font;
+class FontFreeType;
 class Texture2D;
 class EventCustom;
 class EventListenerCustom;
@@ -60,6 +67,7 @@ class CC_DLL FontAtlas : public Ref
 public:
     static const int CacheTextureWidth;
     static const int CacheTextureHeight;
+    static const int DefaultMaxPageCount;
     static const char* EVENT_PURGE_TEXTURES;
     /**
      * @js ctor
@@ -76,6 +84,38 @@ public:
     
     bool prepareLetterDefinitions(const std::u16string& utf16String);
 
+    /** Rasterizes the letters of the string ahead of time, so that the labels using them don't have to.
+     With async rasterization, it returns right away and the letters are defined once they are ready.
+     @since v3.2
+     */
+    void prewarm(const std::u16string& utf16String);
+    void prewarm(const std::string& utf8String);
+
+    /** Sets whether the missing letters are rasterized on the ThreadPool.
+     prepareLetterDefinitions() doesn't define them then: a later call defines the ones that are ready, and
+     until then the labels skip them. Default is false.
+     @since v3.2
+     */
+    void setAsyncRasterizationEnabled(bool enabled) { _asyncRasterizationEnabled = enabled; }
+    bool isAsyncRasterizationEnabled() const { return _asyncRasterizationEnabled; }
+
+    /** Returns whether the letter is being rasterized on the ThreadPool */
+    bool isLetterPending(char16_t letteCharUTF16) const;
+
+    /** Returns whether some letters of the string are still being rasterized. The letters that are ready are defined first */
+    bool hasPendingLetters(const std::u16string& utf16String);
+
+    /** Sets how many textures the atlas can use, 0 meaning no limit. Default is DefaultMaxPageCount.
+     Once they are all full, the letters of the least recently used texture are evicted and the texture is reused.
+     The textures used in the current or the previous frame are never reused: the atlas grows instead.
+     @since v3.2
+     */
+    void setMaxPageCount(int count) { _maxPageCount = count; }
+    int getMaxPageCount() const { return _maxPageCount; }
+
+    /** Incremented every time letters are evicted. A layout made with an older count may use letters drawn over since then */
+    unsigned int getEvictionCount() const { return _evictionCount; }
+
     inline const std::unordered_map<ssize_t, Texture2D*>& getTextures() const{ return _atlasTextures;}
     void  addTexture(Texture2D *texture, int slot);
     float getCommonLineHeight() const;
@@ -112,8 +152,29 @@ public:
      void setAliasTexParameters();
 
 private:
+    struct RasterizedLetter
+    {
+        char16_t letter;
+        unsigned char* bitmap;
+        long width;
+        long height;
+        Rect rect;
+        int xAdvance;
+    };
 
     void relaseTextures();
+    void rasterizeLetter(FontFreeType* fontTTf, char16_t letter, RasterizedLetter& outLetter);
+    void addRasterizedLetter(FontFreeType* fontTTf, RasterizedLetter& letter, float& startY);
+    void startNewPage(float& startY);
+    int findPageToEvict() const;
+    void evictPage(int page);
+    void updatePageTexture(float startY, float height);
+
+    // the worker side of async rasterization
+    void rasterizeLettersAsync(const std::vector<char16_t>& letters);
+    void rasterizeQueuedLetters();
+    void collectRasterizedLetters();
+
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
     std::unordered_map<unsigned short, FontLetterDefinition> _fontLetterDefinitions;
     float _commonLineHeight;
@@ -132,6 +193,19 @@ private:
     EventListenerCustom* _toBackgroundListener;
     EventListenerCustom* _toForegroundListener;
     bool _antialiasEnabled;
+
+    int _maxPageCount;
+    unsigned int _evictionCount;
+
+    bool _asyncRasterizationEnabled;
+    // letters queued on the ThreadPool, only used by the cocos2d thread
+    std::unordered_set<char16_t> _pendingLetters;
+    // shared with the worker, guarded by _asyncMutex
+    std::deque<char16_t> _lettersToRasterize;
+    std::vector<RasterizedLetter> _rasterizedLetters;
+    bool _rasterizing;
+    std::mutex _asyncMutex;
+    std::condition_variable _asyncCondition;
 };
 
 
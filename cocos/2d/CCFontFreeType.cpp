@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include <stdio.h>
 #include <algorithm>
+#include <mutex>
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
@@ -48,6 +49,9 @@ typedef struct _DataRef
 
 static std::unordered_map<std::string, DataRef> s_cacheFontData;
 
+// FontAtlas rasterizes letters on the ThreadPool: the faces and the library they share are used under this lock
+static std::mutex s_freeTypeMutex;
+
 FontFreeType * FontFreeType::create(const std::string &fontName, int fontSize, GlyphCollection glyphs, const char *customGlyphs,bool distanceFieldEnabled /* = false */,int outline /* = 0 */)
 {
     FontFreeType *tempFont =  new FontFreeType(distanceFieldEnabled,outline);
@@ -81,6 +85,7 @@ bool FontFreeType::initFreeType()
 
 void FontFreeType::shutdownFreeType()
 {
+    std::lock_guard<std::mutex> lock(s_freeTypeMutex);
     if (_FTInitialized == true)
     {
         FT_Done_FreeType(_FTlibrary);
@@ -103,6 +108,7 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */,int outline /
     if (_outlineSize > 0)
     {
         _outlineSize *= CC_CONTENT_SCALE_FACTOR();
+        std::lock_guard<std::mutex> lock(s_freeTypeMutex);
         FT_Stroker_New(FontFreeType::getFTLibrary(), &_stroker);
         FT_Stroker_Set(_stroker,
             (int)(_outlineSize * 64),
@@ -114,6 +120,7 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */,int outline /
 
 bool FontFreeType::createFontObject(const std::string &fontName, int fontSize)
 {
+    std::lock_guard<std::mutex> lock(s_freeTypeMutex);
     FT_Face face;
     // save font name locally
     _fontName = fontName;
@@ -156,13 +163,16 @@ bool FontFreeType::createFontObject(const std::string &fontName, int fontSize)
 
 FontFreeType::~FontFreeType()
 {
-    if (_stroker)
-    {
-        FT_Stroker_Done(_stroker);
-    }
-    if (_fontRef)
     {
-        FT_Done_Face(_fontRef);
+        std::lock_guard<std::mutex> lock(s_freeTypeMutex);
+        if (_stroker)
+        {
+            FT_Stroker_Done(_stroker);
+        }
+        if (_fontRef)
+        {
+            FT_Done_Face(_fontRef);
+        }
     }
 
     s_cacheFontData[_fontName].referenceCount -= 1;
@@ -205,6 +215,7 @@ int * FontFreeType::getHorizontalKerningForTextUTF16(const std::u16string& text,
     bool hasKerning = FT_HAS_KERNING( _fontRef ) != 0;
     if (hasKerning)
     {
+        std::lock_guard<std::mutex> lock(s_freeTypeMutex);
         for (int c = 1; c < outNumLetters; ++c)
         {
             sizes[c] = getHorizontalKerningForChars(text[c-1], text[c]);
@@ -360,6 +371,21 @@ unsigned char* FontFreeType::getGlyphBitmap(unsigned short theChar, long &outWid
     }
 }
 
+unsigned char* FontFreeType::copyGlyphBitmap(unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance)
+{
+    std::lock_guard<std::mutex> lock(s_freeTypeMutex);
+
+    auto bitmap = getGlyphBitmap(theChar, outWidth, outHeight, outRect, xAdvance);
+    if (bitmap && _outlineSize <= 0)
+    {
+        // the bitmap belongs to the glyph slot of the face, which the next glyph overwrites
+        auto copyBitmap = new unsigned char[outWidth * outHeight];
+        memcpy(copyBitmap, bitmap, outWidth * outHeight * sizeof(unsigned char));
+        bitmap = copyBitmap;
+    }
+    return bitmap;
+}
+
 unsigned char * FontFreeType::getGlyphBitmapWithOutline(unsigned short theChar, FT_BBox &bbox)
 {   
     unsigned char* ret = nullptr;
@@ -65,6 +65,11 @@ public:
     virtual int         * getHorizontalKerningForTextUTF16(const std::u16string& text, int &outNumLetters) const override;
     
     unsigned char       * getGlyphBitmap(unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
+
+    /** Same as getGlyphBitmap(), but the bitmap always belongs to the caller, who deletes it with delete[].
+     It can be called from any thread.
+     */
+    unsigned char       * copyGlyphBitmap(unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
     
     virtual int           getFontMaxHeight() const override;  
     virtual int           getFontAscender() const;
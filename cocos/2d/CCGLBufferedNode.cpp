@@ -24,6 +24,7 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "CCGLBufferedNode.h"
+#include "renderer/ccGLStateCache.h"
 
 GLBufferedNode::GLBufferedNode()
 {
@@ -45,11 +46,11 @@ GLBufferedNode::~GLBufferedNode()
     {
         if(_bufferSize[i])
         {
-            glDeleteBuffers(1, &(_bufferObject[i]));
+            cocos2d::GL::deleteBuffers(1, &(_bufferObject[i]));
         }
         if(_indexBufferSize[i])
         {
-            glDeleteBuffers(1, &(_indexBufferObject[i]));
+            cocos2d::GL::deleteBuffers(1, &(_indexBufferObject[i]));
         }
     }
 #endif
@@ -63,17 +64,17 @@ void GLBufferedNode::setGLBufferData(void *buf, GLuint bufSize, int slot)
     {
         if(_bufferObject[slot])
         {
-            glDeleteBuffers(1, &(_bufferObject[slot]));
+            cocos2d::GL::deleteBuffers(1, &(_bufferObject[slot]));
         }
         glGenBuffers(1, &(_bufferObject[slot]));
         _bufferSize[slot] = bufSize;
 
-        glBindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
+        cocos2d::GL::bindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
         glBufferData(GL_ARRAY_BUFFER, bufSize, buf, GL_DYNAMIC_DRAW);
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
+        cocos2d::GL::bindBuffer(GL_ARRAY_BUFFER, _bufferObject[slot]);
         glBufferSubData(GL_ARRAY_BUFFER, 0, bufSize, buf);
     }
 #endif
@@ -87,17 +88,17 @@ void GLBufferedNode::setGLIndexData(void *buf, GLuint bufSize, int slot)
     {
         if(_indexBufferObject[slot])
         {
-            glDeleteBuffers(1, &(_indexBufferObject[slot]));
+            cocos2d::GL::deleteBuffers(1, &(_indexBufferObject[slot]));
         }
         glGenBuffers(1, &(_indexBufferObject[slot]));
         _indexBufferSize[slot] = bufSize;
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
+        cocos2d::GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, bufSize, buf, GL_DYNAMIC_DRAW);
     }
     else
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
+        cocos2d::GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBufferObject[slot]);
         glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, bufSize, buf);
     }
 #endif
@@ -26,26 +26,30 @@ THE SOFTWARE.
 #include "CCGrabber.h"
 #include "base/ccMacros.h"
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCRenderTargetPool.h"
 
 NS_CC_BEGIN
 
 Grabber::Grabber(void)
     : _FBO(0)
+    , _ownsFBO(false)
     , _oldFBO(0)
 {
     memset(_oldClearColor, 0, sizeof(_oldClearColor));
 
-#if DIRECTX_ENABLED == 0
-    // generate FBO
-    glGenFramebuffers(1, &_FBO);
-#endif
-
 	DX_NOT_SUPPORTED();
 }
 
 void Grabber::grab(Texture2D *texture)
 {
 #if DIRECTX_ENABLED == 0
+    // generate FBO
+    if (! _ownsFBO)
+    {
+        glGenFramebuffers(1, &_FBO);
+        _ownsFBO = true;
+    }
+
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
 
     // bind
@@ -65,6 +69,20 @@ void Grabber::grab(Texture2D *texture)
 #endif
 }
 
+void Grabber::grab(RenderTarget *target)
+{
+#if DIRECTX_ENABLED == 0
+    if (_ownsFBO)
+    {
+        glDeleteFramebuffers(1, &_FBO);
+        _ownsFBO = false;
+    }
+
+    // the texture is attached already
+    _FBO = target->getFramebuffer();
+#endif
+}
+
 void Grabber::beforeRender(Texture2D *texture)
 {
 #if DIRECTX_ENABLED == 0
@@ -106,7 +124,10 @@ Grabber::~Grabber()
 {
 #if DIRECTX_ENABLED == 0
     CCLOGINFO("deallocing Grabber: %p", this);
-    glDeleteFramebuffers(1, &_FBO);
+    if (_ownsFBO)
+    {
+        glDeleteFramebuffers(1, &_FBO);
+    }
 #endif
 }
 
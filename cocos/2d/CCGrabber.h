@@ -33,6 +33,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Texture2D;
+class RenderTarget;
 
 /**
  * @addtogroup effects
@@ -54,11 +55,14 @@ public:
     ~Grabber(void);
 
     void grab(Texture2D *texture);
+    /** grabs into the framebuffer of a pooled render target, instead of creating one */
+    void grab(RenderTarget *target);
     void beforeRender(Texture2D *texture);
     void afterRender(Texture2D *texture);
 
 protected:
     GLuint _FBO;
+    bool _ownsFBO;
     GLint _oldFBO;
     GLfloat _oldClearColor[4];
 };
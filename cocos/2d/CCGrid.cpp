@@ -33,12 +33,24 @@ THE SOFTWARE.
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCRenderTargetPool.h"
 #include "CCGL.h"
 #include "math/TransformUtils.h"
 
 NS_CC_BEGIN
 // implementation of GridBase
 
+GridBase::GridBase()
+: _active(false)
+, _reuseGrid(0)
+, _texture(nullptr)
+, _grabber(nullptr)
+, _renderTarget(nullptr)
+, _isTextureFlipped(false)
+, _shaderProgram(nullptr)
+{
+}
+
 GridBase* GridBase::create(const Size& gridSize)
 {
     GridBase *pGridBase = new GridBase();
@@ -96,7 +108,14 @@ bool GridBase::initWithSize(const Size& gridSize, Texture2D *texture, bool flipp
     _grabber = new Grabber();
     if (_grabber)
     {
-        _grabber->grab(_texture);
+        if (_renderTarget && _renderTarget->getTexture() == _texture)
+        {
+            _grabber->grab(_renderTarget);
+        }
+        else
+        {
+            _grabber->grab(_texture);
+        }
     }
     else
     {
@@ -113,38 +132,17 @@ bool GridBase::initWithSize(const Size& gridSize)
 {
     Director *director = Director::getInstance();
     Size s = director->getWinSizeInPixels();
-    
-    auto POTWide = ccNextPOT((unsigned int)s.width);
-    auto POTHigh = ccNextPOT((unsigned int)s.height);
 
     // we only use rgba8888
-    Texture2D::PixelFormat format = Texture2D::PixelFormat::RGBA8888;
-
-    auto dataLen = POTWide * POTHigh * 4;
-    void *data = calloc(dataLen, 1);
-    if (! data)
-    {
-        CCLOG("cocos2d: Grid: not enough memory.");
-        this->release();
-        return false;
-    }
-
-    Texture2D *texture = new Texture2D();
-    texture->initWithData(data, dataLen,  format, POTWide, POTHigh, s);
-
-    free(data);
-
-    if (! texture)
+    // the texture and its FBO are recycled by the pool, so toggling effects doesn't allocate them again
+    _renderTarget = RenderTargetPool::getInstance()->acquire((int)s.width, (int)s.height, Texture2D::PixelFormat::RGBA8888, 0);
+    if (! _renderTarget)
     {
         CCLOG("cocos2d: Grid: error creating texture");
         return false;
     }
 
-    initWithSize(gridSize, texture, false);
-
-    texture->release();
-
-    return true;
+    return initWithSize(gridSize, _renderTarget->getTexture(), false);
 }
 
 GridBase::~GridBase(void)
@@ -154,6 +152,7 @@ GridBase::~GridBase(void)
 //TODO: ? why 2.0 comments this line        setActive(false);
     CC_SAFE_RELEASE(_texture);
     CC_SAFE_RELEASE(_grabber);
+    RenderTargetPool::getInstance()->recycle(_renderTarget);
 }
 
 // properties
@@ -184,7 +183,7 @@ void GridBase::set2DProjection()
 
     Size    size = director->getWinSizeInPixels();
 
-    glViewport(0, 0, (GLsizei)(size.width), (GLsizei)(size.height) );
+    GL::viewport(0, 0, (GLsizei)(size.width), (GLsizei)(size.height) );
     director->loadIdentityMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
 
     Mat4 orthoMatrix;
@@ -40,6 +40,7 @@ NS_CC_BEGIN
 class Texture2D;
 class Grabber;
 class GLProgram;
+class RenderTarget;
 
 /**
  * @addtogroup effects
@@ -55,6 +56,10 @@ public:
     static GridBase* create(const Size& gridSize, Texture2D *texture, bool flipped);
     /** create one Grid */
     static GridBase* create(const Size& gridSize);
+    /**
+     * @js ctor
+     */
+    GridBase();
     /**
      * @js NA
      * @lua NA
@@ -99,6 +104,8 @@ protected:
     Texture2D *_texture;
     Vec2 _step;
     Grabber *_grabber;
+    // the screen sized target of initWithSize(gridSize), given back to the RenderTargetPool
+    RenderTarget *_renderTarget;
     bool _isTextureFlipped;
     GLProgram* _shaderProgram;
     Director::Projection _directorProjection;
@@ -33,6 +33,7 @@
 #include "2d/CCFont.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCStringTextureCache.h"
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
@@ -250,6 +251,9 @@ Label::Label(FontAtlas *atlas /* = nullptr */, TextHAlignment hAlignment /* = Te
 , _vAlignment(vAlignment)
 , _horizontalKernings(nullptr)
 , _fontAtlas(atlas)
+, _fontAtlasEvictionCount(0)
+, _waitingForLetters(false)
+, _layoutReusable(false)
 , _isOpacityModifyRGB(false)
 , _useDistanceField(useDistanceField)
 , _useA8Shader(useA8Shader)
@@ -257,6 +261,8 @@ Label::Label(FontAtlas *atlas /* = nullptr */, TextHAlignment hAlignment /* = Te
 , _uniformEffectColor(0)
 , _currNumLines(-1)
 , _textSprite(nullptr)
+, _asyncRenderingEnabled(false)
+, _textureRequestID(0)
 , _contentDirty(false)
 , _shadowDirty(false)
 , _compatibleMode(false)
@@ -273,6 +279,7 @@ Label::Label(FontAtlas *atlas /* = nullptr */, TextHAlignment hAlignment /* = Te
             _batchNodes.clear();
             _batchNodes.push_back(this);
             Node::removeAllChildrenWithCleanup(true);
+            _layoutReusable = false;
         }
     });
     _eventDispatcher->addEventListenerWithSceneGraphPriority(toBackgroundListener, this);
@@ -333,6 +340,7 @@ void Label::reset()
     _shadowEnabled = false;
     _clipEnabled = false;
     _blendFuncDirty = false;
+    _layoutReusable = false;
 }
 
 void Label::updateShaderProgram()
@@ -404,6 +412,7 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
     {
         _commonLineHeight = _fontAtlas->getCommonLineHeight();
         _contentDirty = true;
+        _layoutReusable = false;
     }
     _useDistanceField = distanceFieldEnabled;
     _useA8Shader = useA8Shader;
@@ -490,6 +499,7 @@ void Label::setAlignment(TextHAlignment hAlignment,TextVAlignment vAlignment)
         _vAlignment = vAlignment;
 
         _contentDirty = true;
+        _layoutReusable = false;
     }
 }
 
@@ -499,6 +509,7 @@ void Label::setMaxLineWidth(unsigned int maxLineWidth)
     {
         _maxLineWidth = maxLineWidth;
         _contentDirty = true;
+        _layoutReusable = false;
     }
 }
 
@@ -513,6 +524,7 @@ void Label::setDimensions(unsigned int width,unsigned int height)
 
         _maxLineWidth = width;
         _contentDirty = true;
+        _layoutReusable = false;
     }  
 }
 
@@ -522,6 +534,7 @@ void Label::setLineBreakWithoutSpace(bool breakWithoutSpace)
     {
         _lineBreakWithoutSpaces = breakWithoutSpace;
         _contentDirty = true;     
+        _layoutReusable = false;
     }
 }
 
@@ -588,6 +601,8 @@ void Label::alignText()
         batchNode->getTextureAtlas()->removeAllQuads();
     }
     _fontAtlas->prepareLetterDefinitions(_currentUTF16String);
+    _fontAtlasEvictionCount = _fontAtlas->getEvictionCount();
+    _waitingForLetters = _fontAtlas->hasPendingLetters(_currentUTF16String);
     auto textures = _fontAtlas->getTextures();
     if (textures.size() > _batchNodes.size())
     {
@@ -635,6 +650,92 @@ void Label::alignText()
     updateQuads();
 
     updateColor();
+
+    _layoutString = _currentUTF16String;
+    _layoutReusable = _labelWidth <= 0 && !_clipEnabled && _layoutString.find(u'\n') == std::u16string::npos;
+}
+
+bool Label::alignTextIncrementally()
+{
+    const auto& utf16String = _currentUTF16String;
+    size_t length = utf16String.length();
+    if (length == 0 || _labelWidth > 0 || _maxLineWidth > 0 || _clipEnabled || _waitingForLetters ||
+        _horizontalKernings == nullptr || _fontAtlasEvictionCount != _fontAtlas->getEvictionCount() ||
+        utf16String.find(u'\n') != std::u16string::npos)
+    {
+        return false;
+    }
+
+    size_t startIndex = 0;
+    size_t layoutLength = _layoutString.length();
+    while (startIndex < length && startIndex < layoutLength && utf16String[startIndex] == _layoutString[startIndex])
+    {
+        ++startIndex;
+    }
+    // the pen position is only known for the letters of the last layout, and the last letter sets the width of the label
+    if (startIndex > 0 && (startIndex == length || startIndex == layoutLength))
+    {
+        --startIndex;
+    }
+    if (startIndex == 0)
+    {
+        return false;
+    }
+
+    // the sprites returned by getLetter() point to the quads
+    for (const auto& child : _children)
+    {
+        if (child->getTag() >= 0)
+        {
+            return false;
+        }
+    }
+
+    _fontAtlas->prepareLetterDefinitions(utf16String.substr(startIndex));
+    if (_fontAtlasEvictionCount != _fontAtlas->getEvictionCount() || _fontAtlas->getTextures().size() > _batchNodes.size())
+    {
+        return false;
+    }
+    _waitingForLetters = _fontAtlas->hasPendingLetters(utf16String);
+
+    // the kerning of a letter depends on the one in front of it
+    int* kernings = new int[length];
+    memcpy(kernings, _horizontalKernings, startIndex * sizeof(int));
+    int letterCount = 0;
+    auto newKernings = _fontAtlas->getFont()->getHorizontalKerningForTextUTF16(utf16String.substr(startIndex - 1), letterCount);
+    if (newKernings)
+    {
+        memcpy(kernings + startIndex, newKernings + 1, (length - startIndex) * sizeof(int));
+        delete [] newKernings;
+    }
+    else
+    {
+        memset(kernings + startIndex, 0, (length - startIndex) * sizeof(int));
+    }
+    delete [] _horizontalKernings;
+    _horizontalKernings = kernings;
+
+    // the quads are added in the order of the letters, so the ones of the letters laid out again are the last ones of each texture
+    for (int index = static_cast<int>(startIndex); index < _limitShowCount; ++index)
+    {
+        const auto& letterInfo = _lettersInfo[index];
+        if (letterInfo.def.validDefinition)
+        {
+            auto textureAtlas = _batchNodes[letterInfo.def.textureID]->getTextureAtlas();
+            auto totalQuads = textureAtlas->getTotalQuads();
+            if (letterInfo.atlasIndex < totalQuads)
+            {
+                textureAtlas->removeQuadsAtIndex(letterInfo.atlasIndex, totalQuads - letterInfo.atlasIndex);
+            }
+        }
+    }
+
+    LabelTextFormatter::createStringSprites(this, static_cast<int>(startIndex));
+    updateQuads(static_cast<int>(startIndex));
+    updateLettersColor(static_cast<int>(startIndex));
+
+    _layoutString = utf16String;
+    return true;
 }
 
 bool Label::computeHorizontalKernings(const std::u16string& stringToRender)
@@ -654,10 +755,10 @@ bool Label::computeHorizontalKernings(const std::u16string& stringToRender)
         return true;
 }
 
-void Label::updateQuads()
+void Label::updateQuads(int startIndex /* = 0 */)
 {
     int index;
-    for (int ctr = 0; ctr < _limitShowCount; ++ctr)
+    for (int ctr = startIndex; ctr < _limitShowCount; ++ctr)
     {
         auto &letterDef = _lettersInfo[ctr].def;
 
@@ -729,6 +830,7 @@ void Label::enableGlow(const Color4B& glowColor)
             config.distanceFieldEnabled = true;
             setTTFConfig(config);
             _contentDirty = true;
+            _layoutReusable = false;
         }
     _currLabelEffect = LabelEffect::GLOW;
     _effectColor = glowColor;
@@ -766,6 +868,7 @@ void Label::enableOutline(const Color4B& outlineColor,int outlineSize /* = -1 */
 
         _currLabelEffect = LabelEffect::OUTLINE;
         _contentDirty = true;
+        _layoutReusable = false;
     }
 }
 
@@ -803,6 +906,7 @@ void Label::disableEffect()
     _currLabelEffect = LabelEffect::NORMAL;
     updateShaderProgram();
     _contentDirty = true;
+    _layoutReusable = false;
     _shadowEnabled = false;
     if (_shadowNode)
     {
@@ -887,8 +991,11 @@ void Label::onDraw(const Mat4& transform, uint32_t flags)
             child->updateTransform();
     }
 
+    // the atlas pages in use can't be evicted
+    auto frame = Director::getInstance()->getTotalFrames();
     for (const auto& batchNode:_batchNodes)
     {
+        batchNode->getTexture()->setLastUsedFrame(frame);
         batchNode->getTextureAtlas()->drawQuads();
     }
 
@@ -932,13 +1039,43 @@ void Label::createSpriteWithFontDefinition()
 {
     _currentLabelType = LabelType::STRING_TEXTURE;
 
-    auto texture = new Texture2D;
-    texture->initWithString(_originalUTF8String.c_str(),_fontDefinition);
+    auto textureCache = StringTextureCache::getInstance();
+    if (_asyncRenderingEnabled)
+    {
+        auto requestID = ++_textureRequestID;
+        // the label waits for its texture
+        retain();
+        textureCache->getTextureAsync(_originalUTF8String, _fontDefinition, [this, requestID](Texture2D* texture){
+            // the texture is dropped if a newer one was requested since then, or if the label uses a font atlas now
+            if (requestID == _textureRequestID && _currentLabelType == LabelType::STRING_TEXTURE && !_fontAtlas)
+            {
+                createTextSprite(texture);
+            }
+            release();
+        });
+    }
+    else
+    {
+        createTextSprite(textureCache->getTexture(_originalUTF8String, _fontDefinition));
+    }
+}
 
-    _textSprite = Sprite::createWithTexture(texture);
+void Label::createTextSprite(Texture2D* texture)
+{
+    removeTextSprite();
+
+    if (texture)
+    {
+        _textSprite = Sprite::createWithTexture(texture);
+    }
+    else
+    {
+        texture = new Texture2D;
+        _textSprite = Sprite::createWithTexture(texture);
+        texture->release();
+    }
     _textSprite->setAnchorPoint(Vec2::ANCHOR_BOTTOM_LEFT);
     this->setContentSize(_textSprite->getContentSize());
-    texture->release();
     if (_blendFuncDirty)
     {
         _textSprite->setBlendFunc(_blendFunc);
@@ -950,6 +1087,20 @@ void Label::createSpriteWithFontDefinition()
     _textSprite->updateDisplayedOpacity(_displayedOpacity);
 }
 
+void Label::removeTextSprite()
+{
+    if (_textSprite)
+    {
+        Node::removeChild(_textSprite,true);
+        _textSprite = nullptr;
+        if (_shadowNode)
+        {
+            Node::removeChild(_shadowNode,true);
+            _shadowNode = nullptr;
+        }
+    }
+}
+
 void Label::setFontDefinition(const FontDefinition& textDefinition)
 {
     _fontDefinition = textDefinition;
@@ -977,20 +1128,20 @@ void Label::updateContent()
     }
 
     computeStringNumLines();
+    if (_fontAtlas && _layoutReusable && alignTextIncrementally())
+    {
+        _contentDirty = false;
+        return;
+    }
     if (_fontAtlas)
     {
         computeHorizontalKernings(_currentUTF16String);
     }
 
-    if (_textSprite)
+    // an asynchronous text keeps the previous one until it is ready
+    if (_fontAtlas || !_asyncRenderingEnabled)
     {
-        Node::removeChild(_textSprite,true);
-        _textSprite = nullptr;
-        if (_shadowNode)
-        {
-            Node::removeChild(_shadowNode,true);
-            _shadowNode = nullptr;
-        }
+        removeTextSprite();
     }
 
     if (_fontAtlas)
@@ -1055,6 +1206,7 @@ void Label::updateFont()
     }
 
     _contentDirty = true;
+    _layoutReusable = false;
     _systemFontDirty = false;
 }
 
@@ -1098,6 +1250,13 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
     {
         updateFont();
     }
+    if (_fontAtlas && !_contentDirty && (_fontAtlasEvictionCount != _fontAtlas->getEvictionCount() ||
+        (_waitingForLetters && !_fontAtlas->hasPendingLetters(_currentUTF16String))))
+    {
+        // some letters were evicted from the atlas, or the missing ones are ready
+        _contentDirty = true;
+        _layoutReusable = false;
+    }
     if (_contentDirty)
     {
         updateContent();
@@ -1134,8 +1293,9 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
     {
         drawTextSprite(renderer, flags);
     }
-    else
+    else if (_currentLabelType != LabelType::STRING_TEXTURE)
     {
+        // without a sprite, a system font text is still being rendered
         draw(renderer, _modelViewTransform, flags);
     }
 
@@ -1216,6 +1376,7 @@ void Label::setLineHeight(float height)
     {
         _commonLineHeight = height;
         _contentDirty = true;
+        _layoutReusable = false;
     }
 }
 
@@ -1232,6 +1393,7 @@ void Label::setAdditionalKerning(float space)
     {
         _additionalKerning = space;
         _contentDirty = true;
+        _layoutReusable = false;
     }
 }
 
@@ -1330,6 +1492,20 @@ void Label::setTextColor(const Color4B &color)
     _textColorF.a = _textColor.a / 255.0f;
 }
 
+static Color4B getLettersColor(const Color3B& displayedColor, GLubyte displayedOpacity)
+{
+    Color4B color4( displayedColor.r, displayedColor.g, displayedColor.b, displayedOpacity );
+
+    // special opacity for premultiplied textures
+    //if (_isOpacityModifyRGB)
+    {
+        color4.r *= displayedOpacity/255.0f;
+        color4.g *= displayedOpacity/255.0f;
+        color4.b *= displayedOpacity/255.0f;
+    }
+    return color4;
+}
+
 void Label::updateColor()
 {
     if (nullptr == _textureAtlas)
@@ -1337,15 +1513,7 @@ void Label::updateColor()
         return;
     }
 
-    Color4B color4( _displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity );
-
-    // special opacity for premultiplied textures
-    //if (_isOpacityModifyRGB)
-    {
-        color4.r *= _displayedOpacity/255.0f;
-        color4.g *= _displayedOpacity/255.0f;
-        color4.b *= _displayedOpacity/255.0f;
-    }
+    Color4B color4 = getLettersColor(_displayedColor, _displayedOpacity);
 
     cocos2d::TextureAtlas* textureAtlas;
     V3F_C4B_T2F_Quad *quads;
@@ -1366,6 +1534,26 @@ void Label::updateColor()
     }
 }
 
+void Label::updateLettersColor(int startIndex)
+{
+    Color4B color4 = getLettersColor(_displayedColor, _displayedOpacity);
+
+    for (int index = startIndex; index < _limitShowCount; ++index)
+    {
+        const auto& letterInfo = _lettersInfo[index];
+        if (letterInfo.def.validDefinition)
+        {
+            auto textureAtlas = _batchNodes[letterInfo.def.textureID]->getTextureAtlas();
+            auto& quad = textureAtlas->getQuads()[letterInfo.atlasIndex];
+            quad.bl.colors = color4;
+            quad.br.colors = color4;
+            quad.tl.colors = color4;
+            quad.tr.colors = color4;
+            textureAtlas->updateQuad(&quad, letterInfo.atlasIndex);
+        }
+    }
+}
+
 std::string Label::getDescription() const
 {
     std::string utf8str;
@@ -214,6 +214,14 @@ public:
     void setClipMarginEnabled(bool clipEnabled) { _clipEnabled = clipEnabled; }
     bool isClipMarginEnabled() const { return _clipEnabled; }
 
+    /** Sets whether the system font text is rendered on the ThreadPool.
+     The previous text stays displayed until the new one is ready. Default is false.
+     @warning Only for system font
+     @since v3.2
+     */
+    void setAsyncRenderingEnabled(bool enabled) { _asyncRenderingEnabled = enabled; }
+    bool isAsyncRenderingEnabled() const { return _asyncRenderingEnabled; }
+
     /** Sets the line height of the label
       @warning Not support system font
       @since v3.2.0
@@ -285,6 +293,10 @@ protected:
         Vec2 position;
         Size  contentSize;
         int   atlasIndex;
+
+        // the pen state in front of the letter, in pixels
+        int   penPositionX;
+        int   longestLine;
     };
     enum class LabelType {
 
@@ -313,12 +325,19 @@ protected:
     void setFontScale(float fontScale);
     
     virtual void alignText();
+
+    /** Lays out again the letters from the first one that differs from the last layout, keeping the ones in front of it.
+     Returns false when the letters in front may have moved, e.g. with several lines, and then nothing was done.
+     */
+    bool alignTextIncrementally();
     
     bool computeHorizontalKernings(const std::u16string& stringToRender);
 
     void computeStringNumLines();
 
-    void updateQuads();
+    void updateQuads(int startIndex = 0);
+
+    void updateLettersColor(int startIndex);
 
     virtual void updateColor() override;
 
@@ -329,6 +348,8 @@ protected:
     void drawTextSprite(Renderer *renderer, uint32_t parentFlags);
 
     void createSpriteWithFontDefinition();
+    void createTextSprite(Texture2D* texture);
+    void removeTextSprite();
 
     void updateFont();
     void reset();
@@ -345,12 +366,21 @@ protected:
 
     std::vector<SpriteBatchNode*> _batchNodes;
     FontAtlas *                   _fontAtlas;
+    // the atlas state the letters were laid out with
+    unsigned int                  _fontAtlasEvictionCount;
+    bool                          _waitingForLetters;
+    // the string of the last layout, while only a new string can make it change
+    std::u16string                _layoutString;
+    bool                          _layoutReusable;
     std::vector<LetterInfo>       _lettersInfo;
 
     TTFConfig _fontConfig;
 
     //compatibility with older LabelTTF
     Sprite* _textSprite;
+    bool _asyncRenderingEnabled;
+    // identifies the latest texture requested to the StringTextureCache
+    unsigned int _textureRequestID;
     FontDefinition _fontDefinition;
     bool  _compatibleMode;
 
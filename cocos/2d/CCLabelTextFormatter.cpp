@@ -263,11 +263,11 @@ bool LabelTextFormatter::alignText(Label *theLabel)
     return true;
 }
 
-bool LabelTextFormatter::createStringSprites(Label *theLabel)
+bool LabelTextFormatter::createStringSprites(Label *theLabel, int startIndex /* = 0 */)
 {
     // check for string
     unsigned int stringLen = theLabel->getStringLength();
-    theLabel->_limitShowCount = 0;
+    theLabel->_limitShowCount = startIndex;
 
     // no string
     if (stringLen == 0)
@@ -323,8 +323,15 @@ bool LabelTextFormatter::createStringSprites(Label *theLabel)
     {
         clip = true;
     }
+
+    if (startIndex > 0)
+    {
+        CCASSERT(theLabel->_currNumLines == 1 && !clip, "Only a single line layout can be resumed");
+        nextFontPositionX = theLabel->_lettersInfo[startIndex].penPositionX;
+        longestLine = theLabel->_lettersInfo[startIndex].longestLine;
+    }
     
-    for (unsigned int i = 0; i < stringLen; i++)
+    for (unsigned int i = startIndex; i < stringLen; i++)
     {
         char16_t c    = strWhole[i];
         if (fontAtlas->getLetterDefinitionForChar(c, tempDefinition))
@@ -378,9 +385,16 @@ bool LabelTextFormatter::createStringSprites(Label *theLabel)
         letterPosition.x = (nextFontPositionX + charXOffset + kernings[i]) / contentScaleFactor;
         letterPosition.y = (nextFontPositionY - charYOffset) / contentScaleFactor;
                
-        if( theLabel->recordLetterInfo(letterPosition,tempDefinition,i) == false)
+        bool validLetter = theLabel->recordLetterInfo(letterPosition,tempDefinition,i);
+        // the pen state in front of the letter, to resume the layout from it
+        theLabel->_lettersInfo[i].penPositionX = nextFontPositionX;
+        theLabel->_lettersInfo[i].longestLine = longestLine;
+        if(validLetter == false)
         {
-            log("WARNING: can't find letter definition in font file for letter: %c", c);
+            if (!fontAtlas->isLetterPending(c))
+            {
+                log("WARNING: can't find letter definition in font file for letter: %c", c);
+            }
             continue;
         }
 
@@ -38,7 +38,10 @@ public:
     
     static bool multilineText(Label *theLabel);
     static bool alignText(Label *theLabel);
-    static bool createStringSprites(Label *theLabel);
+    /** Lays out the letters from startIndex on. A start index above 0 resumes a single line layout
+     from the pen position recorded for that letter, keeping the letters in front of it.
+     */
+    static bool createStringSprites(Label *theLabel, int startIndex = 0);
 
 };
 
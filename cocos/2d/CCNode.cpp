@@ -47,6 +47,7 @@ THE SOFTWARE.
 #include "2d/CCComponentContainer.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 
 #include "deprecated/CCString.h"
@@ -110,6 +111,7 @@ Node::Node(void)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
 , _isTransitionFinished(false)
+, _parallelVisitEnabled(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
 #endif
@@ -1267,7 +1269,24 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
 
     int i = 0;
 
-    if(!_children.empty())
+    if(!_children.empty() && _parallelVisitEnabled && renderer->canVisitInParallel(_children.size()))
+    {
+        sortAllChildren();
+        // find the children with zOrder < 0
+        for( ; i < _children.size(); i++ )
+        {
+            auto node = _children.at(i);
+
+            if ( !node || node->_localZOrder >= 0 )
+                break;
+        }
+        renderer->visitInParallel(_children, 0, i, _modelViewTransform, flags);
+        // self draw
+        this->draw(renderer, _modelViewTransform, flags);
+
+        renderer->visitInParallel(_children, i, _children.size(), _modelViewTransform, flags);
+    }
+    else if(!_children.empty())
     {
         sortAllChildren();
         // draw children zOrder < 0
@@ -1071,6 +1071,17 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Sets whether the children of this node are visited on the `ThreadPool`.
+     * Only enable it on large subtrees whose `visit` and `draw` don't issue GL calls, autorelease objects
+     * or modify the scene graph, e.g. a layer with thousands of sprites.
+     * The children are only split when there are at least `Renderer::getParallelVisitThreshold()` of them.
+     *
+     * @param enabled   true to visit the children in parallel. Default is false
+     */
+    void setParallelVisitEnabled(bool enabled) { _parallelVisitEnabled = enabled; }
+    bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1593,6 +1604,7 @@ protected:
 
     bool _reorderChildDirty;          ///< children order dirty flag
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
+    bool _parallelVisitEnabled;       ///< whether the children are visited on the ThreadPool
 
 #if CC_ENABLE_SCRIPT_BINDING
     int _scriptHandler;               ///< script handler for onEnter() & onExit(), used in Javascript binding and Lua binding.
@@ -36,10 +36,13 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCTextureCache.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCRenderTargetPool.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCCustomCommand.h"
 
@@ -50,7 +53,8 @@ NS_CC_BEGIN
 
 // implementation RenderTexture
 RenderTexture::RenderTexture()
-: _FBO(0)
+: _renderTarget(nullptr)
+, _FBO(0)
 , _depthRenderBufffer(0)
 , _oldFBO(0)
 , _texture(0)
@@ -87,16 +91,17 @@ RenderTexture::RenderTexture()
 
 RenderTexture::~RenderTexture()
 {
+    // the sprite is released first, so the target can be pooled unless its texture is used elsewhere
+    if (_sprite && _sprite->getParent() == this)
+    {
+        removeChild(_sprite, true);
+    }
     CC_SAFE_RELEASE(_sprite);
     CC_SAFE_RELEASE(_textureCopy);
     
-#if DIRECTX_ENABLED == 0
-    glDeleteFramebuffers(1, &_FBO);
-    if (_depthRenderBufffer)
-    {
-        glDeleteRenderbuffers(1, &_depthRenderBufffer);
-    }
-#else
+    RenderTargetPool::getInstance()->recycle(_renderTarget);
+
+#if DIRECTX_ENABLED == 1
 	DXResourceManager::getInstance().remove(&_depthStencilView);
 	DXResourceManager::getInstance().remove(&_shaderResourceViewMap);
 	DXResourceManager::getInstance().remove(&_renderTargetViewMap);
@@ -128,8 +133,8 @@ void RenderTexture::listenToBackground(EventCustom *event)
         CCLOG("Cache rendertexture failed!");
     }
     
-    glDeleteFramebuffers(1, &_FBO);
     _FBO = 0;
+    _depthRenderBufffer = 0;
 #endif
 }
 
@@ -137,10 +142,9 @@ void RenderTexture::listenToForeground(EventCustom *event)
 {
 #if CC_ENABLE_CACHE_TEXTURE_DATA && DIRECTX_ENABLED == 0
     // -- regenerate frame buffer object and attach the texture
-    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
-    
-    glGenFramebuffers(1, &_FBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+    _renderTarget->restoreFramebuffer();
+    _FBO = _renderTarget->getFramebuffer();
+    _depthRenderBufffer = _renderTarget->getDepthStencilBuffer();
     
     _texture->setAliasTexParameters();
     
@@ -148,9 +152,6 @@ void RenderTexture::listenToForeground(EventCustom *event)
     {
         _textureCopy->setAliasTexParameters();
     }
-    
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
-    glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
 #endif
 }
 
@@ -213,51 +214,26 @@ bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat
         h = (int)(h * CC_CONTENT_SCALE_FACTOR());
         _fullviewPort = Rect(0,0,w,h);
         
-#if DIRECTX_ENABLED == 0
-        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
-#endif
-
-        // textures must be power of two squared
-        int powW = 0;
-        int powH = 0;
-
-        if (Configuration::getInstance()->supportsNPOT())
-        {
-            powW = w;
-            powH = h;
-        }
-        else
-        {
-            powW = ccNextPOT(w);
-            powH = ccNextPOT(h);
-        }
-
-        auto dataLen = powW * powH * 4;
-        data = malloc(dataLen);
-        CC_BREAK_IF(! data);
-
-        memset(data, 0, dataLen);
         _pixelFormat = format;
 
-        _texture = new Texture2D();
-        if (_texture)
-        {
-#if DIRECTX_ENABLED == 1
-			_texture->prepareForRenderTarget();
-#endif
-            _texture->initWithData(data, dataLen, (Texture2D::PixelFormat)_pixelFormat, powW, powH, Size((float)w, (float)h));
-        }
-        else
-        {
-            break;
-        }
+        // the texture, the FBO and the depth buffer are recycled by the pool
+        _renderTarget = RenderTargetPool::getInstance()->acquire(w, h, _pixelFormat, depthStencilFormat);
+        CC_BREAK_IF(! _renderTarget);
+
+        _texture = _renderTarget->getTexture();
 
 #if DIRECTX_ENABLED == 0
-        GLint oldRBO;
-        glGetIntegerv(GL_RENDERBUFFER_BINDING, &oldRBO);
-        
+        _FBO = _renderTarget->getFramebuffer();
+        _depthRenderBufffer = _renderTarget->getDepthStencilBuffer();
+
         if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
         {
+            int powW = _texture->getPixelsWide();
+            int powH = _texture->getPixelsHigh();
+            auto dataLen = powW * powH * 4;
+            data = calloc(dataLen, 1);
+            CC_BREAK_IF(! data);
+
             _textureCopy = new Texture2D();
             if (_textureCopy)
             {
@@ -268,31 +244,6 @@ bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat
                 break;
             }
         }
-
-        // generate FBO
-        glGenFramebuffers(1, &_FBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
-
-        // associate texture with FBO
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
-
-        if (depthStencilFormat != 0)
-        {
-            //create and attach depth buffer
-            glGenRenderbuffers(1, &_depthRenderBufffer);
-            glBindRenderbuffer(GL_RENDERBUFFER, _depthRenderBufffer);
-            glRenderbufferStorage(GL_RENDERBUFFER, depthStencilFormat, (GLsizei)powW, (GLsizei)powH);
-            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthRenderBufffer);
-
-            // if depth format is the one with stencil part, bind same render buffer as stencil attachment
-            if (depthStencilFormat == GL_DEPTH24_STENCIL8)
-            {
-                glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _depthRenderBufffer);
-            }
-        }
-
-        // check if it worked (probably worth doing :) )
-        CCASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Could not attach texture to framebuffer");
 #else		
 		DXResourceManager::getInstance().remove(&_depthStencilView);
 		DXResourceManager::getInstance().remove(&_shaderResourceViewMap);
@@ -312,6 +263,10 @@ bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat
 		// Create the render target view.
 		view->GetDevice()->CreateRenderTargetView(_texture->getTexture(), &renderTargetViewDesc, &_renderTargetViewMap);
 
+		// a recycled texture keeps what was rendered into it
+		const float transparent[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		view->GetContext()->ClearRenderTargetView(_renderTargetViewMap, transparent);
+
 		/////////////////////// Map's Shader Resource View
 		// Setup the description of the shader resource view.
 		CD3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc;
@@ -349,16 +304,10 @@ bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat
         // retained
         setSprite(Sprite::createWithTexture(_texture));
 
-        _texture->release();
         _sprite->setFlippedY(true);
 
         _sprite->setBlendFunc( BlendFunc::ALPHA_PREMULTIPLIED );
 
-#if DIRECTX_ENABLED == 0
-        glBindRenderbuffer(GL_RENDERBUFFER, oldRBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
-#endif
-        
         // Diabled by default.
         _autoDraw = false;
         
@@ -532,6 +481,227 @@ void RenderTexture::onSaveToFile(const std::string& filename, bool isRGBA)
     CC_SAFE_DELETE(image);
 }
 
+void RenderTexture::newImageAsync(const std::function<void(Image*)>& callback, bool flipImage)
+{
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+    CCASSERT(callback, "callback should not be null");
+
+    auto readback = new AsyncReadback();
+    readback->flipImage = flipImage;
+    readback->imageCallback = callback;
+    addAsyncReadback(readback);
+}
+
+void RenderTexture::saveToFileAsync(const std::string& fileName, Image::Format format, bool isRGBA,
+                                    const std::function<void(bool, const std::string&)>& callback)
+{
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+    CCASSERT(format == Image::Format::JPG || format == Image::Format::PNG,
+             "the image can only be saved as JPG or PNG format");
+    if (isRGBA && format == Image::Format::JPG) CCLOG("RGBA is not supported for JPG format");
+
+    auto readback = new AsyncReadback();
+    readback->flipImage = true;
+    readback->savePath = FileUtils::getInstance()->getWritablePath() + fileName;
+    readback->saveRGBA = isRGBA;
+    readback->saveCallback = callback;
+    addAsyncReadback(readback);
+}
+
+void RenderTexture::addAsyncReadback(AsyncReadback* readback)
+{
+    readback->pixelBuffer = 0;
+#if CC_RENDER_TEXTURE_PBO
+    readback->fence = nullptr;
+#endif
+    readback->pixels = nullptr;
+    readback->framesWaited = 0;
+    readback->width = 0;
+    readback->height = 0;
+    readback->issued = false;
+
+    if (_asyncReadbacks.empty())
+    {
+        // the texture must stay alive until the pixels are read back
+        retain();
+        Director::getInstance()->getScheduler()->schedule(CC_CALLBACK_1(RenderTexture::updateAsyncReadbacks, this),
+                                                         this, 0, false, "asyncReadback");
+    }
+    _asyncReadbacks.push_back(readback);
+
+    readback->command.init(_globalZOrder);
+    readback->command.func = CC_CALLBACK_0(RenderTexture::onReadPixelsAsync, this, readback);
+    Director::getInstance()->getRenderer()->addCommand(&readback->command);
+}
+
+void RenderTexture::onReadPixelsAsync(AsyncReadback* readback)
+{
+    readback->issued = true;
+    if (nullptr == _texture)
+    {
+        return;
+    }
+
+    const Size& s = _texture->getContentSizeInPixels();
+    readback->width = (int)s.width;
+    readback->height = (int)s.height;
+    ssize_t size = readback->width * readback->height * 4;
+
+#if DIRECTX_ENABLED == 0
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+#if CC_RENDER_TEXTURE_PBO
+    if (Configuration::getInstance()->supportsPixelBufferObject())
+    {
+        // glReadPixels returns as soon as the copy is queued, the buffer is mapped in a later frame
+        glGenBuffers(1, &readback->pixelBuffer);
+        GL::bindBuffer(GL_PIXEL_PACK_BUFFER, readback->pixelBuffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        glReadPixels(0, 0, readback->width, readback->height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        GL::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (Configuration::getInstance()->supportsFenceSync())
+        {
+            readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+    else
+#endif
+    {
+        readback->pixels = static_cast<unsigned char*>(malloc(size));
+        if (readback->pixels)
+        {
+            glReadPixels(0, 0, readback->width, readback->height, GL_RGBA, GL_UNSIGNED_BYTE, readback->pixels);
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+    CHECK_GL_ERROR_DEBUG();
+#else
+    // the staging texture is read top to bottom already
+    Image* image = newImage(false);
+    if (image && image->getData())
+    {
+        readback->pixels = static_cast<unsigned char*>(malloc(size));
+        if (readback->pixels)
+        {
+            memcpy(readback->pixels, image->getData(), size);
+        }
+    }
+    CC_SAFE_RELEASE(image);
+    readback->flipImage = false;
+#endif
+}
+
+void RenderTexture::updateAsyncReadbacks(float dt)
+{
+    for (auto iter = _asyncReadbacks.begin(); iter != _asyncReadbacks.end(); )
+    {
+        AsyncReadback* readback = *iter;
+        if (!readback->issued)
+        {
+            break;
+        }
+
+#if CC_RENDER_TEXTURE_PBO
+        if (readback->pixelBuffer)
+        {
+            bool ready;
+            if (readback->fence)
+            {
+                GLenum status = glClientWaitSync(readback->fence, 0, 0);
+                ready = (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED);
+            }
+            else
+            {
+                // without fences, two frames is enough for the driver to finish the copy in most cases,
+                // and mapping the buffer waits for it otherwise
+                ready = ++readback->framesWaited >= 2;
+            }
+            if (!ready)
+            {
+                break;
+            }
+
+            ssize_t size = readback->width * readback->height * 4;
+            GL::bindBuffer(GL_PIXEL_PACK_BUFFER, readback->pixelBuffer);
+            void* mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+            if (mapped)
+            {
+                readback->pixels = static_cast<unsigned char*>(malloc(size));
+                if (readback->pixels)
+                {
+                    memcpy(readback->pixels, mapped, size);
+                }
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            GL::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            GL::deleteBuffers(1, &readback->pixelBuffer);
+            readback->pixelBuffer = 0;
+            if (readback->fence)
+            {
+                glDeleteSync(readback->fence);
+                readback->fence = nullptr;
+            }
+        }
+#endif
+
+        iter = _asyncReadbacks.erase(iter);
+
+        // flip and encode on a worker thread: the texture is not needed anymore
+        ThreadPool::getInstance()->pushTask([readback](){
+            Image* image = nullptr;
+            bool succeeded = false;
+            if (readback->pixels)
+            {
+                int width = readback->width;
+                int height = readback->height;
+                ssize_t rowSize = width * 4;
+                if (readback->flipImage)
+                {
+                    std::vector<unsigned char> row(rowSize);
+                    for (int top = 0, bottom = height - 1; top < bottom; ++top, --bottom)
+                    {
+                        memcpy(row.data(), readback->pixels + top * rowSize, rowSize);
+                        memcpy(readback->pixels + top * rowSize, readback->pixels + bottom * rowSize, rowSize);
+                        memcpy(readback->pixels + bottom * rowSize, row.data(), rowSize);
+                    }
+                }
+
+                image = new Image();
+                succeeded = image->initWithRawData(readback->pixels, rowSize * height, width, height, 8);
+                free(readback->pixels);
+                readback->pixels = nullptr;
+
+                if (succeeded && !readback->savePath.empty())
+                {
+                    succeeded = image->saveToFile(readback->savePath, !readback->saveRGBA);
+                }
+            }
+
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread([readback, image, succeeded](){
+                if (readback->imageCallback)
+                {
+                    readback->imageCallback(succeeded ? image : nullptr);
+                }
+                if (readback->saveCallback)
+                {
+                    readback->saveCallback(succeeded, readback->savePath);
+                }
+                CC_SAFE_RELEASE(image);
+                delete readback;
+            });
+        });
+    }
+
+    if (_asyncReadbacks.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule("asyncReadback", this);
+        // balances the retain of addAsyncReadback, without deleting the texture inside its own timer
+        autorelease();
+    }
+}
+
 /* get buffer as Image */
 Image* RenderTexture::newImage(bool fliimage)
 {
@@ -700,7 +870,7 @@ void RenderTexture::onBegin()
         //glViewport(_fullviewPort.origin.x, _fullviewPort.origin.y, (GLsizei)_fullviewPort.size.width, (GLsizei)_fullviewPort.size.height);
 
 #if DIRECTX_ENABLED == 0
-        glViewport(viewport.origin.x, viewport.origin.y, (GLsizei)viewport.size.width, (GLsizei)viewport.size.height);
+        GL::viewport(viewport.origin.x, viewport.origin.y, (GLsizei)viewport.size.width, (GLsizei)viewport.size.height);
 #else
 		DXStateCache::getInstance().setViewport(viewport.origin.x, viewport.origin.y, viewport.size.width, viewport.size.height);
 #endif
@@ -905,6 +1075,9 @@ void RenderTexture::begin()
     _beginCommand.func = CC_CALLBACK_0(RenderTexture::onBegin, this);
 
     Director::getInstance()->getRenderer()->addCommand(&_beginCommand);
+
+    // the clip rects of the screen don't apply to the texture
+    renderer->pushNoClipRect(&_beginScissorCommand, _globalZOrder);
 }
 
 void RenderTexture::end()
@@ -917,6 +1090,7 @@ void RenderTexture::end()
     
     Renderer *renderer = director->getRenderer();
     renderer->addCommand(&_endCommand);
+    renderer->popClipRect(&_endScissorCommand, _globalZOrder);
     renderer->popGroup();
     
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
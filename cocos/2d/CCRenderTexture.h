@@ -26,15 +26,27 @@ THE SOFTWARE.
 #ifndef __CCRENDER_TEXTURE_H__
 #define __CCRENDER_TEXTURE_H__
 
+#include <functional>
+#include <list>
+
 #include "2d/CCNode.h"
 #include "2d/CCSprite.h"
 #include "platform/CCImage.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCScissorCommand.h"
 
 NS_CC_BEGIN
 
 class EventCustom;
+class RenderTarget;
+
+// Desktop GL can read the pixels into a pixel buffer object and map it once the GPU is done
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) && (DIRECTX_ENABLED == 0)
+#define CC_RENDER_TEXTURE_PBO 1
+#else
+#define CC_RENDER_TEXTURE_PBO 0
+#endif
 
 /**
  * @addtogroup textures
@@ -109,6 +121,21 @@ public:
         Returns true if the operation is successful.
      */
     bool saveToFile(const std::string& filename, Image::Format format, bool isRGBA = true);
+
+    /** Reads the texture without stalling the GPU, and creates the Image on a worker thread.
+     The callback is called on the cocos2d thread one or two frames later, with nullptr if the read failed.
+     The image is released after the callback returns: retain it to keep it.
+     When pixel buffer objects are not supported, the pixels are read synchronously, but the image is still created on the worker thread.
+     @since v3.2
+     */
+    void newImageAsync(const std::function<void(Image* image)>& callback, bool flipImage = true);
+
+    /** Same as saveToFile, but the texture is read without stalling the GPU and the image is encoded on a worker thread.
+     The callback is called on the cocos2d thread once the file is written, with the full path of the file.
+     @since v3.2
+     */
+    void saveToFileAsync(const std::string& filename, Image::Format format, bool isRGBA,
+                         const std::function<void(bool succeeded, const std::string& fullpath)>& callback);
     
     /** Listen "come to background" message, and save render texture.
      It only has effect on Android.
@@ -185,6 +212,8 @@ protected:
     Rect         _fullRect;
     Rect         _fullviewPort;
     
+    // _FBO, _depthRenderBufffer and _texture belong to the target, which goes back to the RenderTargetPool
+    RenderTarget* _renderTarget;
     GLuint       _FBO;
     GLuint       _depthRenderBufffer;
     GLint        _oldFBO;
@@ -213,8 +242,31 @@ protected:
     CustomCommand _clearCommand;
     CustomCommand _beginCommand;
     CustomCommand _endCommand;
+    ScissorCommand _beginScissorCommand;
+    ScissorCommand _endScissorCommand;
     CustomCommand _saveToFileCommand;
 
+    // a pending newImageAsync or saveToFileAsync
+    struct AsyncReadback
+    {
+        CustomCommand command;
+        GLuint pixelBuffer;
+#if CC_RENDER_TEXTURE_PBO
+        GLsync fence;
+#endif
+        unsigned char* pixels;
+        int framesWaited;
+        int width;
+        int height;
+        bool flipImage;
+        bool issued;
+        std::string savePath;
+        bool saveRGBA;
+        std::function<void(Image*)> imageCallback;
+        std::function<void(bool, const std::string&)> saveCallback;
+    };
+    std::list<AsyncReadback*> _asyncReadbacks;
+
 #if DIRECTX_ENABLED == 1
 	ID3D11RenderTargetView* _renderTargetViewMap;
 	ID3D11ShaderResourceView* _shaderResourceViewMap;
@@ -231,6 +283,10 @@ protected:
     void onClearDepth();
 
     void onSaveToFile(const std::string& fileName, bool isRGBA = true);
+
+    void addAsyncReadback(AsyncReadback* readback);
+    void onReadPixelsAsync(AsyncReadback* readback);
+    void updateAsyncReadbacks(float dt);
     
     Mat4 _oldTransMatrix, _oldProjMatrix;
     Mat4 _transformMatrix, _projectionMatrix;
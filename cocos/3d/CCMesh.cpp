@@ -213,13 +213,13 @@ void Mesh::cleanAndFreeBuffers()
 #if DIRECTX_ENABLED == 0
     if(glIsBuffer(_vertexBuffer))
     {
-        glDeleteBuffers(1, &_vertexBuffer);
+        GL::deleteBuffers(1, &_vertexBuffer);
         _vertexBuffer = 0;
     }
     
     if(glIsBuffer(_indexBuffer))
     {
-        glDeleteBuffers(1, &_indexBuffer);
+        GL::deleteBuffers(1, &_indexBuffer);
         _indexBuffer = 0;
     }
     _primitiveType = PrimitiveType::TRIANGLES;
@@ -234,24 +234,24 @@ void Mesh::buildBuffer()
     cleanAndFreeBuffers();
 
     glGenBuffers(1, &_vertexBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
     
     glBufferData(GL_ARRAY_BUFFER,
                  _renderdata._vertexs.size() * sizeof(_renderdata._vertexs[0]),
                  &_renderdata._vertexs[0],
                  GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     
     glGenBuffers(1, &_indexBuffer);
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
     
     unsigned int indexSize = 2;
     IndexFormat indexformat = IndexFormat::INDEX16;
     
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * _renderdata._indices.size(), &_renderdata._indices[0], GL_STATIC_DRAW);
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     
     _primitiveType = PrimitiveType::TRIANGLES;
     _indexFormat = indexformat;
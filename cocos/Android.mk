@@ -87,6 +87,7 @@ platform/CCFileUtils.cpp \
 platform/CCSAXParser.cpp \
 platform/CCThread.cpp \
 platform/CCImage.cpp \
+platform/CCMappedData.cpp \
 math/CCAffineTransform.cpp \
 math/CCGeometry.cpp \
 math/CCVertex.cpp \
@@ -125,6 +126,7 @@ base/CCNS.cpp \
 base/CCProfiling.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
+base/CCThreadPool.cpp \
 base/CCScriptSupport.cpp \
 base/CCTouch.cpp \
 base/CCUserDefault.cpp \
@@ -146,19 +148,26 @@ base/CCController-android.cpp \
 base/ObjectFactory.cpp \
 renderer/CCBatchCommand.cpp \
 renderer/CCCustomCommand.cpp \
+renderer/CCScissorCommand.cpp \
 renderer/CCGLProgram.cpp \
 renderer/CCGLProgramCache.cpp \
+renderer/CCGLProgramBinaryCache.cpp \
 renderer/CCGLProgramState.cpp \
 renderer/CCGLProgramStateCache.cpp \
 renderer/CCGroupCommand.cpp \
 renderer/CCQuadCommand.cpp \
+renderer/CCTrianglesCommand.cpp \
 renderer/CCMeshCommand.cpp \
 renderer/CCRenderCommand.cpp \
 renderer/CCRenderer.cpp \
+renderer/CCRenderTargetPool.cpp \
+renderer/CCStringTextureCache.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
 renderer/CCTextureCache.cpp \
+renderer/CCDynamicAtlas.cpp \
 renderer/ccGLStateCache.cpp \
+renderer/ccPixelConversion.cpp \
 renderer/ccShaders.cpp \
 deprecated/CCArray.cpp \
 deprecated/CCSet.cpp \
@@ -47,6 +47,11 @@ Configuration::Configuration()
 , _supportsBGRA8888(false)
 , _supportsDiscardFramebuffer(false)
 , _supportsShareableVAO(false)
+, _supportsElementIndexUint(false)
+, _supportsMapBufferRange(false)
+, _supportsFenceSync(false)
+, _supportsProgramBinary(false)
+, _supportsPixelBufferObject(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -143,6 +148,30 @@ void Configuration::gatherGPUInfo()
     _supportsShareableVAO = checkForGLExtension("vertex_array_object");
 	_valueDict["gl.supports_vertex_array_object"] = Value(_supportsShareableVAO);
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+    // desktop OpenGL always supports them
+    _supportsElementIndexUint = true;
+#else
+    _supportsElementIndexUint = checkForGLExtension("GL_OES_element_index_uint");
+#endif
+    _valueDict["gl.supports_element_index_uint"] = Value(_supportsElementIndexUint);
+
+    _supportsMapBufferRange = checkForGLExtension("map_buffer_range");
+    _valueDict["gl.supports_map_buffer_range"] = Value(_supportsMapBufferRange);
+
+    _supportsFenceSync = checkForGLExtension("GL_ARB_sync") || checkForGLExtension("GL_APPLE_sync");
+    _valueDict["gl.supports_fence_sync"] = Value(_supportsFenceSync);
+
+    _supportsProgramBinary = checkForGLExtension("get_program_binary");
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+    // the entry points are loaded by the GLView
+    _supportsProgramBinary = _supportsProgramBinary && glProgramBinaryOESEXT && glGetProgramBinaryOESEXT;
+#endif
+    _valueDict["gl.supports_program_binary"] = Value(_supportsProgramBinary);
+
+    _supportsPixelBufferObject = checkForGLExtension("pixel_buffer_object");
+    _valueDict["gl.supports_pixel_buffer_object"] = Value(_supportsPixelBufferObject);
+
     CHECK_GL_ERROR_DEBUG();
 #else
 #define SET_FEATURE(name, variable, value) { \
@@ -158,6 +187,11 @@ void Configuration::gatherGPUInfo()
 	SET_FEATURE("gl.supports_NPOT", _supportsNPOT, true);
 	SET_FEATURE("gl.supports_discard_framebuffer", _supportsDiscardFramebuffer, true);
 	SET_FEATURE("gl.supports_vertex_array_object", _supportsShareableVAO, false);
+	SET_FEATURE("gl.supports_element_index_uint", _supportsElementIndexUint, false);
+	SET_FEATURE("gl.supports_map_buffer_range", _supportsMapBufferRange, false);
+	SET_FEATURE("gl.supports_fence_sync", _supportsFenceSync, false);
+	SET_FEATURE("gl.supports_program_binary", _supportsProgramBinary, false);
+	SET_FEATURE("gl.supports_pixel_buffer_object", _supportsPixelBufferObject, false);
 
 	GLView* view = GLView::sharedOpenGLView();
 	const auto featureLevel = view->GetDevice()->GetFeatureLevel();
@@ -311,6 +345,31 @@ bool Configuration::supportsShareableVAO() const
 #endif
 }
 
+bool Configuration::supportsElementIndexUint() const
+{
+    return _supportsElementIndexUint;
+}
+
+bool Configuration::supportsMapBufferRange() const
+{
+    return _supportsMapBufferRange;
+}
+
+bool Configuration::supportsFenceSync() const
+{
+    return _supportsFenceSync;
+}
+
+bool Configuration::supportsProgramBinary() const
+{
+    return _supportsProgramBinary;
+}
+
+bool Configuration::supportsPixelBufferObject() const
+{
+    return _supportsPixelBufferObject;
+}
+
 //
 // generic getters for properties
 //
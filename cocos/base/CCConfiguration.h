@@ -110,6 +110,21 @@ public:
      */
 	bool supportsShareableVAO() const;
 
+    /** Whether or not 32 bit element indices (GL_UNSIGNED_INT) are supported */
+    bool supportsElementIndexUint() const;
+
+    /** Whether or not glMapBufferRange is supported */
+    bool supportsMapBufferRange() const;
+
+    /** Whether or not sync objects (glFenceSync) are supported */
+    bool supportsFenceSync() const;
+
+    /** Whether or not linked programs can be saved and loaded (glGetProgramBinary / glProgramBinary) */
+    bool supportsProgramBinary() const;
+
+    /** Whether or not glReadPixels can write into a pixel buffer object (GL_PIXEL_PACK_BUFFER) */
+    bool supportsPixelBufferObject() const;
+
     /** returns whether or not an OpenGL is supported */
     bool checkForGLExtension(const std::string &searchName) const;
 
@@ -146,6 +161,11 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsElementIndexUint;
+    bool            _supportsMapBufferRange;
+    bool            _supportsFenceSync;
+    bool            _supportsProgramBinary;
+    bool            _supportsPixelBufferObject;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
@@ -43,8 +43,11 @@ THE SOFTWARE.
 #include "2d/CCTransition.h"
 #include "2d/CCFontFreeType.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramBinaryCache.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCRenderTargetPool.h"
+#include "renderer/CCStringTextureCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "base/CCUserDefault.h"
@@ -58,6 +61,7 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCProfiling.h"
 #include "base/CCConfiguration.h"
+#include "base/CCThreadPool.h"
 #include "base/CCNS.h"
 #include "math/CCMath.h"
 #include "CCApplication.h"
@@ -319,6 +323,10 @@ void Director::drawScene()
         _openGLView->swapBuffers();
     }
 
+#if DIRECTX_ENABLED == 0
+    GL::endFrameCallsCount();
+#endif
+
     if (_displayStats)
     {
         calculateMPF();
@@ -462,11 +470,21 @@ void Director::resetMatrixStack()
     initMatrixStack();
 }
 
+std::stack<Mat4>& Director::modelViewMatrixStack()
+{
+    // every Renderer::visitInParallel worker has its own model view stack
+    if (_renderer && _renderer->isVisitingInParallel())
+    {
+        return _renderer->getParallelVisitMatrixStack();
+    }
+    return _modelViewMatrixStack;
+}
+
 void Director::popMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.pop();
+        modelViewMatrixStack().pop();
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -486,7 +504,7 @@ void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.top() = Mat4::IDENTITY;
+        modelViewMatrixStack().top() = Mat4::IDENTITY;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -506,7 +524,7 @@ void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.top() = mat;
+        modelViewMatrixStack().top() = mat;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -526,7 +544,7 @@ void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.top() *= mat;
+        modelViewMatrixStack().top() *= mat;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -546,7 +564,7 @@ void Director::pushMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.push(_modelViewMatrixStack.top());
+        modelViewMatrixStack().push(modelViewMatrixStack().top());
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -567,7 +585,7 @@ Mat4 Director::getMatrix(MATRIX_STACK_TYPE type)
     Mat4 result;
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        result = _modelViewMatrixStack.top();
+        result = modelViewMatrixStack().top();
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -580,7 +598,7 @@ Mat4 Director::getMatrix(MATRIX_STACK_TYPE type)
     else
     {
         CCASSERT(false, "unknow matrix stack type, will return modelview matrix instead");
-        result =  _modelViewMatrixStack.top();
+        result =  modelViewMatrixStack().top();
     }
 //    float diffResult(0);
 //    for (int index = 0; index <16; ++index)
@@ -684,6 +702,8 @@ void Director::purgeCachedData(void)
     {
         SpriteFrameCache::getInstance()->removeUnusedSpriteFrames();
         _textureCache->removeUnusedTextures();
+        RenderTargetPool::getInstance()->purge();
+        StringTextureCache::getInstance()->purge();
 
         // Note: some tests such as ActionsTest are leaking refcounted textures
         // There should be no test textures left in the cache
@@ -725,13 +745,13 @@ void Director::setDepthTest(bool on)
     if (on)
     {
         glClearDepth(1.0f);
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LEQUAL);
+        GL::enableDepthTest(true);
+        GL::depthFunc(GL_LEQUAL);
 //        glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::enableDepthTest(false);
     }
     CHECK_GL_ERROR_DEBUG();
 #endif
@@ -1019,6 +1039,9 @@ void Director::purgeDirector()
     // purge bitmap cache
     FontFNT::purgeCachedData();
 
+    // the workers may still be rasterizing letters: run the queued tasks and stop the workers before FreeType goes
+    ThreadPool::destroyInstance();
+
     FontFreeType::shutdownFreeType();
 
     // purge all managed caches
@@ -1026,7 +1049,10 @@ void Director::purgeDirector()
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
     GLProgramCache::destroyInstance();
+    GLProgramBinaryCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
+    RenderTargetPool::destroyInstance();
+    StringTextureCache::destroyInstance();
     FileUtils::destroyInstance();
     Configuration::destroyInstance();
 
@@ -99,6 +99,7 @@ private:
     std::stack<Mat4> _textureMatrixStack;
 protected:
     void initMatrixStack();
+    std::stack<Mat4>& modelViewMatrixStack();
 public:
     void pushMatrix(MATRIX_STACK_TYPE type);
     void popMatrix(MATRIX_STACK_TYPE type);
@@ -0,0 +1,189 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+// workers and the cocos2d thread may ask for the pool at the same time. A function-local static
+// can't be destroyed and created again by destroyInstance(), hence the double-checked lock
+static std::atomic<ThreadPool*> s_sharedThreadPool(nullptr);
+static std::mutex s_sharedThreadPoolMutex;
+
+ThreadPool* ThreadPool::getInstance()
+{
+    ThreadPool* pool = s_sharedThreadPool.load(std::memory_order_acquire);
+    if (!pool)
+    {
+        std::lock_guard<std::mutex> lock(s_sharedThreadPoolMutex);
+        pool = s_sharedThreadPool.load(std::memory_order_relaxed);
+        if (!pool)
+        {
+            int cores = (int)std::thread::hardware_concurrency();
+            pool = new ThreadPool(std::max(1, cores - 1));
+            s_sharedThreadPool.store(pool, std::memory_order_release);
+        }
+    }
+
+    return pool;
+}
+
+void ThreadPool::destroyInstance()
+{
+    // the tasks still find the pool while it runs the queue and joins the workers
+    std::lock_guard<std::mutex> lock(s_sharedThreadPoolMutex);
+    delete s_sharedThreadPool.load(std::memory_order_relaxed);
+    s_sharedThreadPool.store(nullptr, std::memory_order_release);
+}
+
+ThreadPool::ThreadPool(int threadCount)
+: _needQuit(false)
+{
+    CCASSERT(threadCount > 0, "ThreadPool needs at least one worker");
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _threads.push_back(std::thread(&ThreadPool::threadLoop, this));
+        _threadIds.push_back(_threads.back().get_id());
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    _tasksMutex.lock();
+    _needQuit = true;
+    _tasksMutex.unlock();
+    _tasksCondition.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::pushTask(const std::function<void()>& task)
+{
+    _tasksMutex.lock();
+    _tasks.push_back(task);
+    _tasksMutex.unlock();
+
+    _tasksCondition.notify_one();
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int begin, int end)>& func, int grain)
+{
+    if (count <= 0)
+        return;
+
+    // a few ranges per thread, so threads that start late still get a share
+    int chunks = std::min((count + std::max(grain, 1) - 1) / std::max(grain, 1), (getThreadCount() + 1) * 4);
+    if (chunks <= 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    // shared with the tasks, which can start after the call returned if every range was already taken
+    struct Job
+    {
+        std::function<void(int, int)> func;
+        int count;
+        int chunks;
+        std::atomic<int> nextChunk;
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        int done;
+    };
+
+    auto job = std::make_shared<Job>();
+    job->func = func;
+    job->count = count;
+    job->chunks = chunks;
+    job->nextChunk = 0;
+    job->done = 0;
+
+    auto run = [job]() {
+        int chunk;
+        while ((chunk = job->nextChunk++) < job->chunks)
+        {
+            int begin = (int)((long long)job->count * chunk / job->chunks);
+            int end = (int)((long long)job->count * (chunk + 1) / job->chunks);
+            job->func(begin, end);
+
+            std::lock_guard<std::mutex> lock(job->doneMutex);
+            if (++job->done == job->chunks)
+                job->doneCondition.notify_all();
+        }
+    };
+
+    int helpers = std::min(getThreadCount(), chunks - 1);
+    for (int i = 0; i < helpers; ++i)
+        pushTask(run);
+
+    run();
+
+    // only waits for ranges other threads are already running
+    std::unique_lock<std::mutex> lock(job->doneMutex);
+    job->doneCondition.wait(lock, [&job]{ return job->done == job->chunks; });
+}
+
+int ThreadPool::getWorkerIndex() const
+{
+    auto threadId = std::this_thread::get_id();
+    for (size_t i = 0; i < _threadIds.size(); ++i)
+    {
+        if (_threadIds[i] == threadId)
+            return (int)i;
+    }
+    return -1;
+}
+
+void ThreadPool::threadLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lk(_tasksMutex);
+            _tasksCondition.wait(lk, [this]{ return _needQuit || !_tasks.empty(); });
+
+            // the queued tasks are run before quitting, so accepted work is never lost
+            if (_tasks.empty())
+                break;
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCTHREADPOOL_H__
+#define __CCTHREADPOOL_H__
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+/** @brief A fixed size pool of worker threads shared by the engine.
+
+ Tasks are plain functions executed in FIFO order on any of the workers.
+ Tasks must not touch GL or the autorelease pool, since they don't run on the cocos2d thread.
+ */
+class CC_DLL ThreadPool
+{
+public:
+    /** Returns the shared pool. It is sized to the number of cores minus the cocos2d thread */
+    static ThreadPool* getInstance();
+
+    /** Runs the tasks still queued, then stops the workers of the shared pool and destroys it */
+    static void destroyInstance();
+
+    /** Creates a pool with `threadCount` workers */
+    explicit ThreadPool(int threadCount);
+    /** Waits for the queued tasks to be run, including the ones they queue, and stops the workers */
+    ~ThreadPool();
+
+    /** Queues a task to be executed by one of the workers */
+    void pushTask(const std::function<void()>& task);
+
+    /** Calls `func(begin, end)` on ranges covering [0, count) from the workers and the calling thread, and returns once all are done.
+     * Ranges are at least `grain` long. The calling thread takes ranges too, so it is safe to call from a worker.
+     */
+    void parallelFor(int count, const std::function<void(int begin, int end)>& func, int grain = 1);
+
+    /** Returns the number of workers */
+    inline int getThreadCount() const { return (int)_threads.size(); }
+
+    /** Returns the index of the calling thread inside the pool, or -1 if it is not one of its workers */
+    int getWorkerIndex() const;
+
+protected:
+    void threadLoop();
+
+    std::vector<std::thread> _threads;
+    std::vector<std::thread::id> _threadIds;
+
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _tasksMutex;
+    std::condition_variable _tasksCondition;
+
+    bool _needQuit;
+};
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#endif //__CCTHREADPOOL_H__
@@ -24,19 +24,25 @@
 
 #include "atitc.h"
 
-//Decode ATITC encode block to 4x4 RGB32 pixels
+#include <vector>
+
+#include "renderer/ccPixelConversion.h"
+
+using cocos2d::PixelConversion::PaletteBlock;
+using cocos2d::PixelConversion::BlockAlpha;
+
+//Read the palettes and indices of an ATITC encode block
 static void atitc_decode_block(uint8_t **blockData,
-                              uint32_t *decodeBlockData,
-                              unsigned int stride,
-                              bool oneBitAlphaFlag,
-                              uint64_t alpha,
-                              ATITCDecodeFlag decodeFlag)
+                               PaletteBlock *block,
+                               bool oneBitAlphaFlag,
+                               uint64_t alpha,
+                               ATITCDecodeFlag decodeFlag)
 {
     unsigned int colorValue0 = 0 , colorValue1 = 0, initAlpha = (!oneBitAlphaFlag * 255u) << 24;
     unsigned int rb0 = 0, rb1 = 0, rb2 = 0, rb3 = 0, g0 = 0, g1 = 0, g2 = 0, g3 = 0;
     bool msb = 0;
     
-    uint32_t colors[4], pixelsIndex = 0;
+    uint32_t *colors = block->colors, pixelsIndex = 0;
     
     /* load the two color values*/
     memcpy((void *)&colorValue0, *blockData, 2);
@@ -85,6 +91,8 @@ static void atitc_decode_block(uint8_t **blockData,
     /*read the pixelsIndex , 2bits per pixel, 4 bytes */
     memcpy((void*)&pixelsIndex, *blockData, 4);
     (*blockData) += 4;
+    block->colorIndices = pixelsIndex;
+    block->alpha = alpha;
     
     if (ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA == decodeFlag)
     {
@@ -92,7 +100,7 @@ static void atitc_decode_block(uint8_t **blockData,
         // 8-Alpha block: derive the other six alphas.
         // Bit code 000 = alpha0, 001 = alpha1, other are interpolated.
         
-        unsigned int alphaArray[8];
+        uint32_t *alphaArray = block->alphaPalette;
         
         alphaArray[0] = (alpha ) & 0xff ;
         alphaArray[1] = (alpha >> 8) & 0xff ;
@@ -115,37 +123,6 @@ static void atitc_decode_block(uint8_t **blockData,
             alphaArray[6] = 0;
             alphaArray[7] = 255;
         }
-        
-        // read the flowing 48bit indices (16*3)
-        alpha >>= 16;
-        
-        for (int y = 0; y < 4; ++y)
-        {
-            for (int x = 0; x < 4; ++x)
-            {
-                decodeBlockData[x] = (alphaArray[alpha & 5] << 24) + colors[pixelsIndex & 3];
-                pixelsIndex >>= 2;
-                alpha >>= 3;
-            }
-            decodeBlockData += stride;
-        }
-    } //if (atc_interpolated_alpha == comFlag)
-    else
-    {
-        /* atc_rgb atc_explicit_alpha use explicit alpha */
-        
-        for (int y = 0; y < 4; ++y)
-        {
-            for (int x = 0; x < 4; ++x)
-           {
-                initAlpha   = (static_cast<int>(alpha) & 0x0f) << 28;
-                initAlpha   += initAlpha >> 4;
-                decodeBlockData[x] = initAlpha + colors[pixelsIndex & 3];
-                pixelsIndex >>= 2;
-                alpha       >>= 4;
-            }
-            decodeBlockData += stride;
-        }
     }
 }
 
@@ -157,10 +134,14 @@ void atitc_decode(uint8_t *encodeData,             //in_data
                  ATITCDecodeFlag decodeFlag)
 {
     uint32_t *decodeBlockData = (uint32_t *)decodeData;
+    std::vector<PaletteBlock> blocks(pixelsWidth / 4);
+    BlockAlpha alphaMode = ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA == decodeFlag ? BlockAlpha::INTERPOLATED :
+                           ATITCDecodeFlag::ATC_EXPLICIT_ALPHA == decodeFlag ? BlockAlpha::EXPLICIT :
+                           BlockAlpha::NONE;
     
-    for (int block_y = 0; block_y < pixelsHeight / 4; ++block_y, decodeBlockData += 3 * pixelsWidth)   //stride = 3*width
+    for (int block_y = 0; block_y < pixelsHeight / 4; ++block_y, decodeBlockData += 4 * pixelsWidth)   //stride = 4*width
     {
-        for (int block_x = 0; block_x < pixelsWidth / 4; ++block_x, decodeBlockData += 4)            //skip 4 pixels
+        for (int block_x = 0; block_x < pixelsWidth / 4; ++block_x)
         {
             uint64_t blockAlpha = 0;
             
@@ -168,27 +149,29 @@ void atitc_decode(uint8_t *encodeData,             //in_data
             {
                 case ATITCDecodeFlag::ATC_RGB:
                 {
-                    atitc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 0, 0LL, ATITCDecodeFlag::ATC_RGB);
+                    atitc_decode_block(&encodeData, &blocks[block_x], 0, 0LL, ATITCDecodeFlag::ATC_RGB);
                 }
                     break;
                 case ATITCDecodeFlag::ATC_EXPLICIT_ALPHA:
                 {
                     memcpy((void *)&blockAlpha, encodeData, 8);
                     encodeData += 8;
-                    atitc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
+                    atitc_decode_block(&encodeData, &blocks[block_x], 1, blockAlpha, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
                 }
                     break;
                 case ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA:
                 {
                     memcpy((void *)&blockAlpha, encodeData, 8);
                     encodeData += 8;
-                    atitc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
+                    atitc_decode_block(&encodeData, &blocks[block_x], 1, blockAlpha, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
                 }
                     break;
                 default:
                     break;
             }//switch
         }//for block_x
+        
+        cocos2d::PixelConversion::decodePaletteBlocks(blocks.data(), (int)blocks.size(), alphaMode, decodeBlockData, pixelsWidth);
     }//for block_y
 }
 
@@ -166,6 +166,13 @@ inline int convertDiff(int base, int diff) {
 static
 void decode_subblock(etc1_byte* pOut, int r, int g, int b, const int* table,
         etc1_uint32 low, bool second, bool flipped) {
+    // the 4 colors the pixels pick from, so each channel is clamped once per color instead of once per pixel
+    etc1_byte palette[4][3];
+    for (int i = 0; i < 4; i++) {
+        palette[i][0] = clamp(r + table[i]);
+        palette[i][1] = clamp(g + table[i]);
+        palette[i][2] = clamp(b + table[i]);
+    }
     int baseX = 0;
     int baseY = 0;
     if (second) {
@@ -186,11 +193,11 @@ void decode_subblock(etc1_byte* pOut, int r, int g, int b, const int* table,
         }
         int k = y + (x * 4);
         int offset = ((low >> k) & 1) | ((low >> (k + 15)) & 2);
-        int delta = table[offset];
+        const etc1_byte* color = palette[offset];
         etc1_byte* q = pOut + 3 * (x + 4 * y);
-        *q++ = clamp(r + delta);
-        *q++ = clamp(g + delta);
-        *q++ = clamp(b + delta);
+        *q++ = color[0];
+        *q++ = color[1];
+        *q++ = color[2];
     }
 }
 
@@ -24,18 +24,24 @@
 
 #include "s3tc.h"
 
-//Decode S3TC encode block to 4x4 RGB32 pixels
+#include <vector>
+
+#include "renderer/ccPixelConversion.h"
+
+using cocos2d::PixelConversion::PaletteBlock;
+using cocos2d::PixelConversion::BlockAlpha;
+
+//Read the palettes and indices of a S3TC encode block
 static void s3tc_decode_block(uint8_t **blockData,
-                       uint32_t *decodeBlockData,
-                       unsigned int stride,
-                       bool oneBitAlphaFlag,
-                       uint64_t alpha,
-                       S3TCDecodeFlag decodeFlag)
+                              PaletteBlock *block,
+                              bool oneBitAlphaFlag,
+                              uint64_t alpha,
+                              S3TCDecodeFlag decodeFlag)
 {
     unsigned int colorValue0 = 0 , colorValue1 = 0, initAlpha = (!oneBitAlphaFlag * 255u) << 24;
     unsigned int rb0 = 0, rb1 = 0, rb2 = 0, rb3 = 0, g0 = 0, g1 = 0, g2 = 0, g3 = 0;
     
-    uint32_t colors[4], pixelsIndex = 0;
+    uint32_t *colors = block->colors, pixelsIndex = 0;
     
     /* load the two color values*/
     memcpy((void *)&colorValue0, *blockData, 2);
@@ -75,6 +81,8 @@ static void s3tc_decode_block(uint8_t **blockData,
     /*read the pixelsIndex , 2bits per pixel, 4 bytes */
     memcpy((void*)&pixelsIndex, *blockData, 4);
     (*blockData) += 4;
+    block->colorIndices = pixelsIndex;
+    block->alpha = alpha;
     
     if (S3TCDecodeFlag::DXT5 == decodeFlag)
     {
@@ -82,7 +90,7 @@ static void s3tc_decode_block(uint8_t **blockData,
         // 8-Alpha block: derive the other six alphas.
         // Bit code 000 = alpha0, 001 = alpha1, other are interpolated.
         
-        unsigned int alphaArray[8];
+        uint32_t *alphaArray = block->alphaPalette;
         
         alphaArray[0] = (alpha ) & 0xff ;
         alphaArray[1] = (alpha >> 8) & 0xff ;
@@ -105,35 +113,6 @@ static void s3tc_decode_block(uint8_t **blockData,
             alphaArray[6] = 0;
             alphaArray[7] = 255;
         }
-        
-        // read the flowing 48bit indices (16*3)
-        alpha >>= 16;
-        
-        for (int y = 0; y < 4; ++y)
-        {
-            for (int x = 0; x < 4; ++x)
-            {
-                decodeBlockData[x] = (alphaArray[alpha & 5] << 24) + colors[pixelsIndex & 3];
-                pixelsIndex >>= 2;
-                alpha >>= 3;
-            }
-            decodeBlockData += stride;
-        }
-    } //if (dxt5 == comFlag)
-    else
-    { //dxt1 dxt3 use explicit alpha
-        for (int y = 0; y < 4; ++y)
-        {
-            for (int x = 0; x < 4; ++x)
-            {
-                initAlpha   = (static_cast<int>(alpha) & 0x0f) << 28;
-                initAlpha   += initAlpha >> 4;
-                decodeBlockData[x] = initAlpha + colors[pixelsIndex & 3];
-                pixelsIndex >>= 2;
-                alpha       >>= 4;
-            }
-            decodeBlockData += stride;
-        }
     }
 }
 
@@ -145,9 +124,13 @@ void s3tc_decode(uint8_t *encodeData,             //in_data
                  S3TCDecodeFlag decodeFlag)
 {
     uint32_t *decodeBlockData = (uint32_t *)decodeData;
-    for (int block_y = 0; block_y < pixelsHeight / 4; ++block_y, decodeBlockData += 3 * pixelsWidth)   //stride = 3*width
+    std::vector<PaletteBlock> blocks(pixelsWidth / 4);
+    BlockAlpha alphaMode = S3TCDecodeFlag::DXT5 == decodeFlag ? BlockAlpha::INTERPOLATED :
+                           S3TCDecodeFlag::DXT3 == decodeFlag ? BlockAlpha::EXPLICIT :
+                           BlockAlpha::NONE;
+    for (int block_y = 0; block_y < pixelsHeight / 4; ++block_y, decodeBlockData += 4 * pixelsWidth)   //stride = 4*width
     {
-        for(int block_x = 0; block_x < pixelsWidth / 4; ++block_x, decodeBlockData += 4)            //skip 4 pixels
+        for(int block_x = 0; block_x < pixelsWidth / 4; ++block_x)
         {
             uint64_t blockAlpha = 0;
             
@@ -155,27 +138,29 @@ void s3tc_decode(uint8_t *encodeData,             //in_data
             {
                 case S3TCDecodeFlag::DXT1:
                 {
-                    s3tc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 0, 0LL, S3TCDecodeFlag::DXT1);
+                    s3tc_decode_block(&encodeData, &blocks[block_x], 0, 0LL, S3TCDecodeFlag::DXT1);
                 }
                     break;
                 case S3TCDecodeFlag::DXT3:
                 {
                     memcpy((void *)&blockAlpha, encodeData, 8);
                     encodeData += 8;
-                    s3tc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, S3TCDecodeFlag::DXT3);
+                    s3tc_decode_block(&encodeData, &blocks[block_x], 1, blockAlpha, S3TCDecodeFlag::DXT3);
                 }
                     break;
                 case S3TCDecodeFlag::DXT5:
                 {
                     memcpy((void *)&blockAlpha, encodeData, 8);
                     encodeData += 8;
-                    s3tc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, S3TCDecodeFlag::DXT5);
+                    s3tc_decode_block(&encodeData, &blocks[block_x], 1, blockAlpha, S3TCDecodeFlag::DXT5);
                 }
                     break;
                 default:
                     break;
             }//switch
         }//for block_x
+        
+        cocos2d::PixelConversion::decodePaletteBlocks(blocks.data(), (int)blocks.size(), alphaMode, decodeBlockData, pixelsWidth);
     }//for block_y
 }
 
@@ -52,6 +52,7 @@ THE SOFTWARE.
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
 #include "base/CCProfiling.h"
@@ -141,18 +142,25 @@ THE SOFTWARE.
 
 // renderer
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCScissorCommand.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramBinaryCache.h"
+#include "renderer/CCRenderTargetPool.h"
+#include "renderer/CCStringTextureCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/ccPixelConversion.h"
 #include "renderer/ccShaders.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCDynamicAtlas.h"
 
 // physics
 #include "physics/CCPhysicsBody.h"
@@ -166,6 +174,7 @@ THE SOFTWARE.
 #include "platform/CCCommon.h"
 #include "platform/CCFileUtils.h"
 #include "platform/CCImage.h"
+#include "platform/CCMappedData.h"
 #include "platform/CCSAXParser.h"
 #include "platform/CCThread.h"
 #include "base/CCPlatformConfig.h"
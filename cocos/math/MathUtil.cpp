@@ -21,6 +21,16 @@ This file was modified to fit the cocos2d-x project
 #include "MathUtil.h"
 #include "base/ccMacros.h"
 
+#if defined(__AVX__)
+#define MATH_USE_AVX 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 NS_CC_MATH_BEGIN
 
 void MathUtil::smooth(float* x, float target, float elapsedTime, float responseTime)
@@ -44,4 +54,70 @@ void MathUtil::smooth(float* x, float target, float elapsedTime, float riseTime,
     }
 }
 
+#if MATH_USE_SSE2
+static inline void storeVec3(float* dst, __m128 v)
+{
+    // only write x, y and z: the bytes after them belong to the next attribute
+    _mm_storel_pi((__m64*)dst, v);
+    _mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+}
+#endif
+
+void MathUtil::transformVertices(const float* m, float* vertices, size_t count, size_t stride)
+{
+    GP_ASSERT(m);
+
+    unsigned char* p = (unsigned char*)vertices;
+
+#if MATH_USE_AVX
+    __m256 col0 = _mm256_broadcast_ps((const __m128*)&m[0]);
+    __m256 col1 = _mm256_broadcast_ps((const __m128*)&m[4]);
+    __m256 col2 = _mm256_broadcast_ps((const __m128*)&m[8]);
+    __m256 col3 = _mm256_broadcast_ps((const __m128*)&m[12]);
+
+    // two points per iteration, one in each 128 bit lane
+    for (; count >= 2; count -= 2, p += 2 * stride)
+    {
+        float* v0 = (float*)p;
+        float* v1 = (float*)(p + stride);
+
+        __m256 x = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(v0[0])), _mm_set1_ps(v1[0]), 1);
+        __m256 y = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(v0[1])), _mm_set1_ps(v1[1]), 1);
+        __m256 z = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(v0[2])), _mm_set1_ps(v1[2]), 1);
+
+        __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(col0, x), _mm256_mul_ps(col1, y)),
+                                 _mm256_add_ps(_mm256_mul_ps(col2, z), col3));
+
+        storeVec3(v0, _mm256_castps256_ps128(r));
+        storeVec3(v1, _mm256_extractf128_ps(r, 1));
+    }
+#endif
+
+#if MATH_USE_SSE2
+    __m128 c0 = _mm_loadu_ps(&m[0]);
+    __m128 c1 = _mm_loadu_ps(&m[4]);
+    __m128 c2 = _mm_loadu_ps(&m[8]);
+    __m128 c3 = _mm_loadu_ps(&m[12]);
+
+    for (; count > 0; --count, p += stride)
+    {
+        float* v = (float*)p;
+
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(v[0])), _mm_mul_ps(c1, _mm_set1_ps(v[1]))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(v[2])), c3));
+        storeVec3(v, r);
+    }
+#else
+    for (; count > 0; --count, p += stride)
+    {
+        float* v = (float*)p;
+        float x = v[0], y = v[1], z = v[2];
+
+        v[0] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        v[1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        v[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+    }
+#endif
+}
+
 NS_CC_MATH_END
@@ -66,6 +66,19 @@ public:
      */
     static void smooth(float* x, float target, float elapsedTime, float riseTime, float fallTime);
 
+    /**
+     * Transforms points in place by the given matrix, treating the w coordinate as one.
+     * The points are read every `stride` bytes, so the positions of interleaved vertices
+     * (e.g. V3F_C4B_T2F) can be transformed without unpacking them.
+     * Uses AVX or SSE2 when the compiler targets them, and plain C otherwise.
+     *
+     * @param m the matrix.
+     * @param vertices pointer to the x coordinate of the first point.
+     * @param count number of points to transform.
+     * @param stride distance in bytes between two consecutive points.
+     */
+    static void transformVertices(const float* m, float* vertices, size_t count, size_t stride);
+
 private:
 
     inline static void addMatrix(const float* m, float scalar, float* dst);
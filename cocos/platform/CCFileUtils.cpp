@@ -577,6 +577,21 @@ Data FileUtils::getDataFromFile(const std::string& filename)
     return getData(filename, false);
 }
 
+MappedData FileUtils::getMappedDataFromFile(const std::string& filename)
+{
+    MappedData ret;
+    if (filename.empty())
+    {
+        return ret;
+    }
+
+    if (!ret.map(fullPathForFilename(filename)))
+    {
+        ret.setData(getDataFromFile(filename));
+    }
+    return ret;
+}
+
 unsigned char* FileUtils::getFileData(const std::string& filename, const char* mode, ssize_t *size)
 {
     unsigned char * buffer = nullptr;
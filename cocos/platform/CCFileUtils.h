@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "base/ccTypes.h"
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "platform/CCMappedData.h"
 
 NS_CC_BEGIN
 
@@ -88,6 +89,14 @@ public:
      *  @return A data object.
      */
     virtual Data getDataFromFile(const std::string& filename);
+
+    /**
+     *  Maps a file into memory, or reads it with getDataFromFile() when it can't be mapped.
+     *  The mapping gives the raw bytes of the file: subclasses that transform the content in
+     *  getDataFromFile() should override this method too.
+     *  @return A mapped data object, null if the file can't be read.
+     */
+    virtual MappedData getMappedDataFromFile(const std::string& filename);
     
     /**
      *  Gets resource file data
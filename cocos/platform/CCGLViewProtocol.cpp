@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "base/CCTouch.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
+#include "renderer/ccGLStateCache.h"
 
 NS_CC_BEGIN
 
@@ -195,7 +196,7 @@ Vec2 GLViewProtocol::getVisibleOrigin() const
 void GLViewProtocol::setViewPortInPoints(float x , float y , float w , float h)
 {
 #if DIRECTX_ENABLED == 0
-    glViewport((GLint)(x * _scaleX + _viewPortRect.origin.x),
+    GL::viewport((GLint)(x * _scaleX + _viewPortRect.origin.x),
                (GLint)(y * _scaleY + _viewPortRect.origin.y),
                (GLsizei)(w * _scaleX),
                (GLsizei)(h * _scaleY));
@@ -207,7 +208,7 @@ void GLViewProtocol::setViewPortInPoints(float x , float y , float w , float h)
 void GLViewProtocol::setScissorInPoints(float x , float y , float w , float h)
 {
 #if DIRECTX_ENABLED == 0
-    glScissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
+    GL::scissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
               (GLint)(y * _scaleY + _viewPortRect.origin.y),
               (GLsizei)(w * _scaleX),
               (GLsizei)(h * _scaleY));
@@ -219,7 +220,7 @@ void GLViewProtocol::setScissorInPoints(float x , float y , float w , float h)
 bool GLViewProtocol::isScissorEnabled()
 {
 #if DIRECTX_ENABLED == 0
-	return (GL_FALSE == glIsEnabled(GL_SCISSOR_TEST)) ? false : true;
+	return (GL_FALSE == GL::isScissorTestEnabled()) ? false : true;
 #else
 	return DXStateCache::getInstance().isScissorEnabled();
 #endif
@@ -88,6 +88,25 @@ public:
     /** Open or close IME keyboard , subclass must implement this method. */
     virtual void setIMEKeyboardState(bool open) = 0;
 
+    /**
+     * Creates a GL context sharing its objects with the one of the view, so textures can be uploaded from another thread.
+     * Returns false if the platform can't share contexts. Must be called on the cocos2d thread.
+     * @since v3.2
+     */
+    virtual bool createSharedContext() { return false; }
+
+    /**
+     * Makes the shared context current on the calling thread, or detaches it from the calling thread if `current` is false.
+     * @since v3.2
+     */
+    virtual void makeSharedContextCurrent(bool current) {}
+
+    /**
+     * Destroys the shared context. It must not be current on any thread anymore. Must be called on the cocos2d thread.
+     * @since v3.2
+     */
+    virtual void destroySharedContext() {}
+
     /**
      * Polls input events. Subclass must implement methods if platform
      * does not provide event callbacks.
@@ -27,6 +27,9 @@ THE SOFTWARE.
 #include "platform/CCImage.h"
 
 #include <string>
+#include <vector>
+#include <atomic>
+#include <math.h>
 #include <ctype.h>
 
 #include "base/CCData.h"
@@ -79,6 +82,8 @@ extern "C"
 #include "base/CCConfiguration.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
+#include "base/CCThreadPool.h"
+#include "renderer/ccPixelConversion.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "android/CCFileUtilsAndroid.h"
 #endif
@@ -87,6 +92,16 @@ extern "C"
 #define CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD                          0x8C93
 #define CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD                      0x87EE
 
+#define CC_GL_ETC1_RGB8_OES                                        0x8D64
+#define CC_GL_COMPRESSED_RGB_S3TC_DXT1_EXT                         0x83F0
+#define CC_GL_COMPRESSED_RGBA_S3TC_DXT1_EXT                        0x83F1
+#define CC_GL_COMPRESSED_RGBA_S3TC_DXT3_EXT                        0x83F2
+#define CC_GL_COMPRESSED_RGBA_S3TC_DXT5_EXT                        0x83F3
+#define CC_GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG                      0x8C00
+#define CC_GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG                      0x8C01
+#define CC_GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG                     0x8C02
+#define CC_GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG                     0x8C03
+
 NS_CC_BEGIN
 
 //////////////////////////////////////////////////////////////////////////
@@ -347,6 +362,9 @@ namespace
 //struct and data for atitc(ktx) struct
 namespace
 {
+    static const unsigned char KTX_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+    static const uint32_t KTX_ENDIANNESS = 0x04030201;
+
     struct ATITCTexHeader
     {
         //HEADER
@@ -365,6 +383,57 @@ namespace
         uint32_t numberOfMipmapLevels;
         uint32_t bytesOfKeyValueData;
     };
+
+    // glType and glFormat are 0 for the compressed formats
+    Texture2D::PixelFormat getKTXPixelFormat(const ATITCTexHeader* header)
+    {
+        switch (header->glInternalFormat)
+        {
+            case CC_GL_ETC1_RGB8_OES:                       return Texture2D::PixelFormat::ETC;
+            case CC_GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+            case CC_GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:       return Texture2D::PixelFormat::S3TC_DXT1;
+            case CC_GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:       return Texture2D::PixelFormat::S3TC_DXT3;
+            case CC_GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:       return Texture2D::PixelFormat::S3TC_DXT5;
+            case CC_GL_ATC_RGB_AMD:                         return Texture2D::PixelFormat::ATC_RGB;
+            case CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD:         return Texture2D::PixelFormat::ATC_EXPLICIT_ALPHA;
+            case CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD:     return Texture2D::PixelFormat::ATC_INTERPOLATED_ALPHA;
+            case CC_GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG:     return Texture2D::PixelFormat::PVRTC4;
+            case CC_GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG:     return Texture2D::PixelFormat::PVRTC2;
+            case CC_GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG:    return Texture2D::PixelFormat::PVRTC4A;
+            case CC_GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG:    return Texture2D::PixelFormat::PVRTC2A;
+            default:
+                break;
+        }
+
+        // GL_UNSIGNED_BYTE
+        if (header->glType == 0x1401)
+        {
+            switch (header->glFormat)
+            {
+                case 0x1908: return Texture2D::PixelFormat::RGBA8888;   // GL_RGBA
+                case 0x80E1: return Texture2D::PixelFormat::BGRA8888;   // GL_BGRA
+                case 0x1907: return Texture2D::PixelFormat::RGB888;     // GL_RGB
+                case 0x1906: return Texture2D::PixelFormat::A8;         // GL_ALPHA
+                case 0x1909: return Texture2D::PixelFormat::I8;         // GL_LUMINANCE
+                case 0x190A: return Texture2D::PixelFormat::AI88;       // GL_LUMINANCE_ALPHA
+                default:
+                    break;
+            }
+        }
+        else if (header->glType == 0x8033 && header->glFormat == 0x1908)   // GL_UNSIGNED_SHORT_4_4_4_4
+        {
+            return Texture2D::PixelFormat::RGBA4444;
+        }
+        else if (header->glType == 0x8034 && header->glFormat == 0x1908)   // GL_UNSIGNED_SHORT_5_5_5_1
+        {
+            return Texture2D::PixelFormat::RGB5A1;
+        }
+        else if (header->glType == 0x8363 && header->glFormat == 0x1907)   // GL_UNSIGNED_SHORT_5_6_5
+        {
+            return Texture2D::PixelFormat::RGB565;
+        }
+        return Texture2D::PixelFormat::NONE;
+    }
 }
 //atittc struct end
 
@@ -415,7 +484,47 @@ Image::Image()
 
 Image::~Image()
 {
-    CC_SAFE_FREE(_data);
+    freeData();
+}
+
+void Image::setDecodeOptions(const DecodeOptions& options)
+{
+    CCASSERT(!options.allocate == !options.deallocate, "allocate and deallocate must be set together");
+    _decodeOptions = options;
+}
+
+unsigned char* Image::allocateData(ssize_t size)
+{
+    if (_decodeOptions.allocate)
+    {
+        _dataDeallocator = _decodeOptions.deallocate;
+        return _decodeOptions.allocate(size);
+    }
+
+    _dataDeallocator = nullptr;
+    return static_cast<unsigned char*>(malloc(size * sizeof(unsigned char)));
+}
+
+void Image::freeData()
+{
+    if (!_mappedData.isNull())
+    {
+        // _data points into the mapping when there is one
+        _mappedData.clear();
+    }
+    else if (_data != nullptr)
+    {
+        if (_dataDeallocator)
+        {
+            _dataDeallocator(_data);
+        }
+        else
+        {
+            free(_data);
+        }
+    }
+    _data = nullptr;
+    _dataDeallocator = nullptr;
 }
 
 bool Image::initWithImageFile(const std::string& path)
@@ -443,12 +552,7 @@ bool Image::initWithImageFile(const std::string& path)
 
     SDL_FreeSurface(iSurf);
 #else
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
-
-    if (!data.isNull())
-    {
-        ret = initWithImageData(data.getBytes(), data.getSize());
-    }
+    ret = initWithImageFileThreadSafe(_filePath);
 #endif // EMSCRIPTEN
 
     return ret;
@@ -459,11 +563,29 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     bool ret = false;
     _filePath = fullpath;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    _mappedData = FileUtils::getInstance()->getMappedDataFromFile(fullpath);
 
-    if (!data.isNull())
+    if (_mappedData.isMapped() && !isKtx(_mappedData.getBytes(), _mappedData.getSize()))
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        // only KTX files are used from the mapping, the other formats go through getDataFromFile() as before
+        _mappedData.clear();
+
+        Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+
+        if (!data.isNull())
+        {
+            ret = initWithImageData(data.getBytes(), data.getSize());
+        }
+    }
+    else if (!_mappedData.isNull())
+    {
+        ret = initWithImageData(_mappedData.getBytes(), _mappedData.getSize());
+    }
+
+    // initWithKTXData() only keeps the compressed mipmaps in the mapping
+    if (!ret || _data < _mappedData.getBytes() || _data >= _mappedData.getBytes() + _mappedData.getSize())
+    {
+        _mappedData.clear();
     }
 
     return ret;
@@ -521,7 +643,8 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
             ret = initWithS3TCData(unpackedData, unpackedLen);
             break;
         case Format::ATITC:
-            ret = initWithATITCData(unpackedData, unpackedLen);
+        case Format::KTX:
+            ret = initWithKTXData(unpackedData, unpackedLen);
             break;
         default:
             {
@@ -585,14 +708,30 @@ bool Image::isS3TC(const unsigned char * data, ssize_t dataLen)
 
 bool Image::isATITC(const unsigned char *data, ssize_t dataLen)
 {
-    ATITCTexHeader *header = (ATITCTexHeader *)data;
-    
-    if (strncmp(&header->identifier[1], "KTX", 3) != 0)
+    if (!isKtx(data, dataLen))
     {
-        CCLOG("cocos3d: the file is not a ktx file!");
         return false;
     }
-    return true;
+
+    switch (((const ATITCTexHeader *)data)->glInternalFormat)
+    {
+        case CC_GL_ATC_RGB_AMD:
+        case CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD:
+        case CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Image::isKtx(const unsigned char * data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(ATITCTexHeader))
+    {
+        return false;
+    }
+
+    return memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) == 0;
 }
 
 bool Image::isJpg(const unsigned char * data, ssize_t dataLen)
@@ -682,6 +821,10 @@ Image::Format Image::detectFormat(const unsigned char * data, ssize_t dataLen)
     {
         return Format::ATITC;
     }
+    else if (isKtx(data, dataLen))
+    {
+        return Format::KTX;
+    }
     else
     {
         return Format::UNKOWN;
@@ -760,6 +903,57 @@ namespace
     }
 }
 
+namespace
+{
+    static const int MAX_DECODE_FACTOR = 256;
+
+    // Returns the smallest integer factor reducing the image to the size asked by the options
+    int getDecodeFactor(const Image::DecodeOptions& options, int width, int height)
+    {
+        int size = MAX(width, height);
+        float scale = MIN(options.scale, 1.0f);
+        if (options.maxSize > 0 && size * scale > options.maxSize)
+        {
+            scale = (float)options.maxSize / size;
+        }
+        if (scale <= 0 || size <= 1)
+        {
+            return 1;
+        }
+
+        int factor = (int)ceilf(1.0f / scale - 0.001f);
+        return MAX(MIN(factor, MIN(size, MAX_DECODE_FACTOR)), 1);
+    }
+
+    // Averages up to factor rows of width pixels by blocks of factor pixels, into one row of ceil(width / factor) pixels
+    void downscaleRows(const unsigned char* rows, int rowCount, int width, int bytesPerPixel, int factor, unsigned char* outRow)
+    {
+        int rowBytes = width * bytesPerPixel;
+        for (int begin = 0; begin < width; begin += factor)
+        {
+            int count = MIN(factor, width - begin);
+            unsigned int sums[4] = {0, 0, 0, 0};
+            for (int y = 0; y < rowCount; ++y)
+            {
+                const unsigned char* pixel = rows + y * rowBytes + begin * bytesPerPixel;
+                for (int x = 0; x < count; ++x)
+                {
+                    for (int c = 0; c < bytesPerPixel; ++c)
+                    {
+                        sums[c] += *pixel++;
+                    }
+                }
+            }
+
+            unsigned int total = count * rowCount;
+            for (int c = 0; c < bytesPerPixel; ++c)
+            {
+                *outRow++ = (unsigned char)((sums[c] + total / 2) / total);
+            }
+        }
+    }
+}
+
 bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
 {
     /* these are standard libjpeg structures for reading(decompression) */
@@ -771,8 +965,8 @@ bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
 	struct MyErrorMgr jerr;
     /* libjpeg data structure for storing one row, that is, scanline of an image */
     JSAMPROW row_pointer[1] = {0};
-    unsigned long location = 0;
-    unsigned int i = 0;
+    /* rows averaged together when the image is reduced more than libjpeg can */
+    std::vector<unsigned char> scaleRows;
 
     bool bRet = false;
     do 
@@ -814,29 +1008,57 @@ bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
             _renderFormat = Texture2D::PixelFormat::RGB888;
         }
 
+        /* libjpeg reduces the image by 2, 4 or 8 while decoding, the rest of the factor is averaged */
+        int factor = getDecodeFactor(_decodeOptions, cinfo.image_width, cinfo.image_height);
+        int dctFactor = 1;
+        while (dctFactor < 8 && factor % (dctFactor * 2) == 0)
+        {
+            dctFactor *= 2;
+        }
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = dctFactor;
+        factor /= dctFactor;
+
         /* Start decompression jpeg here */
         jpeg_start_decompress( &cinfo );
 
         /* init image info */
-        _width  = cinfo.output_width;
-        _height = cinfo.output_height;
+        int rowBytes = cinfo.output_width * cinfo.output_components;
+        _width  = (cinfo.output_width + factor - 1) / factor;
+        _height = (cinfo.output_height + factor - 1) / factor;
         _preMulti = false;
-        row_pointer[0] = static_cast<unsigned char*>(malloc(cinfo.output_width*cinfo.output_components * sizeof(unsigned char)));
-        CC_BREAK_IF(! row_pointer[0]);
 
-        _dataLen = cinfo.output_width*cinfo.output_height*cinfo.output_components;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+        _dataLen = _width * _height * cinfo.output_components;
+        _data = allocateData(_dataLen);
         CC_BREAK_IF(! _data);
 
+        if (factor > 1)
+        {
+            scaleRows.resize(rowBytes * factor);
+        }
+
         /* now actually read the jpeg into the raw buffer */
         /* read one scan line at a time */
+        unsigned char* outRow = _data;
         while( cinfo.output_scanline < cinfo.output_height )
         {
-            jpeg_read_scanlines( &cinfo, row_pointer, 1 );
-            for( i=0; i<cinfo.output_width*cinfo.output_components;i++) 
+            if (factor == 1)
+            {
+                row_pointer[0] = outRow;
+                jpeg_read_scanlines( &cinfo, row_pointer, 1 );
+                outRow += rowBytes;
+                continue;
+            }
+
+            int rowCount = 0;
+            while (rowCount < factor && cinfo.output_scanline < cinfo.output_height)
             {
-                _data[location++] = row_pointer[0][i];
+                row_pointer[0] = &scaleRows[rowCount * rowBytes];
+                jpeg_read_scanlines( &cinfo, row_pointer, 1 );
+                ++rowCount;
             }
+            downscaleRows(scaleRows.data(), rowCount, cinfo.output_width, cinfo.output_components, factor, outRow);
+            outRow += _width * cinfo.output_components;
         }
 
 		/* When read image file with broken data, jpeg_finish_decompress() may cause error.
@@ -850,10 +1072,6 @@ bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
         bRet = true;
     } while (0);
 
-    if (row_pointer[0] != nullptr)
-    {
-        free(row_pointer[0]);
-    };
     return bRet;
 }
 
@@ -865,6 +1083,8 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
     png_byte        header[PNGSIGSIZE]   = {0}; 
     png_structp     png_ptr     =   0;
     png_infop       info_ptr    = 0;
+    // rows averaged together when the image is reduced
+    std::vector<unsigned char> scaleRows;
 
     do 
     {
@@ -957,34 +1177,73 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
         }
 
         // read png data
-        png_size_t rowbytes;
-        png_bytep* row_pointers = (png_bytep*)malloc( sizeof(png_bytep) * _height );
+        png_size_t rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+        int bytesPerPixel = png_get_channels(png_ptr, info_ptr);
+        int sourceWidth = _width;
+        int sourceHeight = _height;
+        int factor = getDecodeFactor(_decodeOptions, sourceWidth, sourceHeight);
+        _width = (sourceWidth + factor - 1) / factor;
+        _height = (sourceHeight + factor - 1) / factor;
+
+        _dataLen = _width * bytesPerPixel * _height;
+        _data = allocateData(_dataLen);
+        CC_BREAK_IF(!_data);
+
+        // interlaced images are only complete once every pass is read
+        bool interlaced = png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE;
+        int rowsPerRead = (factor == 1 || interlaced) ? sourceHeight : factor;
+        unsigned char* rows = _data;
+        if (factor > 1)
+        {
+            scaleRows.resize(rowbytes * rowsPerRead);
+            rows = scaleRows.data();
+        }
 
-        rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+        png_bytep* row_pointers = (png_bytep*)malloc( sizeof(png_bytep) * rowsPerRead );
+        for (int i = 0; i < rowsPerRead; ++i)
+        {
+            row_pointers[i] = rows + i*rowbytes;
+        }
 
-        _dataLen = rowbytes * _height;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        if(!_data)
+        if (rowsPerRead == sourceHeight)
         {
-            if (row_pointers != nullptr)
-            {
-                free(row_pointers);
-            }
-            break;
+            png_read_image(png_ptr, row_pointers);
         }
 
-        for (unsigned short i = 0; i < _height; ++i)
+        if (factor > 1)
         {
-            row_pointers[i] = _data + i*rowbytes;
+            unsigned char* outRow = _data;
+            for (int y = 0; y < sourceHeight; y += factor)
+            {
+                int rowCount = MIN(factor, sourceHeight - y);
+                unsigned char* blockRows = rows + (rowsPerRead == sourceHeight ? y * rowbytes : 0);
+                if (rowsPerRead != sourceHeight)
+                {
+                    png_read_rows(png_ptr, row_pointers, nullptr, rowCount);
+                }
+                // the colors are premultiplied before being averaged, so transparent pixels don't bleed into the others
+                if (color_type == PNG_COLOR_TYPE_RGB_ALPHA)
+                {
+                    PixelConversion::premultiplyAlpha(blockRows, rowCount * rowbytes);
+                }
+                downscaleRows(blockRows, rowCount, sourceWidth, bytesPerPixel, factor, outRow);
+                outRow += _width * bytesPerPixel;
+            }
         }
-        png_read_image(png_ptr, row_pointers);
 
         png_read_end(png_ptr, nullptr);
 
         // premultiplied alpha for RGBA8888
         if (color_type == PNG_COLOR_TYPE_RGB_ALPHA)
         {
-            premultipliedAlpha();
+            if (factor == 1)
+            {
+                premultipliedAlpha();
+            }
+            else
+            {
+                _preMulti = true;
+            }
         }
         else
         {
@@ -1463,6 +1722,35 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
 	return true;
 }
 
+namespace
+{
+    // block rows are independent, so the software decoders are run on ranges of them
+    static const int DECODE_BLOCK_ROWS_PER_TASK = 8;
+    static bool s_parallelDecodeEnabled = true;
+
+    void decodeBlockRows(int blockRows, const std::function<void(int begin, int end)>& decodeRows)
+    {
+        if (s_parallelDecodeEnabled)
+        {
+            ThreadPool::getInstance()->parallelFor(blockRows, decodeRows, DECODE_BLOCK_ROWS_PER_TASK);
+        }
+        else
+        {
+            decodeRows(0, blockRows);
+        }
+    }
+}
+
+void Image::setParallelDecodeEnabled(bool enabled)
+{
+    s_parallelDecodeEnabled = enabled;
+}
+
+bool Image::isParallelDecodeEnabled()
+{
+    return s_parallelDecodeEnabled;
+}
+
 bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
 {
     const etc1_byte* header = static_cast<const etc1_byte*>(data);
@@ -1504,7 +1792,18 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
         _dataLen =  _width * _height * bytePerPixel;
         _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
         
-        if (etc1_decode_image(static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, static_cast<etc1_byte*>(_data), _width, _height, bytePerPixel, stride) != 0)
+        const etc1_byte* encodeData = static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE;
+        int blocksWide = (_width + 3) / 4;
+        std::atomic<bool> failed(false);
+        decodeBlockRows((_height + 3) / 4, [&](int begin, int end) {
+            int rows = std::min(_height, end * 4) - begin * 4;
+            if (etc1_decode_image(encodeData + begin * blocksWide * ETC1_ENCODED_BLOCK_SIZE, static_cast<etc1_byte*>(_data) + begin * 4 * stride, _width, rows, bytePerPixel, stride) != 0)
+            {
+                failed = true;
+            }
+        });
+
+        if (failed)
         {
             _dataLen = 0;
             if (_data != nullptr)
@@ -1700,23 +1999,43 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
             int bytePerPixel = 4;
             unsigned int stride = width * bytePerPixel;
 
-            std::vector<unsigned char> decodeImageData(stride * height);
+            _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
+            _mipmaps[i].len = (stride * height);
+
+            bool supported = true;
+            S3TCDecodeFlag decodeFlag = S3TCDecodeFlag::DXT1;
             if (FOURCC_DXT1 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT1);
+                decodeFlag = S3TCDecodeFlag::DXT1;
             }
             else if (FOURCC_DXT3 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT3);
+                decodeFlag = S3TCDecodeFlag::DXT3;
             }
             else if (FOURCC_DXT5 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT5);
+                decodeFlag = S3TCDecodeFlag::DXT5;
+            }
+            else
+            {
+                supported = false;
+            }
+
+            // the decoder skips the partial blocks of the small mipmaps, they stay black
+            if (!supported || ((width | height) & 3))
+            {
+                memset(_mipmaps[i].address, 0, _mipmaps[i].len);
+            }
+
+            if (supported)
+            {
+                unsigned char* encodeData = pixelData + encodeOffset;
+                unsigned char* decodeData = _mipmaps[i].address;
+                int blocksWide = width / 4;
+                decodeBlockRows(height / 4, [=](int begin, int end) {
+                    s3tc_decode(encodeData + begin * blocksWide * blockSize, decodeData + begin * 4 * stride, width, (end - begin) * 4, decodeFlag);
+                });
             }
-            
-            _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
-            _mipmaps[i].len = (stride * height);
-            memcpy((void *)_mipmaps[i].address, (void *)&decodeImageData[0], _mipmaps[i].len);
             decodeOffset += stride * height;
         }
         
@@ -1857,25 +2176,42 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
             unsigned int stride = width * bytePerPixel;
             _renderFormat = Texture2D::PixelFormat::RGBA8888;
             
-            std::vector<unsigned char> decodeImageData(stride * height);
+            _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
+            _mipmaps[i].len = (stride * height);
+
+            bool supported = true;
+            ATITCDecodeFlag decodeFlag = ATITCDecodeFlag::ATC_RGB;
             switch (header->glInternalFormat)
             {
                 case CC_GL_ATC_RGB_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_RGB);
+                    decodeFlag = ATITCDecodeFlag::ATC_RGB;
                     break;
                 case CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
+                    decodeFlag = ATITCDecodeFlag::ATC_EXPLICIT_ALPHA;
                     break;
                 case CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
+                    decodeFlag = ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA;
                     break;
                 default:
+                    supported = false;
                     break;
             }
 
-            _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
-            _mipmaps[i].len = (stride * height);
-            memcpy((void *)_mipmaps[i].address, (void *)&decodeImageData[0], _mipmaps[i].len);
+            // the decoder skips the partial blocks of the small mipmaps, they stay black
+            if (!supported || ((width | height) & 3))
+            {
+                memset(_mipmaps[i].address, 0, _mipmaps[i].len);
+            }
+
+            if (supported)
+            {
+                unsigned char* encodeData = pixelData + encodeOffset;
+                unsigned char* decodeData = _mipmaps[i].address;
+                int blocksWide = width / 4;
+                decodeBlockRows(height / 4, [=](int begin, int end) {
+                    atitc_decode(encodeData + begin * blocksWide * blockSize, decodeData + begin * 4 * stride, width, (end - begin) * 4, decodeFlag);
+                });
+            }
             decodeOffset += stride * height;
         }
 
@@ -1888,6 +2224,232 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
     return true;
 }
 
+bool Image::initWithKTXData(const unsigned char * data, ssize_t dataLen)
+{
+    const ATITCTexHeader *header = (const ATITCTexHeader *)data;
+    if (header->endianness != KTX_ENDIANNESS)
+    {
+        CCLOG("cocos2d: WARNING: KTX files of the other endianness are not supported");
+        return false;
+    }
+    if (header->pixelDepth > 1 || header->numberOfArrayElements > 0 || header->numberOfFaces != 1)
+    {
+        CCLOG("cocos2d: WARNING: KTX 3D textures, texture arrays and cube maps are not supported");
+        return false;
+    }
+
+    Texture2D::PixelFormat format = getKTXPixelFormat(header);
+    bool compressed = (header->glType == 0);
+    bool hardwareDecode = true;
+    int blockSize = 8;
+    switch (format)
+    {
+        case Texture2D::PixelFormat::NONE:
+            CCLOG("cocos2d: WARNING: unsupported KTX format: glInternalFormat 0x%04X glFormat 0x%04X glType 0x%04X",
+                  header->glInternalFormat, header->glFormat, header->glType);
+            return false;
+        case Texture2D::PixelFormat::ETC:
+            hardwareDecode = Configuration::getInstance()->supportsETC();
+            break;
+        case Texture2D::PixelFormat::S3TC_DXT1:
+            hardwareDecode = Configuration::getInstance()->supportsS3TC();
+            break;
+        case Texture2D::PixelFormat::S3TC_DXT3:
+        case Texture2D::PixelFormat::S3TC_DXT5:
+            hardwareDecode = Configuration::getInstance()->supportsS3TC();
+            blockSize = 16;
+            break;
+        case Texture2D::PixelFormat::ATC_RGB:
+        case Texture2D::PixelFormat::ATC_EXPLICIT_ALPHA:
+        case Texture2D::PixelFormat::ATC_INTERPOLATED_ALPHA:
+            if (!Configuration::getInstance()->supportsATITC())
+            {
+                return initWithATITCData(data, dataLen);
+            }
+            break;
+        case Texture2D::PixelFormat::PVRTC4:
+        case Texture2D::PixelFormat::PVRTC4A:
+        case Texture2D::PixelFormat::PVRTC2:
+        case Texture2D::PixelFormat::PVRTC2A:
+            if (!Configuration::getInstance()->supportsPVRTC())
+            {
+                CCLOG("cocos2d: WARNING: PVRTC images are not supported");
+                return false;
+            }
+            break;
+        default:
+            break;
+    }
+
+    _width = static_cast<int>(header->pixelWidth);
+    // 1D textures have a height of 0
+    _height = MAX(static_cast<int>(header->pixelHeight), 1);
+    // 0 asks the loader to generate the mipmaps
+    _numberOfMipmaps = MAX(static_cast<int>(header->numberOfMipmapLevels), 1);
+    if (_width <= 0 || header->pixelHeight > 0x7FFFFFFF || _numberOfMipmaps > MIPMAP_MAX)
+    {
+        CCLOG("cocos2d: WARNING: invalid KTX size %d x %d with %d mipmaps", _width, _height, _numberOfMipmaps);
+        return false;
+    }
+
+    /* locate the mipmaps: each one is preceded by its size and padded to 4 bytes */
+    const unsigned char* levels[MIPMAP_MAX];
+    uint32_t levelSizes[MIPMAP_MAX];
+    size_t offset = sizeof(ATITCTexHeader);
+    if (header->bytesOfKeyValueData > static_cast<size_t>(dataLen) - offset)
+    {
+        CCLOG("cocos2d: WARNING: truncated KTX file");
+        return false;
+    }
+    offset += header->bytesOfKeyValueData;
+
+    for (int i = 0; i < _numberOfMipmaps; ++i)
+    {
+        if (static_cast<size_t>(dataLen) - offset < 4)
+        {
+            CCLOG("cocos2d: WARNING: truncated KTX file");
+            return false;
+        }
+        memcpy(&levelSizes[i], data + offset, 4);
+        offset += 4;
+
+        if (levelSizes[i] > static_cast<size_t>(dataLen) - offset)
+        {
+            CCLOG("cocos2d: WARNING: truncated KTX file");
+            return false;
+        }
+        levels[i] = data + offset;
+        offset += (levelSizes[i] + 3) & ~3;
+        offset = MIN(offset, static_cast<size_t>(dataLen));
+    }
+
+    if (compressed && hardwareDecode)
+    {
+        /* the mipmaps are uploaded as they are, from the mapping of the file when there is one */
+        ssize_t len = (levels[_numberOfMipmaps - 1] + levelSizes[_numberOfMipmaps - 1]) - levels[0];
+        if (data == _mappedData.getBytes())
+        {
+            _data = const_cast<unsigned char*>(levels[0]);
+        }
+        else
+        {
+            _data = static_cast<unsigned char*>(malloc(len * sizeof(unsigned char)));
+            memcpy(_data, levels[0], len);
+        }
+        _dataLen = len;
+        _renderFormat = format;
+
+        for (int i = 0; i < _numberOfMipmaps; ++i)
+        {
+            _mipmaps[i].address = _data + (levels[i] - levels[0]);
+            _mipmaps[i].len = levelSizes[i];
+        }
+        return true;
+    }
+
+    int bytePerPixel = 0;
+    if (compressed)
+    {
+        CCLOG("cocos2d: Hardware %s decoder not present. Using software decoder", format == Texture2D::PixelFormat::ETC ? "ETC" : "S3TC");
+        _renderFormat = (format == Texture2D::PixelFormat::ETC) ? Texture2D::PixelFormat::RGB888 : Texture2D::PixelFormat::RGBA8888;
+    }
+    else
+    {
+        _renderFormat = format;
+    }
+    bytePerPixel = Texture2D::getPixelFormatInfoMap().at(_renderFormat).bpp / 8;
+
+    int width = _width;
+    int height = _height;
+    for (int i = 0; i < _numberOfMipmaps; ++i)
+    {
+        _dataLen += width * height * bytePerPixel;
+        width = MAX(width >> 1, 1);
+        height = MAX(height >> 1, 1);
+    }
+    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+
+    std::atomic<bool> failed(false);
+    int decodeOffset = 0;
+    width = _width;
+    height = _height;
+    for (int i = 0; i < _numberOfMipmaps && !failed; ++i)
+    {
+        unsigned int stride = width * bytePerPixel;
+        const unsigned char* encodeData = levels[i];
+        unsigned char* decodeData = _data + decodeOffset;
+        _mipmaps[i].address = decodeData;
+        _mipmaps[i].len = stride * height;
+
+        if (!compressed)
+        {
+            /* the rows of the file are padded to 4 bytes, the ones of Texture2D are not */
+            unsigned int fileStride = (stride + 3) & ~3;
+            if (levelSizes[i] < fileStride * (height - 1) + stride)
+            {
+                failed = true;
+                break;
+            }
+            for (int y = 0; y < height; ++y)
+            {
+                memcpy(decodeData + y * stride, encodeData + y * fileStride, stride);
+            }
+        }
+        else if (levelSizes[i] < static_cast<uint32_t>(((width + 3) / 4) * ((height + 3) / 4) * blockSize))
+        {
+            failed = true;
+            break;
+        }
+        else if (format == Texture2D::PixelFormat::ETC)
+        {
+            int blocksWide = (width + 3) / 4;
+            decodeBlockRows((height + 3) / 4, [&, width, height, stride, encodeData, decodeData](int begin, int end) {
+                int rows = MIN(height, end * 4) - begin * 4;
+                if (etc1_decode_image(encodeData + begin * blocksWide * ETC1_ENCODED_BLOCK_SIZE, decodeData + begin * 4 * stride, width, rows, bytePerPixel, stride) != 0)
+                {
+                    failed = true;
+                }
+            });
+        }
+        else
+        {
+            S3TCDecodeFlag decodeFlag = S3TCDecodeFlag::DXT1;
+            if (format == Texture2D::PixelFormat::S3TC_DXT3)
+            {
+                decodeFlag = S3TCDecodeFlag::DXT3;
+            }
+            else if (format == Texture2D::PixelFormat::S3TC_DXT5)
+            {
+                decodeFlag = S3TCDecodeFlag::DXT5;
+            }
+
+            // the decoder skips the partial blocks of the small mipmaps, they stay black
+            if ((width | height) & 3)
+            {
+                memset(decodeData, 0, _mipmaps[i].len);
+            }
+
+            int blocksWide = width / 4;
+            decodeBlockRows(height / 4, [=](int begin, int end) {
+                s3tc_decode(const_cast<unsigned char*>(encodeData) + begin * blocksWide * blockSize, decodeData + begin * 4 * stride, width, (end - begin) * 4, decodeFlag);
+            });
+        }
+
+        decodeOffset += stride * height;
+        width = MAX(width >> 1, 1);
+        height = MAX(height >> 1, 1);
+    }
+
+    if (failed)
+    {
+        CCLOG("cocos2d: WARNING: invalid KTX mipmap data");
+        _dataLen = 0;
+        CC_SAFE_FREE(_data);
+        return false;
+    }
+    return true;
+}
+
 bool Image::initWithPVRData(const unsigned char * data, ssize_t dataLen)
 {
     return initWithPVRv2Data(data, dataLen) || initWithPVRv3Data(data, dataLen);
@@ -1911,9 +2473,21 @@ bool Image::initWithWebpData(const unsigned char * data, ssize_t dataLen)
         _renderFormat = Texture2D::PixelFormat::RGBA8888;
         _width    = config.input.width;
         _height   = config.input.height;
+
+        // libwebp resamples the image while decoding it
+        int factor = getDecodeFactor(_decodeOptions, _width, _height);
+        if (factor > 1)
+        {
+            _width = (_width + factor - 1) / factor;
+            _height = (_height + factor - 1) / factor;
+            config.options.use_scaling = 1;
+            config.options.scaled_width = _width;
+            config.options.scaled_height = _height;
+        }
         
         _dataLen = _width * _height * 4;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+        _data = allocateData(_dataLen);
+        if (!_data) break;
         
         config.output.u.RGBA.rgba = static_cast<uint8_t*>(_data);
         config.output.u.RGBA.stride = _width * 4;
@@ -1922,8 +2496,7 @@ bool Image::initWithWebpData(const unsigned char * data, ssize_t dataLen)
         
         if (WebPDecode(static_cast<const uint8_t*>(data), dataLen, &config) != VP8_STATUS_OK)
         {
-            free(_data);
-            _data = nullptr;
+            freeData();
             break;
         }
         
@@ -2231,12 +2804,7 @@ void Image::premultipliedAlpha()
 {
     CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
-    {
-        unsigned char* p = _data + i * 4;
-        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-    }
+    PixelConversion::premultiplyAlpha(_data, (ssize_t)_width * _height * 4);
     
     _preMulti = true;
 }
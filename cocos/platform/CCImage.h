@@ -26,8 +26,11 @@ THE SOFTWARE.
 #ifndef __CC_IMAGE_H__
 #define __CC_IMAGE_H__
 
+#include <functional>
+
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
+#include "platform/CCMappedData.h"
 
 // premultiply alpha, or the effect will wrong when want to use other pixel format in Texture2D,
 // such as RGB888, RGB5A1
@@ -86,6 +89,8 @@ public:
         S3TC,
         //! ATITC
         ATITC,
+        //! KTX
+        KTX,
         //! TGA
         TGA,
         //! Raw Data
@@ -94,6 +99,34 @@ public:
         UNKOWN
     };
 
+    /** @brief How PNG, JPEG and WebP images are decoded.
+
+     The image can be reduced while it is decoded, so the pixels that would be thrown away are never stored:
+     it is reduced by the smallest integer factor that fits both the scale and the max size, up to 256.
+     JPEG images are reduced by 2, 4 or 8 by libjpeg while decoding, and WebP images by libwebp.
+     The rest is done by averaging the pixels while the rows are decoded.
+     The width and height become ceil(size / factor) for every format.
+
+     The pixels are allocated with `allocate` when it is set, and given back to `deallocate` when the image
+     releases them, so streaming loads can recycle their buffers from a pool.
+     */
+    struct DecodeOptions
+    {
+        DecodeOptions()
+        : scale(1.0f)
+        , maxSize(0)
+        {}
+
+        /** Scale of the decoded image, at most 1 */
+        float scale;
+        /** Largest width or height of the decoded image in pixels, 0 for no limit */
+        int maxSize;
+        /** Allocates the pixels of the image. Must be set together with deallocate */
+        std::function<unsigned char*(ssize_t size)> allocate;
+        /** Frees the pixels returned by allocate */
+        std::function<void(unsigned char* data)> deallocate;
+    };
+
     /**
     @brief Load the image from the specified path.
     @param path   the absolute file path.
@@ -138,6 +171,14 @@ public:
      */
     bool saveToFile(const std::string &filename, bool isToRGB = true);
 
+    /** Sets how the next initWithImageFile() or initWithImageData() decodes PNG, JPEG and WebP images */
+    void setDecodeOptions(const DecodeOptions& options);
+    inline const DecodeOptions& getDecodeOptions() const { return _decodeOptions; }
+
+    /** Splits the software decoding of ETC1, S3TC and ATITC images by block rows across the ThreadPool. Enabled by default */
+    static void setParallelDecodeEnabled(bool enabled);
+    static bool isParallelDecodeEnabled();
+
 protected:
     bool initWithJpgData(const unsigned char *  data, ssize_t dataLen);
     bool initWithPngData(const unsigned char * data, ssize_t dataLen);
@@ -149,6 +190,7 @@ protected:
     bool initWithETCData(const unsigned char * data, ssize_t dataLen);
     bool initWithS3TCData(const unsigned char * data, ssize_t dataLen);
     bool initWithATITCData(const unsigned char *data, ssize_t dataLen);
+    bool initWithKTXData(const unsigned char * data, ssize_t dataLen);
     typedef struct sImageTGA tImageTGA;
     bool initWithTGAData(tImageTGA* tgaData);
 
@@ -156,6 +198,11 @@ protected:
     bool saveImageToJPG(const std::string& filePath);
     
     void premultipliedAlpha();
+
+    /** Allocates _data with the allocator of the decode options, or malloc */
+    unsigned char* allocateData(ssize_t size);
+    /** Releases _data the way it was allocated */
+    void freeData();
     
 protected:
     /**
@@ -175,6 +222,11 @@ protected:
     // false if we cann't auto detect the image is premultiplied or not.
     bool _hasPremultipliedAlpha;
     std::string _filePath;
+    // the file, kept only while _data points into it. See initWithImageFileThreadSafe()
+    MappedData _mappedData;
+    DecodeOptions _decodeOptions;
+    // frees _data when it was allocated by the decode options
+    std::function<void(unsigned char* data)> _dataDeallocator;
 
 
 protected:
@@ -185,6 +237,8 @@ protected:
     /*
      @brief The same result as with initWithImageFile, but thread safe. It is caused by
      loadImage() in TextureCache.cpp.
+     KTX files are mapped through FileUtils::getMappedDataFromFile(), so their compressed
+     mipmaps are uploaded from the mapping instead of a copy on the heap.
      @param fullpath  full path of the file.
      @param imageType the type of image, currently only supporting two types.
      @return  true if loaded correctly.
@@ -200,6 +254,7 @@ protected:
     bool isEtc(const unsigned char * data, ssize_t dataLen);
     bool isS3TC(const unsigned char * data,ssize_t dataLen);
     bool isATITC(const unsigned char *data, ssize_t dataLen);
+    bool isKtx(const unsigned char * data, ssize_t dataLen);
 };
 
 // end of platform group
@@ -0,0 +1,181 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCMappedData.h"
+
+#include "base/ccMacros.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CC_MAPPED_DATA_POSIX 1
+#endif
+
+NS_CC_BEGIN
+
+MappedData::MappedData()
+: _bytes(nullptr)
+, _size(0)
+, _mapped(false)
+{
+}
+
+MappedData::MappedData(MappedData&& other)
+: _bytes(other._bytes)
+, _size(other._size)
+, _mapped(other._mapped)
+, _data(std::move(other._data))
+{
+    other._bytes = nullptr;
+    other._size = 0;
+    other._mapped = false;
+}
+
+MappedData::~MappedData()
+{
+    clear();
+}
+
+MappedData& MappedData::operator= (MappedData&& other)
+{
+    if (this != &other)
+    {
+        clear();
+        _bytes = other._bytes;
+        _size = other._size;
+        _mapped = other._mapped;
+        _data = std::move(other._data);
+        other._bytes = nullptr;
+        other._size = 0;
+        other._mapped = false;
+    }
+    return *this;
+}
+
+bool MappedData::map(const std::string& fullPath)
+{
+    clear();
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    int length = MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, nullptr, 0);
+    if (length <= 0)
+        return false;
+    std::wstring widePath(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, &widePath[0], length);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    void* bytes = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            // the view keeps the mapping alive once the handles are closed
+            bytes = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+
+    if (bytes == nullptr)
+        return false;
+
+    _bytes = static_cast<unsigned char*>(bytes);
+    _size = static_cast<ssize_t>(fileSize.QuadPart);
+    _mapped = true;
+    return true;
+#elif defined(CC_MAPPED_DATA_POSIX)
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat fileStat;
+    void* bytes = MAP_FAILED;
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        bytes = mmap(nullptr, fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if (bytes == MAP_FAILED)
+        return false;
+
+    _bytes = static_cast<unsigned char*>(bytes);
+    _size = static_cast<ssize_t>(fileStat.st_size);
+    _mapped = true;
+    return true;
+#else
+    CC_UNUSED_PARAM(fullPath);
+    return false;
+#endif
+}
+
+void MappedData::setData(Data&& data)
+{
+    clear();
+    _data = std::move(data);
+    _bytes = _data.getBytes();
+    _size = _data.getSize();
+}
+
+unsigned char* MappedData::getBytes() const
+{
+    return _bytes;
+}
+
+ssize_t MappedData::getSize() const
+{
+    return _size;
+}
+
+void MappedData::clear()
+{
+    if (_mapped)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        UnmapViewOfFile(_bytes);
+#elif defined(CC_MAPPED_DATA_POSIX)
+        munmap(_bytes, _size);
+#endif
+    }
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+
+bool MappedData::isNull() const
+{
+    return _bytes == nullptr || _size <= 0;
+}
+
+NS_CC_END
@@ -0,0 +1,92 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCMAPPEDDATA_H__
+#define __CCMAPPEDDATA_H__
+
+#include <string>
+
+#include "base/CCData.h"
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** @brief The content of a file, mapped into memory when the platform allows it.
+
+ The mapping is private: the bytes can be written, and the pages written to are copied instead of
+ changing the file. The pages are only read from the disk when they are touched, and the system
+ can drop them again under memory pressure, so a mapped file doesn't count as heap memory.
+ When the file can't be mapped (Android assets, WinRT, ...), MappedData holds the Data read by FileUtils instead.
+
+ MappedData can be moved but not copied.
+ @see FileUtils::getMappedDataFromFile
+ @since v3.2
+ */
+class CC_DLL MappedData
+{
+public:
+    MappedData();
+    MappedData(MappedData&& other);
+    ~MappedData();
+
+    MappedData& operator= (MappedData&& other);
+
+    /** Maps the whole file. Returns false if the file can't be opened, is empty or the platform can't map files */
+    bool map(const std::string& fullPath);
+
+    /** Holds a buffer read in memory instead of a mapping */
+    void setData(Data&& data);
+
+    unsigned char* getBytes() const;
+    ssize_t getSize() const;
+
+    /** Whether the bytes come from a mapping, rather than from a Data */
+    inline bool isMapped() const { return _mapped; }
+
+    /** Unmaps the file or frees the data */
+    void clear();
+
+    bool isNull() const;
+
+private:
+    MappedData(const MappedData&);
+    MappedData& operator= (const MappedData&);
+
+    unsigned char* _bytes;
+    ssize_t _size;
+    bool _mapped;
+    Data _data;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CCMAPPEDDATA_H__
@@ -32,6 +32,12 @@ THE SOFTWARE.
 #define  LOGE(...)  __android_log_print(ANDROID_LOG_ERROR,LOG_TAG,__VA_ARGS__)
 
 static pthread_key_t g_key;
+// only set on the native threads attached by cacheEnv(), so they are detached when they exit
+static pthread_key_t g_attachedKey;
+
+static void _detachCurrentThread(void*) {
+    cocos2d::JniHelper::getJavaVM()->DetachCurrentThread();
+}
 
 jclass _getClassID(const char *className) {
     if (nullptr == className) {
@@ -74,6 +80,7 @@ namespace cocos2d {
         _psJavaVM = javaVM;
 
         pthread_key_create(&g_key, nullptr);
+        pthread_key_create(&g_attachedKey, _detachCurrentThread);
     }
 
     JNIEnv* JniHelper::cacheEnv(JavaVM* jvm) {
@@ -89,11 +96,11 @@ namespace cocos2d {
                 
         case JNI_EDETACHED :
             // Thread not attached
-                
-            // TODO : If calling AttachCurrentThread() on a native thread
-            // must call DetachCurrentThread() in future.
+
+            // A native thread attached by AttachCurrentThread() must call
+            // DetachCurrentThread() before it exits, the destructor of g_attachedKey does it.
             // see: http://developer.android.com/guide/practices/design/jni.html
-                
+
             if (jvm->AttachCurrentThread(&_env, nullptr) < 0)
                 {
                     LOGE("Failed to get the environment using AttachCurrentThread()");
@@ -102,6 +109,7 @@ namespace cocos2d {
                 } else {
                 // Success : Attached and obtained JNIEnv!
                 pthread_setspecific(g_key, _env);
+                pthread_setspecific(g_attachedKey, _env);
                 return _env;
             }
                 
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "base/CCEventKeyboard.h"
 #include "base/CCEventMouse.h"
 #include "base/CCIMEDispatcher.h"
+#include "renderer/ccGLStateCache.h"
 
 #include <unordered_map>
 
@@ -259,8 +260,12 @@ GLView::GLView()
 , _frameZoomFactor(1.0f)
 , _mainWindow(nullptr)
 , _monitor(nullptr)
+, _sharedContextWindow(nullptr)
 , _mouseX(0.0f)
 , _mouseY(0.0f)
+#if CC_USE_NULL_GL
+, _isNullGLReady(false)
+#endif
 {
     _viewName = "cocos2dx";
     g_keyCodeMap.clear();
@@ -271,15 +276,19 @@ GLView::GLView()
 
     GLFWEventHandler::setGLView(this);
 
+#if !CC_USE_NULL_GL
     glfwSetErrorCallback(GLFWEventHandler::onGLFWError);
     glfwInit();
+#endif
 }
 
 GLView::~GLView()
 {
     CCLOGINFO("deallocing GLView: %p", this);
     GLFWEventHandler::setGLView(nullptr);
+#if !CC_USE_NULL_GL
     glfwTerminate();
+#endif
 }
 
 GLView* GLView::create(const std::string& viewName)
@@ -333,6 +342,13 @@ bool GLView::initWithRect(const std::string& viewName, Rect rect, float frameZoo
 
     _frameZoomFactor = frameZoomFactor;
 
+#if CC_USE_NULL_GL
+    // no window nor context: GL calls are recorded by NullGL
+    _isNullGLReady = true;
+    setFrameSize(rect.size.width, rect.size.height);
+    return true;
+#endif
+
     glfwWindowHint(GLFW_RESIZABLE,GL_FALSE);
 
     _mainWindow = glfwCreateWindow(rect.size.width * _frameZoomFactor,
@@ -403,11 +419,18 @@ bool GLView::initWithFullscreen(const std::string &viewname, const GLFWvidmode &
 
 bool GLView::isOpenGLReady()
 {
+#if CC_USE_NULL_GL
+    return _isNullGLReady;
+#else
     return nullptr != _mainWindow;
+#endif
 }
 
 void GLView::end()
 {
+#if CC_USE_NULL_GL
+    _isNullGLReady = false;
+#endif
     if(_mainWindow)
     {
         glfwSetWindowShouldClose(_mainWindow,1);
@@ -417,14 +440,62 @@ void GLView::end()
     release();
 }
 
+bool GLView::createSharedContext()
+{
+#if CC_USE_NULL_GL
+    return false;
+#else
+    if (_sharedContextWindow)
+        return true;
+
+    if (!_mainWindow)
+        return false;
+
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    _sharedContextWindow = glfwCreateWindow(1, 1, "", nullptr, _mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
+
+    if (!_sharedContextWindow)
+    {
+        CCLOG("cocos2d: GLView: couldn't create a shared context");
+        return false;
+    }
+    return true;
+#endif
+}
+
+void GLView::makeSharedContextCurrent(bool current)
+{
+#if !CC_USE_NULL_GL
+    glfwMakeContextCurrent(current ? _sharedContextWindow : nullptr);
+#endif
+}
+
+void GLView::destroySharedContext()
+{
+#if !CC_USE_NULL_GL
+    if (_sharedContextWindow)
+    {
+        glfwDestroyWindow(_sharedContextWindow);
+        _sharedContextWindow = nullptr;
+    }
+#endif
+}
+
 void GLView::swapBuffers()
 {
+#if CC_USE_NULL_GL
+    NullGL::endFrame();
+#endif
     if(_mainWindow)
         glfwSwapBuffers(_mainWindow);
 }
 
 bool GLView::windowShouldClose()
 {
+#if CC_USE_NULL_GL
+    return !_isNullGLReady;
+#endif
     if(_mainWindow)
         return glfwWindowShouldClose(_mainWindow) ? true : false;
     else
@@ -433,7 +504,9 @@ bool GLView::windowShouldClose()
 
 void GLView::pollEvents()
 {
+#if !CC_USE_NULL_GL
     glfwPollEvents();
+#endif
 }
 
 
@@ -479,6 +552,9 @@ float GLView::getFrameZoomFactor()
 
 void GLView::updateFrameSize()
 {
+#if CC_USE_NULL_GL
+    return;
+#endif
     if (_screenSize.width > 0 && _screenSize.height > 0)
     {
         int w = 0, h = 0;
@@ -522,7 +598,7 @@ void GLView::setFrameSize(float width, float height)
 
 void GLView::setViewPortInPoints(float x , float y , float w , float h)
 {
-    glViewport((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
+    GL::viewport((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
                (GLint)(y * _scaleY * _retinaFactor  * _frameZoomFactor + _viewPortRect.origin.y * _retinaFactor * _frameZoomFactor),
                (GLsizei)(w * _scaleX * _retinaFactor * _frameZoomFactor),
                (GLsizei)(h * _scaleY * _retinaFactor * _frameZoomFactor));
@@ -530,7 +606,7 @@ void GLView::setViewPortInPoints(float x , float y , float w , float h)
 
 void GLView::setScissorInPoints(float x , float y , float w , float h)
 {
-    glScissor((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
+    GL::scissor((GLint)(x * _scaleX * _retinaFactor * _frameZoomFactor + _viewPortRect.origin.x * _retinaFactor * _frameZoomFactor),
                (GLint)(y * _scaleY * _retinaFactor  * _frameZoomFactor + _viewPortRect.origin.y * _retinaFactor * _frameZoomFactor),
                (GLsizei)(w * _scaleX * _retinaFactor * _frameZoomFactor),
                (GLsizei)(h * _scaleY * _retinaFactor * _frameZoomFactor));
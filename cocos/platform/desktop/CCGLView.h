@@ -64,6 +64,9 @@ public:
     virtual void swapBuffers() override;
     virtual void setFrameSize(float width, float height) override;
     virtual void setIMEKeyboardState(bool bOpen) override;
+    virtual bool createSharedContext() override;
+    virtual void makeSharedContextCurrent(bool current) override;
+    virtual void destroySharedContext() override;
 
     /*
      * Set zoom factor for frame. This method is for debugging big resolution (e.g.new ipad) app on desktop.
@@ -114,9 +117,17 @@ protected:
     GLFWwindow* _mainWindow;
     GLFWmonitor* _monitor;
 
+    // hidden window owning the context shared with the main one
+    GLFWwindow* _sharedContextWindow;
+
     float _mouseX;
     float _mouseY;
 
+#if CC_USE_NULL_GL
+    // the null GL backend has no window, this is set until end() is called
+    bool _isNullGLReady;
+#endif
+
     friend class GLFWEventHandler;
 
 private:
@@ -30,6 +30,10 @@ THE SOFTWARE.
 
 #include "GL/glew.h"
 
+#if CC_USE_NULL_GL
+#include "platform/linux/CCNullGL.h"
+#endif
+
 #define CC_GL_DEPTH24_STENCIL8		GL_DEPTH24_STENCIL8
 
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
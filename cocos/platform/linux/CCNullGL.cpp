@@ -0,0 +1,350 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/linux/CCNullGL.h"
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_NULL_GL
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+NS_CC_BEGIN
+
+NullGL::FrameStats NullGL::s_frameStats = { 0, 0, 0, 0, 0, 0 };
+NullGL::FrameStats NullGL::s_lastFrameStats = { 0, 0, 0, 0, 0, 0 };
+
+// GL objects only exist as names, buffers also remember their size so they can be mapped
+static GLuint s_lastName = 0;
+static std::unordered_map<GLenum, GLuint> s_boundBuffers;
+static std::unordered_map<GLuint, GLsizeiptr> s_bufferSizes;
+static std::vector<char> s_mappedMemory;
+static GLsizeiptr s_mappedSize = 0;
+static std::unordered_map<std::string, GLint> s_locations;
+
+static size_t getBytesPerPixel(GLenum format, GLenum type)
+{
+    switch (type)
+    {
+        case GL_UNSIGNED_SHORT_5_6_5:
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+            return 2;
+        default:
+            break;
+    }
+
+    switch (format)
+    {
+        case GL_RGBA:
+        case GL_BGRA:
+            return 4;
+        case GL_RGB:
+            return 3;
+        case GL_LUMINANCE_ALPHA:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+void NullGL::endFrame()
+{
+    s_lastFrameStats = s_frameStats;
+    memset(&s_frameStats, 0, sizeof(s_frameStats));
+}
+
+void NullGL::bindBuffer(GLenum target, GLuint buffer)
+{
+    stateChange();
+    s_boundBuffers[target] = buffer;
+}
+
+void NullGL::bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+    s_frameStats.calls++;
+    s_bufferSizes[s_boundBuffers[target]] = size;
+    if (data)
+        s_frameStats.uploadedBytes += size;
+}
+
+void NullGL::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+    s_frameStats.calls++;
+    s_frameStats.uploadedBytes += size;
+}
+
+GLvoid* NullGL::mapBuffer(GLenum target, GLenum access)
+{
+    return mapBufferRange(target, 0, s_bufferSizes[s_boundBuffers[target]], GL_MAP_WRITE_BIT);
+}
+
+GLvoid* NullGL::mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    s_frameStats.calls++;
+    if ((GLsizeiptr)s_mappedMemory.size() < length)
+        s_mappedMemory.resize(length);
+    s_mappedSize = length;
+    return s_mappedMemory.data();
+}
+
+GLboolean NullGL::unmapBuffer(GLenum target)
+{
+    // whatever was mapped is considered written
+    s_frameStats.calls++;
+    s_frameStats.uploadedBytes += s_mappedSize;
+    s_mappedSize = 0;
+    return GL_TRUE;
+}
+
+void NullGL::texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    s_frameStats.calls++;
+    if (pixels)
+        s_frameStats.uploadedBytes += width * height * getBytesPerPixel(format, type);
+}
+
+void NullGL::texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    s_frameStats.calls++;
+    s_frameStats.uploadedBytes += width * height * getBytesPerPixel(format, type);
+}
+
+void NullGL::compressedTexImage2D(GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data)
+{
+    s_frameStats.calls++;
+    s_frameStats.uploadedBytes += imageSize;
+}
+
+void NullGL::compressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const GLvoid* data)
+{
+    s_frameStats.calls++;
+    s_frameStats.uploadedBytes += imageSize;
+}
+
+void NullGL::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    s_frameStats.calls++;
+    s_frameStats.drawCalls++;
+    s_frameStats.drawnVertices += count;
+}
+
+void NullGL::drawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+    s_frameStats.calls++;
+    s_frameStats.drawCalls++;
+    s_frameStats.drawnVertices += count;
+}
+
+void NullGL::genNames(GLsizei n, GLuint* names)
+{
+    s_frameStats.calls++;
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        names[i] = ++s_lastName;
+    }
+}
+
+GLuint NullGL::createObject(GLenum type)
+{
+    s_frameStats.calls++;
+    return ++s_lastName;
+}
+
+GLboolean NullGL::isObject(GLuint name)
+{
+    s_frameStats.calls++;
+    return name != 0 ? GL_TRUE : GL_FALSE;
+}
+
+GLboolean NullGL::isEnabled(GLenum cap)
+{
+    s_frameStats.calls++;
+    return GL_FALSE;
+}
+
+GLsync NullGL::fenceSync(GLenum condition, GLbitfield flags)
+{
+    s_frameStats.calls++;
+    return (GLsync)(uintptr_t)(++s_lastName);
+}
+
+GLenum NullGL::clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    s_frameStats.calls++;
+    return GL_ALREADY_SIGNALED;
+}
+
+GLenum NullGL::checkFramebufferStatus(GLenum target)
+{
+    s_frameStats.calls++;
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+GLenum NullGL::getError()
+{
+    s_frameStats.calls++;
+    return GL_NO_ERROR;
+}
+
+const GLubyte* NullGL::getString(GLenum name)
+{
+    s_frameStats.calls++;
+    switch (name)
+    {
+        case GL_VENDOR:
+            return (const GLubyte*)"cocos2d-x";
+        case GL_RENDERER:
+            return (const GLubyte*)"Null GL";
+        case GL_VERSION:
+            return (const GLubyte*)"2.1 Null GL";
+        case GL_SHADING_LANGUAGE_VERSION:
+            return (const GLubyte*)"1.20";
+        case GL_EXTENSIONS:
+            // the extensions taking the fast paths of the renderer
+            return (const GLubyte*)"GL_ARB_vertex_array_object GL_ARB_map_buffer_range GL_ARB_sync GL_ARB_framebuffer_object GL_ARB_texture_non_power_of_two";
+        default:
+            return (const GLubyte*)"";
+    }
+}
+
+void NullGL::getIntegerv(GLenum pname, GLint* params)
+{
+    s_frameStats.calls++;
+    switch (pname)
+    {
+        case GL_MAX_TEXTURE_SIZE:
+            params[0] = 4096;
+            break;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_VERTEX_ATTRIBS:
+            params[0] = 16;
+            break;
+        case GL_VIEWPORT:
+        case GL_SCISSOR_BOX:
+            params[0] = params[1] = params[2] = params[3] = 0;
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+void NullGL::getFloatv(GLenum pname, GLfloat* params)
+{
+    s_frameStats.calls++;
+    switch (pname)
+    {
+        case GL_COLOR_CLEAR_VALUE:
+        case GL_VIEWPORT:
+            params[0] = params[1] = params[2] = params[3] = 0;
+            break;
+        case GL_DEPTH_RANGE:
+        case GL_ALIASED_LINE_WIDTH_RANGE:
+        case GL_ALIASED_POINT_SIZE_RANGE:
+            params[0] = params[1] = 1;
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+void NullGL::getBooleanv(GLenum pname, GLboolean* params)
+{
+    s_frameStats.calls++;
+    if (pname == GL_COLOR_WRITEMASK)
+        params[0] = params[1] = params[2] = params[3] = GL_TRUE;
+    else
+        params[0] = GL_FALSE;
+}
+
+void NullGL::getShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    s_frameStats.calls++;
+    *params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+void NullGL::getProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    // programs have no active attributes nor uniforms, but the built-in locations are still found
+    s_frameStats.calls++;
+    *params = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+}
+
+void NullGL::getText(GLuint object, GLsizei bufSize, GLsizei* length, GLchar* text)
+{
+    s_frameStats.calls++;
+    if (length)
+        *length = 0;
+    if (text && bufSize > 0)
+        text[0] = '\0';
+}
+
+GLint NullGL::getLocation(GLuint program, const GLchar* name)
+{
+    // the same name gets the same location in every program
+    s_frameStats.calls++;
+    auto it = s_locations.find(name);
+    if (it != s_locations.end())
+        return it->second;
+
+    GLint location = (GLint)s_locations.size();
+    s_locations[name] = location;
+    return location;
+}
+
+void NullGL::getActiveVariable(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    getText(program, bufSize, length, name);
+    *size = 0;
+    *type = 0;
+}
+
+void NullGL::getAttachedShaders(GLuint program, GLsizei maxCount, GLsizei* count, GLuint* shaders)
+{
+    s_frameStats.calls++;
+    if (count)
+        *count = 0;
+}
+
+void NullGL::getShaderPrecisionFormat(GLenum shaderType, GLenum precisionType, GLint* range, GLint* precision)
+{
+    s_frameStats.calls++;
+    range[0] = range[1] = 127;
+    *precision = 23;
+}
+
+void NullGL::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels)
+{
+    s_frameStats.calls++;
+    memset(pixels, 0, width * height * getBytesPerPixel(format, type));
+}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_NULL_GL
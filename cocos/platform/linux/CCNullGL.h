@@ -0,0 +1,448 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCNULLGL_H__
+#define __CCNULLGL_H__
+
+#include "base/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_NULL_GL
+
+#include <cstddef>
+#include "GL/glew.h"
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/** @brief A GL backend that doesn't render anything.
+
+ When cocos2d-x is built with USE_NULL_GL, every GL entry point used by the engine is routed
+ to NullGL, which records the call and returns plausible values: names for generated objects,
+ successful compile/link/framebuffer status, scratch memory for mapped buffers.
+ Together with the windowless GLView of that build, the CPU side of the engine (scene traversal,
+ command generation, batching, state caching) can run and be profiled on machines without a GPU.
+ */
+class CC_DLL NullGL
+{
+public:
+    struct FrameStats
+    {
+        /** every GL call */
+        unsigned int calls;
+        /** glDrawArrays and glDrawElements calls */
+        unsigned int drawCalls;
+        /** vertices (or indices) sent by the draw calls */
+        unsigned int drawnVertices;
+        /** binds, enables, blend/depth/stencil state, vertex attributes, viewport and scissor */
+        unsigned int stateChanges;
+        /** glUniform* calls */
+        unsigned int uniformUpdates;
+        /** bytes sent with glBufferData, glBufferSubData, mapped buffers and texture uploads */
+        size_t uploadedBytes;
+    };
+
+    /** returns the counters of the last completed frame */
+    static const FrameStats& getLastFrameStats() { return s_lastFrameStats; }
+    /** returns the counters of the frame being recorded */
+    static const FrameStats& getFrameStats() { return s_frameStats; }
+    /** ends the frame being recorded. Called by GLView::swapBuffers */
+    static void endFrame();
+
+    // entry points. Use the gl* functions instead
+
+    template <typename... Args>
+    static void call(Args&&...) { s_frameStats.calls++; }
+    template <typename... Args>
+    static void stateChange(Args&&...) { s_frameStats.calls++; s_frameStats.stateChanges++; }
+    template <typename... Args>
+    static void uniform(Args&&...) { s_frameStats.calls++; s_frameStats.uniformUpdates++; }
+
+    static void bindBuffer(GLenum target, GLuint buffer);
+    static void bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+    static void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+    static GLvoid* mapBuffer(GLenum target, GLenum access);
+    static GLvoid* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+    static GLboolean unmapBuffer(GLenum target);
+
+    static void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels);
+    static void texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels);
+    static void compressedTexImage2D(GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data);
+    static void compressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const GLvoid* data);
+
+    static void drawArrays(GLenum mode, GLint first, GLsizei count);
+    static void drawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices);
+
+    static void genNames(GLsizei n, GLuint* names);
+    static GLuint createObject(GLenum type = 0);
+    static GLboolean isObject(GLuint name);
+    static GLboolean isEnabled(GLenum cap);
+    static GLsync fenceSync(GLenum condition, GLbitfield flags);
+    static GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+    static GLenum checkFramebufferStatus(GLenum target);
+
+    static GLenum getError();
+    static const GLubyte* getString(GLenum name);
+    static void getIntegerv(GLenum pname, GLint* params);
+    static void getFloatv(GLenum pname, GLfloat* params);
+    static void getBooleanv(GLenum pname, GLboolean* params);
+    static void getShaderiv(GLuint shader, GLenum pname, GLint* params);
+    static void getProgramiv(GLuint program, GLenum pname, GLint* params);
+    static void getText(GLuint object, GLsizei bufSize, GLsizei* length, GLchar* text);
+    static GLint getLocation(GLuint program, const GLchar* name);
+    static void getActiveVariable(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+    static void getAttachedShaders(GLuint program, GLsizei maxCount, GLsizei* count, GLuint* shaders);
+    static void getShaderPrecisionFormat(GLenum shaderType, GLenum precisionType, GLint* range, GLint* precision);
+    static void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels);
+
+    template <typename A, typename B, typename T>
+    static void getParameter(A, B, T* params) { s_frameStats.calls++; *params = T(); }
+    template <typename A, typename B, typename C, typename T>
+    static void getParameter(A, B, C, T* params) { s_frameStats.calls++; *params = T(); }
+
+private:
+    static FrameStats s_frameStats;
+    static FrameStats s_lastFrameStats;
+};
+
+NS_CC_END
+
+#undef glActiveTexture
+#define glActiveTexture(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glAlphaFunc
+#define glAlphaFunc(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glAttachShader
+#define glAttachShader(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBindAttribLocation
+#define glBindAttribLocation(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBindBuffer
+#define glBindBuffer(...) cocos2d::NullGL::bindBuffer(__VA_ARGS__)
+#undef glBindFramebuffer
+#define glBindFramebuffer(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBindRenderbuffer
+#define glBindRenderbuffer(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBindTexture
+#define glBindTexture(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBindVertexArray
+#define glBindVertexArray(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBlendColor
+#define glBlendColor(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBlendEquation
+#define glBlendEquation(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBlendEquationSeparate
+#define glBlendEquationSeparate(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBlendFunc
+#define glBlendFunc(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBlendFuncSeparate
+#define glBlendFuncSeparate(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glBufferData
+#define glBufferData(...) cocos2d::NullGL::bufferData(__VA_ARGS__)
+#undef glBufferSubData
+#define glBufferSubData(...) cocos2d::NullGL::bufferSubData(__VA_ARGS__)
+#undef glCheckFramebufferStatus
+#define glCheckFramebufferStatus(...) cocos2d::NullGL::checkFramebufferStatus(__VA_ARGS__)
+#undef glClear
+#define glClear(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glClearColor
+#define glClearColor(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glClearDepth
+#define glClearDepth(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glClearDepthf
+#define glClearDepthf(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glClearStencil
+#define glClearStencil(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glClientWaitSync
+#define glClientWaitSync(...) cocos2d::NullGL::clientWaitSync(__VA_ARGS__)
+#undef glColorMask
+#define glColorMask(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glCompileShader
+#define glCompileShader(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glCompressedTexImage2D
+#define glCompressedTexImage2D(...) cocos2d::NullGL::compressedTexImage2D(__VA_ARGS__)
+#undef glCompressedTexSubImage2D
+#define glCompressedTexSubImage2D(...) cocos2d::NullGL::compressedTexSubImage2D(__VA_ARGS__)
+#undef glCopyTexImage2D
+#define glCopyTexImage2D(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glCopyTexSubImage2D
+#define glCopyTexSubImage2D(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glCreateProgram
+#define glCreateProgram(...) cocos2d::NullGL::createObject(__VA_ARGS__)
+#undef glCreateShader
+#define glCreateShader(...) cocos2d::NullGL::createObject(__VA_ARGS__)
+#undef glCullFace
+#define glCullFace(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glDeleteBuffers
+#define glDeleteBuffers(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glDeleteFramebuffers
+#define glDeleteFramebuffers(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glDeleteProgram
+#define glDeleteProgram(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glDeleteRenderbuffers
+#define glDeleteRenderbuffers(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glDeleteShader
+#define glDeleteShader(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glDeleteSync
+#define glDeleteSync(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glDeleteTextures
+#define glDeleteTextures(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glDeleteVertexArrays
+#define glDeleteVertexArrays(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glDepthFunc
+#define glDepthFunc(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glDepthMask
+#define glDepthMask(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glDepthRange
+#define glDepthRange(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glDepthRangef
+#define glDepthRangef(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glDetachShader
+#define glDetachShader(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glDisable
+#define glDisable(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glDisableClientState
+#define glDisableClientState(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glDisableVertexAttribArray
+#define glDisableVertexAttribArray(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glDrawArrays
+#define glDrawArrays(...) cocos2d::NullGL::drawArrays(__VA_ARGS__)
+#undef glDrawElements
+#define glDrawElements(...) cocos2d::NullGL::drawElements(__VA_ARGS__)
+#undef glEnable
+#define glEnable(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glEnableClientState
+#define glEnableClientState(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glEnableVertexAttribArray
+#define glEnableVertexAttribArray(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glFenceSync
+#define glFenceSync(...) cocos2d::NullGL::fenceSync(__VA_ARGS__)
+#undef glFinish
+#define glFinish(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glFlush
+#define glFlush(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glFramebufferRenderbuffer
+#define glFramebufferRenderbuffer(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glFramebufferTexture2D
+#define glFramebufferTexture2D(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glFrontFace
+#define glFrontFace(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glGenBuffers
+#define glGenBuffers(...) cocos2d::NullGL::genNames(__VA_ARGS__)
+#undef glGenFramebuffers
+#define glGenFramebuffers(...) cocos2d::NullGL::genNames(__VA_ARGS__)
+#undef glGenRenderbuffers
+#define glGenRenderbuffers(...) cocos2d::NullGL::genNames(__VA_ARGS__)
+#undef glGenTextures
+#define glGenTextures(...) cocos2d::NullGL::genNames(__VA_ARGS__)
+#undef glGenVertexArrays
+#define glGenVertexArrays(...) cocos2d::NullGL::genNames(__VA_ARGS__)
+#undef glGenerateMipmap
+#define glGenerateMipmap(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glGetActiveAttrib
+#define glGetActiveAttrib(...) cocos2d::NullGL::getActiveVariable(__VA_ARGS__)
+#undef glGetActiveUniform
+#define glGetActiveUniform(...) cocos2d::NullGL::getActiveVariable(__VA_ARGS__)
+#undef glGetAttachedShaders
+#define glGetAttachedShaders(...) cocos2d::NullGL::getAttachedShaders(__VA_ARGS__)
+#undef glGetAttribLocation
+#define glGetAttribLocation(...) cocos2d::NullGL::getLocation(__VA_ARGS__)
+#undef glGetBooleanv
+#define glGetBooleanv(...) cocos2d::NullGL::getBooleanv(__VA_ARGS__)
+#undef glGetBufferParameteriv
+#define glGetBufferParameteriv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetError
+#define glGetError(...) cocos2d::NullGL::getError(__VA_ARGS__)
+#undef glGetFloatv
+#define glGetFloatv(...) cocos2d::NullGL::getFloatv(__VA_ARGS__)
+#undef glGetFramebufferAttachmentParameteriv
+#define glGetFramebufferAttachmentParameteriv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetIntegerv
+#define glGetIntegerv(...) cocos2d::NullGL::getIntegerv(__VA_ARGS__)
+#undef glGetProgramInfoLog
+#define glGetProgramInfoLog(...) cocos2d::NullGL::getText(__VA_ARGS__)
+#undef glGetProgramiv
+#define glGetProgramiv(...) cocos2d::NullGL::getProgramiv(__VA_ARGS__)
+#undef glGetRenderbufferParameteriv
+#define glGetRenderbufferParameteriv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetShaderInfoLog
+#define glGetShaderInfoLog(...) cocos2d::NullGL::getText(__VA_ARGS__)
+#undef glGetShaderPrecisionFormat
+#define glGetShaderPrecisionFormat(...) cocos2d::NullGL::getShaderPrecisionFormat(__VA_ARGS__)
+#undef glGetShaderSource
+#define glGetShaderSource(...) cocos2d::NullGL::getText(__VA_ARGS__)
+#undef glGetShaderiv
+#define glGetShaderiv(...) cocos2d::NullGL::getShaderiv(__VA_ARGS__)
+#undef glGetString
+#define glGetString(...) cocos2d::NullGL::getString(__VA_ARGS__)
+#undef glGetTexLevelParameteriv
+#define glGetTexLevelParameteriv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetTexParameterfv
+#define glGetTexParameterfv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetTexParameteriv
+#define glGetTexParameteriv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetUniformLocation
+#define glGetUniformLocation(...) cocos2d::NullGL::getLocation(__VA_ARGS__)
+#undef glGetUniformfv
+#define glGetUniformfv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetUniformiv
+#define glGetUniformiv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetVertexAttribPointerv
+#define glGetVertexAttribPointerv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetVertexAttribfv
+#define glGetVertexAttribfv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glGetVertexAttribiv
+#define glGetVertexAttribiv(...) cocos2d::NullGL::getParameter(__VA_ARGS__)
+#undef glHint
+#define glHint(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glIsBuffer
+#define glIsBuffer(...) cocos2d::NullGL::isObject(__VA_ARGS__)
+#undef glIsEnabled
+#define glIsEnabled(...) cocos2d::NullGL::isEnabled(__VA_ARGS__)
+#undef glIsFramebuffer
+#define glIsFramebuffer(...) cocos2d::NullGL::isObject(__VA_ARGS__)
+#undef glIsProgram
+#define glIsProgram(...) cocos2d::NullGL::isObject(__VA_ARGS__)
+#undef glIsRenderbuffer
+#define glIsRenderbuffer(...) cocos2d::NullGL::isObject(__VA_ARGS__)
+#undef glIsShader
+#define glIsShader(...) cocos2d::NullGL::isObject(__VA_ARGS__)
+#undef glIsTexture
+#define glIsTexture(...) cocos2d::NullGL::isObject(__VA_ARGS__)
+#undef glLineWidth
+#define glLineWidth(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glLinkProgram
+#define glLinkProgram(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glMapBuffer
+#define glMapBuffer(...) cocos2d::NullGL::mapBuffer(__VA_ARGS__)
+#undef glMapBufferRange
+#define glMapBufferRange(...) cocos2d::NullGL::mapBufferRange(__VA_ARGS__)
+#undef glPixelStorei
+#define glPixelStorei(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glPointSize
+#define glPointSize(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glPolygonOffset
+#define glPolygonOffset(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glReadPixels
+#define glReadPixels(...) cocos2d::NullGL::readPixels(__VA_ARGS__)
+#undef glReleaseShaderCompiler
+#define glReleaseShaderCompiler(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glRenderbufferStorage
+#define glRenderbufferStorage(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glSampleCoverage
+#define glSampleCoverage(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glScissor
+#define glScissor(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glShaderBinary
+#define glShaderBinary(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glShaderSource
+#define glShaderSource(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glStencilFunc
+#define glStencilFunc(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glStencilFuncSeparate
+#define glStencilFuncSeparate(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glStencilMask
+#define glStencilMask(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glStencilMaskSeparate
+#define glStencilMaskSeparate(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glStencilOp
+#define glStencilOp(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glStencilOpSeparate
+#define glStencilOpSeparate(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glTexImage2D
+#define glTexImage2D(...) cocos2d::NullGL::texImage2D(__VA_ARGS__)
+#undef glTexParameterf
+#define glTexParameterf(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glTexParameterfv
+#define glTexParameterfv(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glTexParameteri
+#define glTexParameteri(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glTexParameteriv
+#define glTexParameteriv(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glTexSubImage2D
+#define glTexSubImage2D(...) cocos2d::NullGL::texSubImage2D(__VA_ARGS__)
+#undef glUniform1f
+#define glUniform1f(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform1fv
+#define glUniform1fv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform1i
+#define glUniform1i(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform1iv
+#define glUniform1iv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform2f
+#define glUniform2f(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform2fv
+#define glUniform2fv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform2i
+#define glUniform2i(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform2iv
+#define glUniform2iv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform3f
+#define glUniform3f(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform3fv
+#define glUniform3fv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform3i
+#define glUniform3i(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform3iv
+#define glUniform3iv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform4f
+#define glUniform4f(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform4fv
+#define glUniform4fv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform4i
+#define glUniform4i(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniform4iv
+#define glUniform4iv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniformMatrix2fv
+#define glUniformMatrix2fv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniformMatrix3fv
+#define glUniformMatrix3fv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUniformMatrix4fv
+#define glUniformMatrix4fv(...) cocos2d::NullGL::uniform(__VA_ARGS__)
+#undef glUnmapBuffer
+#define glUnmapBuffer(...) cocos2d::NullGL::unmapBuffer(__VA_ARGS__)
+#undef glUseProgram
+#define glUseProgram(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glValidateProgram
+#define glValidateProgram(...) cocos2d::NullGL::call(__VA_ARGS__)
+#undef glVertexAttrib1f
+#define glVertexAttrib1f(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glVertexAttrib1fv
+#define glVertexAttrib1fv(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glVertexAttrib2f
+#define glVertexAttrib2f(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glVertexAttrib2fv
+#define glVertexAttrib2fv(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glVertexAttrib3f
+#define glVertexAttrib3f(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glVertexAttrib3fv
+#define glVertexAttrib3fv(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glVertexAttrib4f
+#define glVertexAttrib4f(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glVertexAttrib4fv
+#define glVertexAttrib4fv(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glVertexAttribPointer
+#define glVertexAttribPointer(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+#undef glViewport
+#define glViewport(...) cocos2d::NullGL::stateChange(__VA_ARGS__)
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_NULL_GL
+
+#endif // __CCNULLGL_H__
@@ -32,6 +32,7 @@
 NS_CC_BEGIN
 
 class TextureAtlas;
+class Texture2D;
 
 class BatchCommand : public RenderCommand
 {
@@ -44,6 +45,8 @@ public:
 
     void execute();
 
+    inline Texture2D* getTexture() const { return _texture; }
+
 protected:
     //Material
     int32_t _materialID;
@@ -0,0 +1,549 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCDynamicAtlas.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+#include "2d/CCSpriteFrame.h"
+#include "platform/CCImage.h"
+#include "platform/CCFileUtils.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const int BORDER = 1;
+}
+
+DynamicAtlas::DynamicAtlas(TextureCache* textureCache)
+: _textureCache(textureCache)
+, _enabled(false)
+, _pageSize(1024)
+, _maxImageSize(256)
+{
+}
+
+DynamicAtlas::~DynamicAtlas()
+{
+    removeAllImages();
+}
+
+void DynamicAtlas::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+void DynamicAtlas::setPageSize(int pageSize)
+{
+    CCASSERT(pageSize > 2 * BORDER, "Invalid page size");
+    _pageSize = pageSize;
+
+    // the biggest image, with its border, must fit in an empty page
+    if (_maxImageSize + 2 * BORDER > _pageSize)
+    {
+        CCLOG("cocos2d: DynamicAtlas: max image size reduced to %d to fit in %d pixel pages", _pageSize - 2 * BORDER, _pageSize);
+        _maxImageSize = _pageSize - 2 * BORDER;
+    }
+}
+
+void DynamicAtlas::setMaxImageSize(int maxImageSize)
+{
+    CCASSERT(maxImageSize > 0, "Invalid image size");
+    CCASSERT(maxImageSize + 2 * BORDER <= _pageSize, "Images must fit in a page, with their border");
+    _maxImageSize = std::min(maxImageSize, _pageSize - 2 * BORDER);
+}
+
+SpriteFrame* DynamicAtlas::addImage(const std::string& filepath)
+{
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filepath);
+    if (fullpath.empty())
+        return nullptr;
+
+    auto it = _entries.find(fullpath);
+    if (it != _entries.end())
+        return it->second.frame;
+
+    Texture2D* texture = _textureCache->getTextureForKey(fullpath);
+
+    // images already loaded as textures are not duplicated into a page
+    if (_enabled && !texture)
+    {
+        Image* image = new Image();
+        if (!image->initWithImageFile(fullpath))
+        {
+            image->release();
+            return nullptr;
+        }
+
+        if (packImage(fullpath, image))
+        {
+            image->release();
+            return _entries[fullpath].frame;
+        }
+
+        // hand the decoded image to the cache, so the file isn't read twice
+        texture = _textureCache->addImage(image, fullpath);
+        image->release();
+    }
+
+    if (!texture)
+        texture = _textureCache->addImage(fullpath);
+
+    if (!texture)
+        return nullptr;
+
+    return SpriteFrame::createWithTexture(texture, Rect(0, 0, texture->getContentSize().width, texture->getContentSize().height));
+}
+
+SpriteFrame* DynamicAtlas::getSpriteFrame(const std::string& filepath) const
+{
+    auto it = _entries.find(filepath);
+    if (it == _entries.end())
+        it = _entries.find(FileUtils::getInstance()->fullPathForFilename(filepath));
+
+    return it != _entries.end() ? it->second.frame : nullptr;
+}
+
+bool DynamicAtlas::removeImage(const std::string& filepath)
+{
+    auto it = _entries.find(filepath);
+    if (it == _entries.end())
+        it = _entries.find(FileUtils::getInstance()->fullPathForFilename(filepath));
+
+    if (it == _entries.end())
+        return false;
+
+    removeEntry(it);
+    return true;
+}
+
+void DynamicAtlas::removeUnusedPages()
+{
+    auto pages = _pages;
+    for (auto page : pages)
+        reclaimReleasedRects(page);
+
+    pages = _pages;
+    for (auto page : pages)
+    {
+        // each frame retains the page, anything above that is a sprite or a frame still in use
+        unsigned int frames = 0;
+        bool unused = true;
+        for (auto& entry : _entries)
+        {
+            if (entry.second.page != page)
+                continue;
+
+            frames++;
+            if (entry.second.frame->getReferenceCount() > 1)
+            {
+                unused = false;
+                break;
+            }
+        }
+
+        if (!unused || page->texture->getReferenceCount() > 1 + frames)
+            continue;
+
+        CCLOG("cocos2d: DynamicAtlas: removing unused page with %u images", frames);
+
+        for (auto it = _entries.begin(); it != _entries.end(); /* nothing */)
+        {
+            if (it->second.page == page)
+            {
+                it->second.frame->release();
+                it = _entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        removePage(page);
+    }
+}
+
+void DynamicAtlas::removeAllImages()
+{
+    for (auto& entry : _entries)
+        entry.second.frame->release();
+    _entries.clear();
+
+    while (!_pages.empty())
+        removePage(_pages.back());
+}
+
+bool DynamicAtlas::isPageTexture(Texture2D* texture) const
+{
+    for (auto page : _pages)
+    {
+        if (page->texture == texture)
+            return true;
+    }
+    return false;
+}
+
+float DynamicAtlas::getOccupancy() const
+{
+    double used = 0;
+    double total = 0;
+    for (auto page : _pages)
+    {
+        used += page->usedPixels;
+        total += (double)page->size * page->size;
+    }
+    return total > 0 ? (float)(used / total) : 0.0f;
+}
+
+int DynamicAtlas::getBatchesSaved() const
+{
+    return std::max(0, getImageCount() - getPageCount());
+}
+
+std::string DynamicAtlas::getDescription() const
+{
+    std::string buffer;
+    char buftmp[4096];
+
+    unsigned int totalBytes = 0;
+
+    for (size_t i = 0; i < _pages.size(); ++i)
+    {
+        Page* page = _pages[i];
+        auto bytes = page->size * page->size * 4;
+        totalBytes += bytes;
+
+        snprintf(buftmp, sizeof(buftmp)-1, "\"DynamicAtlas page %ld\" rc=%lu id=%lu %lu x %lu @ 32 bpp => %lu KB, %ld images, %.1f%% used\n",
+                 (long)i,
+                 (long)page->texture->getReferenceCount(),
+                 (long)page->texture->getName(),
+                 (long)page->size,
+                 (long)page->size,
+                 (long)bytes / 1024,
+                 (long)(page->usedRects.size() - page->releasedRects.size()),
+                 100.0f * page->usedPixels / ((float)page->size * page->size));
+
+        buffer += buftmp;
+    }
+
+    snprintf(buftmp, sizeof(buftmp)-1, "DynamicAtlas: %s, %ld pages, %ld images, %.1f%% occupancy, up to %ld batches saved, for %lu KB (%.2f MB)\n",
+             _enabled ? "enabled" : "disabled",
+             (long)getPageCount(),
+             (long)getImageCount(),
+             100.0f * getOccupancy(),
+             (long)getBatchesSaved(),
+             (long)totalBytes / 1024,
+             totalBytes / (1024.0f*1024.0f));
+    buffer += buftmp;
+
+    return buffer;
+}
+
+DynamicAtlas::Page* DynamicAtlas::createPage()
+{
+    int size = std::min(_pageSize, Configuration::getInstance()->getMaxTextureSize());
+
+    // the pixels are premultiplied while copied, like the PNG loader does
+    std::vector<unsigned char> pixels(size * size * 4, 0);
+    Image* image = new Image();
+    if (!image->initWithRawData(pixels.data(), pixels.size(), size, size, 8, true))
+    {
+        image->release();
+        return nullptr;
+    }
+
+    Texture2D* texture = new Texture2D();
+    if (!texture->initWithImage(image, Texture2D::PixelFormat::RGBA8888))
+    {
+        texture->release();
+        image->release();
+        return nullptr;
+    }
+
+    Page* page = new Page();
+    page->texture = texture;
+    page->size = size;
+    page->freeRects.push_back({0, 0, size, size});
+    page->usedPixels = 0;
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the pages are restored from their copy after a context loss
+    VolatileTextureMgr::addImage(texture, image);
+    page->image = image;
+#else
+    image->release();
+    page->image = nullptr;
+#endif
+
+    _pages.push_back(page);
+    return page;
+}
+
+void DynamicAtlas::removePage(Page* page)
+{
+    _pages.erase(std::find(_pages.begin(), _pages.end(), page));
+
+    page->texture->release();
+    CC_SAFE_RELEASE(page->image);
+    delete page;
+}
+
+bool DynamicAtlas::insertRect(Page* page, int width, int height, PackRect* outRect) const
+{
+    // best short side fit
+    int bestShortSide = INT_MAX;
+    int bestLongSide = INT_MAX;
+
+    for (const auto& free : page->freeRects)
+    {
+        if (free.width < width || free.height < height)
+            continue;
+
+        int leftoverX = free.width - width;
+        int leftoverY = free.height - height;
+        int shortSide = std::min(leftoverX, leftoverY);
+        int longSide = std::max(leftoverX, leftoverY);
+
+        if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+        {
+            *outRect = {free.x, free.y, width, height};
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+        }
+    }
+
+    return bestShortSide != INT_MAX;
+}
+
+void DynamicAtlas::splitFreeRects(std::vector<PackRect>& freeRects, const PackRect& used)
+{
+    std::vector<PackRect> result;
+    result.reserve(freeRects.size() + 4);
+
+    for (const auto& free : freeRects)
+    {
+        if (used.x >= free.x + free.width || used.x + used.width <= free.x ||
+            used.y >= free.y + free.height || used.y + used.height <= free.y)
+        {
+            result.push_back(free);
+            continue;
+        }
+
+        // keep the maximal free rectangles around the used one, they may overlap each other
+        if (used.y > free.y)
+            result.push_back({free.x, free.y, free.width, used.y - free.y});
+        if (used.y + used.height < free.y + free.height)
+            result.push_back({free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height});
+        if (used.x > free.x)
+            result.push_back({free.x, free.y, used.x - free.x, free.height});
+        if (used.x + used.width < free.x + free.width)
+            result.push_back({used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height});
+    }
+
+    // drop the rectangles contained by another one
+    freeRects.clear();
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        const auto& a = result[i];
+        bool contained = false;
+        for (size_t j = 0; j < result.size() && !contained; ++j)
+        {
+            if (i == j)
+                continue;
+
+            const auto& b = result[j];
+            bool inside = a.x >= b.x && a.y >= b.y && a.x + a.width <= b.x + b.width && a.y + a.height <= b.y + b.height;
+            // of two identical rectangles, keep the first one
+            bool identical = a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+            contained = inside && (!identical || j < i);
+        }
+
+        if (!contained)
+            freeRects.push_back(a);
+    }
+}
+
+void DynamicAtlas::placeRect(Page* page, const PackRect& rect)
+{
+    splitFreeRects(page->freeRects, rect);
+    page->usedRects.push_back(rect);
+}
+
+bool DynamicAtlas::reclaimReleasedRects(Page* page)
+{
+    if (page->releasedRects.empty())
+        return false;
+
+    // each frame of the page retains its texture, anything above that may still display a released region
+    unsigned int frames = 0;
+    for (auto& entry : _entries)
+    {
+        if (entry.second.page == page)
+            frames++;
+    }
+    if (page->texture->getReferenceCount() > 1 + frames)
+        return false;
+
+    for (const auto& rect : page->releasedRects)
+    {
+        auto it = std::find_if(page->usedRects.begin(), page->usedRects.end(), [&](const PackRect& used){
+            return used.x == rect.x && used.y == rect.y;
+        });
+        if (it != page->usedRects.end())
+            page->usedRects.erase(it);
+
+        page->usedPixels -= (rect.width - 2 * BORDER) * (rect.height - 2 * BORDER);
+    }
+    page->releasedRects.clear();
+
+    if (page->usedRects.empty())
+    {
+        removePage(page);
+        return true;
+    }
+
+    // rebuild the free list from scratch, so the released areas merge with their free neighbours
+    page->freeRects.clear();
+    page->freeRects.push_back({0, 0, page->size, page->size});
+    for (const auto& used : page->usedRects)
+        splitFreeRects(page->freeRects, used);
+
+    return false;
+}
+
+bool DynamicAtlas::packImage(const std::string& fullpath, Image* image)
+{
+    int width = image->getWidth();
+    int height = image->getHeight();
+    if (width > _maxImageSize || height > _maxImageSize)
+        return false;
+
+    auto format = image->getRenderFormat();
+    if (image->isCompressed() || (format != Texture2D::PixelFormat::RGBA8888 && format != Texture2D::PixelFormat::RGB888))
+        return false;
+
+    int paddedWidth = width + 2 * BORDER;
+    int paddedHeight = height + 2 * BORDER;
+
+    // a new page would be created for nothing, e.g. when the pages are clamped to the max texture size
+    int pageSize = std::min(_pageSize, Configuration::getInstance()->getMaxTextureSize());
+    if (paddedWidth > pageSize || paddedHeight > pageSize)
+        return false;
+
+    auto pages = _pages;
+    for (auto candidate : pages)
+        reclaimReleasedRects(candidate);
+
+    Page* page = nullptr;
+    PackRect rect;
+    for (auto candidate : _pages)
+    {
+        if (insertRect(candidate, paddedWidth, paddedHeight, &rect))
+        {
+            page = candidate;
+            break;
+        }
+    }
+
+    if (!page)
+    {
+        page = createPage();
+        if (!page || !insertRect(page, paddedWidth, paddedHeight, &rect))
+            return false;
+    }
+
+    placeRect(page, rect);
+
+    // copy the image with its edges repeated in the border
+    int srcBpp = format == Texture2D::PixelFormat::RGBA8888 ? 4 : 3;
+    bool premultiply = srcBpp == 4 && !image->isPremultipliedAlpha();
+    const unsigned char* src = image->getData();
+
+    std::vector<unsigned char> pixels(paddedWidth * paddedHeight * 4);
+    for (int y = 0; y < paddedHeight; ++y)
+    {
+        int srcY = std::min(std::max(y - BORDER, 0), height - 1);
+        for (int x = 0; x < paddedWidth; ++x)
+        {
+            int srcX = std::min(std::max(x - BORDER, 0), width - 1);
+            const unsigned char* s = src + (srcY * width + srcX) * srcBpp;
+            unsigned char* d = &pixels[(y * paddedWidth + x) * 4];
+
+            if (srcBpp == 3)
+            {
+                d[0] = s[0]; d[1] = s[1]; d[2] = s[2]; d[3] = 255;
+            }
+            else if (premultiply)
+            {
+                unsigned int a = s[3];
+                d[0] = (unsigned char)(s[0] * a / 255);
+                d[1] = (unsigned char)(s[1] * a / 255);
+                d[2] = (unsigned char)(s[2] * a / 255);
+                d[3] = (unsigned char)a;
+            }
+            else
+            {
+                d[0] = s[0]; d[1] = s[1]; d[2] = s[2]; d[3] = s[3];
+            }
+        }
+    }
+
+    page->texture->updateWithData(pixels.data(), rect.x, rect.y, paddedWidth, paddedHeight);
+
+    if (page->image)
+    {
+        unsigned char* dst = page->image->getData();
+        for (int y = 0; y < paddedHeight; ++y)
+            memcpy(dst + ((rect.y + y) * page->size + rect.x) * 4, &pixels[y * paddedWidth * 4], paddedWidth * 4);
+    }
+
+    Rect rectInPixels((float)(rect.x + BORDER), (float)(rect.y + BORDER), (float)width, (float)height);
+    SpriteFrame* frame = SpriteFrame::createWithTexture(page->texture, CC_RECT_PIXELS_TO_POINTS(rectInPixels));
+    frame->retain();
+
+    _entries[fullpath] = {frame, page, rect};
+    page->usedPixels += width * height;
+
+    return true;
+}
+
+void DynamicAtlas::removeEntry(std::unordered_map<std::string, Entry>::iterator it)
+{
+    Page* page = it->second.page;
+    page->releasedRects.push_back(it->second.rect);
+
+    it->second.frame->release();
+    _entries.erase(it);
+
+    reclaimReleasedRects(page);
+}
+
+NS_CC_END
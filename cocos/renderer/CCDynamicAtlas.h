@@ -0,0 +1,163 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCDYNAMICATLAS_H__
+#define __CCDYNAMICATLAS_H__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class Texture2D;
+class TextureCache;
+class SpriteFrame;
+class Image;
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @brief Packs small loose images into shared textures at runtime, so sprites using them can be batched together.
+
+ Images are packed with a MaxRects packer into RGBA8888 pages and returned as SpriteFrames pointing inside the page.
+ Each image gets a 1 pixel border made of its own edges, so linear filtering doesn't bleed the neighbours in.
+ Images bigger than the max image size, or in a format that can't be copied into a page (compressed, A8...),
+ are loaded by the TextureCache as usual and returned as a frame covering the whole texture.
+
+ The atlas is owned by the TextureCache and is disabled by default.
+ @since v3.2
+ */
+class CC_DLL DynamicAtlas
+{
+public:
+    explicit DynamicAtlas(TextureCache* textureCache);
+    ~DynamicAtlas();
+
+    /** Enables or disables the packing. When disabled, addImage() returns frames covering the TextureCache textures */
+    void setEnabled(bool enabled);
+    inline bool isEnabled() const { return _enabled; }
+
+    /** Sets the size in pixels of the pages created from now on. Defaults to 1024, clamped to the max texture size.
+     * The max image size is reduced if the images wouldn't fit in a page anymore.
+     */
+    void setPageSize(int pageSize);
+    inline int getPageSize() const { return _pageSize; }
+
+    /** Sets the largest width or height in pixels of the images that are packed. Defaults to 256.
+     * Images must fit in a page with their 1 pixel border, so it is clamped to the page size minus 2.
+     */
+    void setMaxImageSize(int maxImageSize);
+    inline int getMaxImageSize() const { return _maxImageSize; }
+
+    /** Returns a frame for the image file, packing the image into a page if it wasn't already.
+     * The frame of a packed image is shared, like the ones of the SpriteFrameCache.
+     */
+    SpriteFrame* addImage(const std::string& filepath);
+
+    /** Returns the frame of a packed image, or nullptr if the image isn't in the atlas */
+    SpriteFrame* getSpriteFrame(const std::string& filepath) const;
+
+    /** Releases the region of a packed image so new images can reuse it.
+     * The sprites still displaying the image retain the page: the region is only reused once the page texture is
+     * retained by the atlas alone, so their pixels are never overwritten. Returns false if the image isn't in the atlas.
+     */
+    bool removeImage(const std::string& filepath);
+
+    /** Removes the pages whose frames and texture are only retained by the atlas */
+    void removeUnusedPages();
+
+    /** Removes all the images and pages */
+    void removeAllImages();
+
+    /** Whether the texture is one of the pages */
+    bool isPageTexture(Texture2D* texture) const;
+
+    /** Number of pages */
+    inline int getPageCount() const { return (int)_pages.size(); }
+
+    /** Number of packed images */
+    inline int getImageCount() const { return (int)_entries.size(); }
+
+    /** Ratio between the pixels used by images and the pixels of all the pages */
+    float getOccupancy() const;
+
+    /** Upper bound of the draw calls saved: the images that would each need their own texture, minus the pages */
+    int getBatchesSaved() const;
+
+    /** Returns one line per page plus a summary line, in the format of TextureCache::getCachedTextureInfo() */
+    std::string getDescription() const;
+
+protected:
+    struct PackRect
+    {
+        int x, y, width, height;
+    };
+
+    struct Page
+    {
+        Texture2D* texture;
+        Image* image;   // copy of the pixels, only kept when textures have to be restored after a context loss
+        int size;
+        std::vector<PackRect> freeRects;
+        std::vector<PackRect> usedRects;
+        std::vector<PackRect> releasedRects;    // used by removed images, until nothing else retains the page
+        int usedPixels;
+    };
+
+    struct Entry
+    {
+        SpriteFrame* frame;
+        Page* page;
+        PackRect rect;  // includes the border
+    };
+
+    Page* createPage();
+    void removePage(Page* page);
+    bool insertRect(Page* page, int width, int height, PackRect* outRect) const;
+    static void splitFreeRects(std::vector<PackRect>& freeRects, const PackRect& used);
+    void placeRect(Page* page, const PackRect& rect);
+    bool reclaimReleasedRects(Page* page);
+    bool packImage(const std::string& fullpath, Image* image);
+    void removeEntry(std::unordered_map<std::string, Entry>::iterator it);
+
+    TextureCache* _textureCache;
+    bool _enabled;
+    int _pageSize;
+    int _maxImageSize;
+
+    std::vector<Page*> _pages;
+    std::unordered_map<std::string, Entry> _entries;
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif //__CCDYNAMICATLAS_H__
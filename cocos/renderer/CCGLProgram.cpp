@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/uthash.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgramBinaryCache.h"
 #include "platform/CCFileUtils.h"
 #include "CCGL.h"
 
@@ -138,13 +139,16 @@ _inputLayout(nullptr)
 , _constantBufferVS(nullptr)
 , _constantBufferPS(nullptr)
 , _program(++s_programCount)
+, _uniformsStateId(0)
 , _uniformDirtyVS(true)
 , _uniformDirtyPS(true)
 #else
 _program(0)
+, _uniformsStateId(0)
 , _vertShader(0)
 , _fragShader(0)
 , _hashForUniforms(nullptr)
+, _loadedFromBinary(false)
 , _flags()
 #endif
 {
@@ -294,6 +298,24 @@ bool GLProgram::initWithByteArrays(const std::string& vShaderByteArray, const st
     CHECK_GL_ERROR_DEBUG();
 
     _vertShader = _fragShader = 0;
+    _hashForUniforms = nullptr;
+
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    auto binaryCache = GLProgramBinaryCache::getInstance();
+    _binaryKey.clear();
+    _loadedFromBinary = false;
+    if (binaryCache->isEnabled())
+    {
+        _binaryKey = binaryCache->getProgramKey(vShaderByteArray, fShaderByteArray);
+        if (binaryCache->loadProgram(_program, _binaryKey))
+        {
+            // the binary is already linked, there is nothing to compile
+            _loadedFromBinary = true;
+            return true;
+        }
+        binaryCache->prepareProgram(_program);
+    }
+#endif
 
     if (vShaderByteArray)
     {
@@ -324,7 +346,6 @@ bool GLProgram::initWithByteArrays(const std::string& vShaderByteArray, const st
     {
         glAttachShader(_program, _fragShader);
     }
-    _hashForUniforms = nullptr;
     
     CHECK_GL_ERROR_DEBUG();
 #endif
@@ -649,6 +670,16 @@ bool GLProgram::link()
 #if (DIRECTX_ENABLED == 0)
     GLint status = GL_TRUE;
 
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    if (_loadedFromBinary)
+    {
+        // glProgramBinary linked it with the attribute locations bound when the binary was saved
+        parseVertexAttribs();
+        parseUniforms();
+        return true;
+    }
+#endif
+
     bindPredefinedVertexAttribs();
 
     glLinkProgram(_program);
@@ -656,6 +687,13 @@ bool GLProgram::link()
     parseVertexAttribs();
     parseUniforms();
 
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    if (!_binaryKey.empty())
+    {
+        GLProgramBinaryCache::getInstance()->saveProgram(_program, _binaryKey);
+    }
+#endif
+
     if (_vertShader)
     {
         glDeleteShader(_vertShader);
@@ -1217,8 +1255,12 @@ void GLProgram::setUniformsForBuiltins(const Mat4 &matrixMV, bool transposed)
 
 void GLProgram::reset()
 {
+    _uniformsStateId = 0;
+
 #if (DIRECTX_ENABLED == 0)
     _vertShader = _fragShader = 0;
+    _binaryKey.clear();
+    _loadedFromBinary = false;
     memset(_builtInUniforms, 0, sizeof(_builtInUniforms));
 
     // it is already deallocated by android
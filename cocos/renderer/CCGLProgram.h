@@ -352,6 +352,9 @@ protected:
 
 	GLuint            _program;
 
+    // id of the GLProgramState whose uniform values the program holds, 0 if none
+    unsigned int      _uniformsStateId;
+
 #if (DIRECTX_ENABLED == 1)
 	ID3D11InputLayout*	_inputLayout;
 	ID3D11VertexShader* _vertexShader;
@@ -377,6 +380,10 @@ protected:
     GLint             _builtInUniforms[UNIFORM_MAX];
     struct _hashUniformEntry* _hashForUniforms;
 	bool              _hasShaderCompiler;
+
+    // key of the program in the GLProgramBinaryCache, empty if it is not cached
+    std::string       _binaryKey;
+    bool              _loadedFromBinary;
         
     struct flag_struct {
         unsigned int usesTime:1;
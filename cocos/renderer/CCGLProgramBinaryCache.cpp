@@ -0,0 +1,226 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCGLProgramBinaryCache.h"
+
+#include <stdio.h>
+#include <memory>
+#include <vector>
+
+#include "base/CCConfiguration.h"
+#include "base/CCThreadPool.h"
+#include "base/ccMacros.h"
+#include "platform/CCFileUtils.h"
+#include "deprecated/CCString.h"
+#include "xxhash.h"
+
+NS_CC_BEGIN
+
+extern const char* cocos2dVersion();
+
+namespace
+{
+    // every binary starts with this header
+    struct ProgramBinaryHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    const char PROGRAM_BINARY_MAGIC[4] = { 'C', 'C', 'P', 'B' };
+    const uint32_t PROGRAM_BINARY_VERSION = 1;
+}
+
+static GLProgramBinaryCache* s_sharedProgramBinaryCache = nullptr;
+
+GLProgramBinaryCache* GLProgramBinaryCache::getInstance()
+{
+    if (!s_sharedProgramBinaryCache)
+    {
+        s_sharedProgramBinaryCache = new GLProgramBinaryCache();
+    }
+
+    return s_sharedProgramBinaryCache;
+}
+
+void GLProgramBinaryCache::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedProgramBinaryCache);
+}
+
+GLProgramBinaryCache::GLProgramBinaryCache()
+: _supported(false)
+, _enabled(false)
+, _hits(0)
+, _misses(0)
+{
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    if (Configuration::getInstance()->supportsProgramBinary())
+    {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        _supported = formats > 0;
+    }
+
+    if (_supported)
+    {
+        _driverDescription = StringUtils::format("%s|%s|%s|%s",
+                                                 (const char*)glGetString(GL_VENDOR),
+                                                 (const char*)glGetString(GL_RENDERER),
+                                                 (const char*)glGetString(GL_VERSION),
+                                                 cocos2dVersion());
+    }
+#endif
+    _enabled = _supported;
+}
+
+void GLProgramBinaryCache::setEnabled(bool enabled)
+{
+    _enabled = enabled && _supported;
+}
+
+std::string GLProgramBinaryCache::getProgramKey(const std::string& vertSource, const std::string& fragSource) const
+{
+    return StringUtils::format("%08x%08x%08x",
+                               XXH32(vertSource.c_str(), (int)vertSource.size(), 0),
+                               XXH32(fragSource.c_str(), (int)fragSource.size(), 0),
+                               XXH32(_driverDescription.c_str(), (int)_driverDescription.size(), 0));
+}
+
+std::string GLProgramBinaryCache::getProgramPath(const std::string& key) const
+{
+    return FileUtils::getInstance()->getWritablePath() + "ccprogram_" + key + ".bin";
+}
+
+bool GLProgramBinaryCache::loadProgram(GLuint program, const std::string& key)
+{
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    if (!_enabled)
+        return false;
+
+    std::string path = getProgramPath(key);
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(path))
+    {
+        _misses++;
+        return false;
+    }
+
+    Data data = fileUtils->getDataFromFile(path);
+    auto header = (const ProgramBinaryHeader*)data.getBytes();
+    bool valid = data.getSize() >= (ssize_t)sizeof(ProgramBinaryHeader)
+        && memcmp(header->magic, PROGRAM_BINARY_MAGIC, sizeof(PROGRAM_BINARY_MAGIC)) == 0
+        && header->version == PROGRAM_BINARY_VERSION
+        && data.getSize() == (ssize_t)(sizeof(ProgramBinaryHeader) + header->length);
+
+    if (valid)
+    {
+        glProgramBinary(program, header->format, data.getBytes() + sizeof(ProgramBinaryHeader), header->length);
+
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        valid = (status == GL_TRUE);
+    }
+
+    if (!valid)
+    {
+        // the driver changed in a way the key doesn't catch, or the file is damaged
+        CCLOG("cocos2d: GLProgramBinaryCache: discarding invalid binary %s", path.c_str());
+        remove(path.c_str());
+        _misses++;
+        return false;
+    }
+
+    _hits++;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void GLProgramBinaryCache::prepareProgram(GLuint program)
+{
+#if CC_ENABLE_PROGRAM_BINARY_CACHE && defined(GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+    if (_enabled)
+    {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
+}
+
+bool GLProgramBinaryCache::saveProgram(GLuint program, const std::string& key)
+{
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    if (!_enabled || !program)
+        return false;
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (status != GL_TRUE || length <= 0)
+        return false;
+
+    auto buffer = std::make_shared<std::vector<unsigned char>>(sizeof(ProgramBinaryHeader) + length);
+    auto header = (ProgramBinaryHeader*)buffer->data();
+    memcpy(header->magic, PROGRAM_BINARY_MAGIC, sizeof(PROGRAM_BINARY_MAGIC));
+    header->version = PROGRAM_BINARY_VERSION;
+
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, buffer->data() + sizeof(ProgramBinaryHeader));
+    if (written <= 0)
+        return false;
+
+    header->format = format;
+    header->length = written;
+    buffer->resize(sizeof(ProgramBinaryHeader) + written);
+
+    // programs made of the same sources share a key, so each one writes its own temporary file
+    std::string path = getProgramPath(key);
+    std::string tempPath = StringUtils::format("%s.%u", path.c_str(), program);
+    ThreadPool::getInstance()->pushTask([=](){
+        FILE* fp = fopen(tempPath.c_str(), "wb");
+        if (!fp)
+            return;
+
+        bool done = fwrite(buffer->data(), 1, buffer->size(), fp) == buffer->size();
+        fclose(fp);
+
+        // the rename makes sure a binary is never read half written
+        if (!done || rename(tempPath.c_str(), path.c_str()) != 0)
+        {
+            remove(tempPath.c_str());
+        }
+    });
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+NS_CC_END
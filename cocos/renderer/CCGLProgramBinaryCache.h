@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCGLPROGRAMBINARYCACHE_H__
+#define __CCGLPROGRAMBINARYCACHE_H__
+
+#include <string>
+
+#include "base/CCPlatformMacros.h"
+#include "CCGL.h"
+
+// Android and desktop GL can save linked programs with the get_program_binary extension
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) && (DIRECTX_ENABLED == 0)
+#define CC_ENABLE_PROGRAM_BINARY_CACHE 1
+#else
+#define CC_ENABLE_PROGRAM_BINARY_CACHE 0
+#endif
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup shaders
+ * @{
+ */
+
+/** @brief Stores linked GL programs on disk, so they don't have to be compiled again on the next run.
+
+ The binaries live in the writable path. They are keyed by the hash of the shader sources plus the
+ driver and engine versions, so a driver update simply misses the cache and the programs are compiled again.
+ Binaries rejected by the driver are removed.
+ */
+class CC_DLL GLProgramBinaryCache
+{
+public:
+    /** Returns the shared cache. It must be created once the GL context exists */
+    static GLProgramBinaryCache* getInstance();
+
+    /** Destroys the shared cache. The binaries stay on disk */
+    static void destroyInstance();
+
+    /** Whether the driver can save and load program binaries */
+    inline bool isSupported() const { return _supported; }
+
+    /** Enables or disables the cache. It is enabled by default when the driver supports it */
+    void setEnabled(bool enabled);
+    inline bool isEnabled() const { return _enabled; }
+
+    /** Returns the key of the program made of these sources */
+    std::string getProgramKey(const std::string& vertSource, const std::string& fragSource) const;
+
+    /** Loads the binary stored for `key` into `program`, which is linked once it returns true */
+    bool loadProgram(GLuint program, const std::string& key);
+
+    /** Asks the driver to keep the binary of `program` retrievable. Call it before linking the program */
+    void prepareProgram(GLuint program);
+
+    /** Stores the binary of `program` for `key` if the program is linked. The file is written on a worker thread */
+    bool saveProgram(GLuint program, const std::string& key);
+
+    /** Returns how many programs were loaded from their binary */
+    inline unsigned int getHits() const { return _hits; }
+
+    /** Returns how many programs had no valid binary and were compiled */
+    inline unsigned int getMisses() const { return _misses; }
+
+protected:
+    GLProgramBinaryCache();
+
+    std::string getProgramPath(const std::string& key) const;
+
+    std::string _driverDescription;
+    bool _supported;
+    bool _enabled;
+    unsigned int _hits;
+    unsigned int _misses;
+};
+
+// end of shaders group
+/// @}
+
+NS_CC_END
+
+#endif // __CCGLPROGRAMBINARYCACHE_H__
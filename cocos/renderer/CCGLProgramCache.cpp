@@ -30,6 +30,9 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccShaders.h"
 #include "base/ccMacros.h"
+#include "base/CCProfiling.h"
+
+#include <chrono>
 
 NS_CC_BEGIN
 
@@ -76,6 +79,8 @@ void GLProgramCache::destroyInstance()
 
 GLProgramCache::GLProgramCache()
 : _programs()
+, _buildTime(0)
+, _builtProgramsCount(0)
 {
 
 }
@@ -97,205 +102,56 @@ bool GLProgramCache::init()
 
 void GLProgramCache::loadDefaultGLPrograms()
 {
-    // Position Texture Color shader
-    GLProgram *p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, p ) );
-
-    // Position Texture Color without MVP shader
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, p ) );
-
-    // Position Texture Color alpha test
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST, p) );
-
-    // Position Texture Color alpha test
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV, p) );
-    //
-    // Position, Color shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR, p) );
-
-    //
-    // Position, Color shader no MVP
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP, p) );
-
-    //
-    // Position Texture shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE, p) );
-
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR, p) );
-
-    //
-    // Position Texture A8 Color shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR, p) );
-
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_U_COLOR, p) );
-    
-    //
-	// Position, Legth(TexCoords, Color (used by Draw Node basically )
-	//
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_NORMAL, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_OUTLINE, p) );
-    
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPosition);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION, p) );
+    // the programs are only registered here, getGLProgram() builds them the first time they are used
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR] = kShaderType_PositionTextureColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP] = kShaderType_PositionTextureColor_noMVP;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST] = kShaderType_PositionTextureColorAlphaTest;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV] = kShaderType_PositionTextureColorAlphaTestNoMV;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_COLOR] = kShaderType_PositionColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP] = kShaderType_PositionColor_noMVP;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE] = kShaderType_PositionTexture;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR] = kShaderType_PositionTexture_uColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR] = kShaderType_PositionTextureA8Color;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_U_COLOR] = kShaderType_Position_uColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR] = kShaderType_PositionLengthTexureColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL] = kShaderType_LabelDistanceFieldNormal;
+    _defaultPrograms[GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW] = kShaderType_LabelDistanceFieldGlow;
+    _defaultPrograms[GLProgram::SHADER_NAME_LABEL_NORMAL] = kShaderType_LabelNormal;
+    _defaultPrograms[GLProgram::SHADER_NAME_LABEL_OUTLINE] = kShaderType_LabelOutline;
+    _defaultPrograms[GLProgram::SHADER_3D_POSITION] = kShaderType_3DPosition;
+    _defaultPrograms[GLProgram::SHADER_3D_POSITION_TEXTURE] = kShaderType_3DPositionTex;
+    _defaultPrograms[GLProgram::SHADER_3D_SKINPOSITION_TEXTURE] = kShaderType_3DSkinPositionTex;
+}
 
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPositionTex);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_TEXTURE, p) );
-    
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE, p));
+void GLProgramCache::compileDefaultGLPrograms()
+{
+    for (const auto& program : _defaultPrograms)
+    {
+        getGLProgram(program.first);
+    }
 }
 
 void GLProgramCache::reloadDefaultGLPrograms()
 {
-    // reset all programs and reload them
-    
-    // Position Texture Color shader
-    GLProgram *p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR);    
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-
-    // Position Texture Color without MVP shader
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-    
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    //
-    // Position, Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-    
-    //
-    // Position, Color shader no MVP
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP);
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-
-    //
-    // Position Texture shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-    
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-    
-    //
-    // Position Texture A8 Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-    
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-    
-    //
-	// Position, Legth(TexCoords, Color (used by Draw Node basically )
-	//
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPosition);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionTex);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
+    // reset the default programs that were built and reload them,
+    // the others will be built the first time they are used
+    for (const auto& program : _defaultPrograms)
+    {
+        auto it = _programs.find(program.first);
+        if (it == _programs.end())
+            continue;
+
+        GLProgram* p = it->second;
+        p->reset();
+        loadDefaultGLProgram(p, program.second);
+    }
 }
 
 void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
 {
+    CC_PROFILER_START("GLProgramCache - loadDefaultGLProgram");
+    auto startTime = std::chrono::steady_clock::now();
+
 #if (DIRECTX_ENABLED == 1)
 #define INIT_SHADERS initWithHLSL
 #else
@@ -362,6 +218,7 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
             break;
         default:
             CCLOG("cocos2d: %s:%d, error shader type", __FUNCTION__, __LINE__);
+            CC_PROFILER_STOP("GLProgramCache - loadDefaultGLProgram");
             return;
     }
     
@@ -369,6 +226,11 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
     p->updateUniforms();
     
     CHECK_GL_ERROR_DEBUG();
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+    _buildTime += duration.count() / 1000.0f;
+    _builtProgramsCount++;
+    CC_PROFILER_STOP("GLProgramCache - loadDefaultGLProgram");
 }
 
 GLProgram* GLProgramCache::getGLProgram(const std::string &key)
@@ -376,6 +238,17 @@ GLProgram* GLProgramCache::getGLProgram(const std::string &key)
     auto it = _programs.find(key);
     if( it != _programs.end() )
         return it->second;
+
+    // default programs are built on their first lookup
+    auto defaultIt = _defaultPrograms.find(key);
+    if (defaultIt != _defaultPrograms.end())
+    {
+        GLProgram *p = new GLProgram();
+        loadDefaultGLProgram(p, defaultIt->second);
+        _programs.insert( std::make_pair(key, p) );
+        return p;
+    }
+
     return nullptr;
 }
 
@@ -383,6 +256,13 @@ void GLProgramCache::addGLProgram(GLProgram* program, const std::string &key)
 {
     if (program)
         program->retain();
+
+    auto it = _programs.find(key);
+    if (it != _programs.end())
+        CC_SAFE_RELEASE(it->second);
+
+    // a program added by the game replaces the default one, which must not be built or reloaded anymore
+    _defaultPrograms.erase(key);
     
     _programs[key] = program;
 }
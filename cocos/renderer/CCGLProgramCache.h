@@ -65,10 +65,15 @@ public:
     /** purges the cache. It releases the retained instance. */
     static void destroyInstance();
 
-    /** loads the default shaders */
+    /** registers the default shaders. Each one is compiled the first time getGLProgram() returns it */
     void loadDefaultGLPrograms();
 
-    /** reload the default shaders */
+    /** compiles the default shaders that were not used yet, i.e. during a loading screen
+     @since v3.2
+     */
+    void compileDefaultGLPrograms();
+
+    /** reload the default shaders that were compiled */
     void reloadDefaultGLPrograms();
 
     /** returns a GL program for a given key 
@@ -78,12 +83,27 @@ public:
     /** adds a GLProgram to the cache for a given name */
     void addGLProgram(GLProgram* program, const std::string &key);
 
+    /** returns how many default programs were built, from their sources or from their binary
+     @since v3.2
+     */
+    inline int getBuiltProgramsCount() const { return _builtProgramsCount; }
+
+    /** returns the time spent building the default programs, in milliseconds
+     @since v3.2
+     */
+    inline float getBuildTime() const { return _buildTime; }
+
 private:
     bool init();
     void loadDefaultGLProgram(GLProgram *program, int type);
 
 //    Dictionary* _programs;
     std::unordered_map<std::string, GLProgram*> _programs;
+    // default programs that can be built on demand, by name
+    std::unordered_map<std::string, int> _defaultPrograms;
+
+    float _buildTime;
+    int _builtProgramsCount;
 };
 
 // end of shaders group
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
 #include "base/CCDirector.h"
+#include "xxhash.h"
 
 NS_CC_BEGIN
 
@@ -48,6 +49,8 @@ NS_CC_BEGIN
 
 UniformValue::UniformValue()
 : _useCallback(false)
+, _batchSafeCallback(false)
+, _dirty(true)
 , _uniform(nullptr)
 , _glprogram(nullptr)
 {
@@ -55,6 +58,8 @@ UniformValue::UniformValue()
 
 UniformValue::UniformValue(Uniform *uniform, GLProgram* glprogram)
 : _useCallback(false)
+, _batchSafeCallback(false)
+, _dirty(true)
 , _uniform(uniform)
 , _glprogram(glprogram)
 {
@@ -117,7 +122,47 @@ void UniformValue::apply()
     }
 }
 
-void UniformValue::setCallback(const std::function<void(GLProgram*, Uniform*)> &callback)
+uint32_t UniformValue::getHash() const
+{
+    // the location is the seed, so that the same value set to different uniforms hashes differently
+    unsigned int seed = (unsigned int)_uniform->location;
+
+    // a batch safe callback sets the same value for everybody: only its presence matters
+    if (_useCallback)
+        return XXH32(&_batchSafeCallback, sizeof(_batchSafeCallback), seed ^ 0x9E3779B1);
+
+    size_t size = 0;
+    switch (_uniform->type) {
+        case GL_SAMPLER_2D:
+            size = sizeof(_value.tex);
+            break;
+        case GL_INT:
+            size = sizeof(_value.intValue);
+            break;
+        case GL_FLOAT:
+            size = sizeof(_value.floatValue);
+            break;
+        case GL_FLOAT_VEC2:
+            size = sizeof(_value.v2Value);
+            break;
+        case GL_FLOAT_VEC3:
+            size = sizeof(_value.v3Value);
+            break;
+        case GL_FLOAT_VEC4:
+            size = sizeof(_value.v4Value);
+            break;
+        case GL_FLOAT_MAT4:
+            size = sizeof(_value.matrixValue);
+            break;
+        default:
+            size = sizeof(_value);
+            break;
+    }
+
+    return XXH32(&_value, (int)size, seed);
+}
+
+void UniformValue::setCallback(const std::function<void(GLProgram*, Uniform*)> &callback, bool batchSafe)
 {
 	// delete previously set callback
 	// XXX TODO: memory will leak if the user does:
@@ -130,6 +175,13 @@ void UniformValue::setCallback(const std::function<void(GLProgram*, Uniform*)> &
 	*_value.callback = callback;
 
     _useCallback = true;
+    _batchSafeCallback = batchSafe;
+    _dirty = true;
+}
+
+bool UniformValue::isVolatile() const
+{
+    return _useCallback || _uniform->type == GL_SAMPLER_2D;
 }
 
 void UniformValue::setFloat(float value)
@@ -137,6 +189,7 @@ void UniformValue::setFloat(float value)
     CCASSERT (_uniform->type == GL_FLOAT, "");
     _value.floatValue = value;
     _useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setTexture(GLuint textureId, GLuint textureUnit)
@@ -145,12 +198,14 @@ void UniformValue::setTexture(GLuint textureId, GLuint textureUnit)
     _value.tex.textureId = textureId;
     _value.tex.textureUnit = textureUnit;
     _useCallback = false;
+    _dirty = true;
 }
 void UniformValue::setInt(int value)
 {
     CCASSERT(_uniform->type == GL_INT, "Wrong type: expecting GL_INT");
     _value.intValue = value;
     _useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setVec2(const Vec2& value)
@@ -158,6 +213,7 @@ void UniformValue::setVec2(const Vec2& value)
     CCASSERT (_uniform->type == GL_FLOAT_VEC2, "");
 	memcpy(_value.v2Value, &value, sizeof(_value.v2Value));
     _useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setVec3(const Vec3& value)
@@ -165,6 +221,7 @@ void UniformValue::setVec3(const Vec3& value)
     CCASSERT (_uniform->type == GL_FLOAT_VEC3, "");
 	memcpy(_value.v3Value, &value, sizeof(_value.v3Value));
 	_useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setVec4(const Vec4& value)
@@ -172,6 +229,7 @@ void UniformValue::setVec4(const Vec4& value)
     CCASSERT (_uniform->type == GL_FLOAT_VEC4, "");
 	memcpy(_value.v4Value, &value, sizeof(_value.v4Value));
 	_useCallback = false;
+    _dirty = true;
 }
 
 void UniformValue::setMat4(const Mat4& value)
@@ -179,6 +237,7 @@ void UniformValue::setMat4(const Mat4& value)
     CCASSERT(_uniform->type == GL_FLOAT_MAT4, "");
 	memcpy(_value.matrixValue, &value, sizeof(_value.matrixValue));
 	_useCallback = false;
+    _dirty = true;
 }
 
 //
@@ -281,11 +340,19 @@ GLProgramState* GLProgramState::getOrCreateWithGLProgram(GLProgram *glprogram)
     return ret;
 }
 
+static unsigned int s_lastGLProgramStateId = 0;
+
 GLProgramState::GLProgramState()
 : _vertexAttribsFlags(0)
 , _glprogram(nullptr)
 , _textureUnitIndex(1)
 , _uniformAttributeValueDirty(true)
+, _uniformsBatchable(true)
+, _uniformsHash(0)
+, _uniformsDirty(true)
+, _hasVolatileUniforms(false)
+, _id(++s_lastGLProgramStateId)
+, _uniformsGeneration(0)
 {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
     // listen the event when app go to foreground
@@ -316,12 +383,15 @@ bool GLProgramState::init(GLProgram* glprogram)
         _attributes[attrib.first] = value;
     }
 
+    // no callback is set yet, so the values can be copied into place
+    _uniforms.reserve(_glprogram->_userUniforms.size());
     for(auto &uniform : _glprogram->_userUniforms) {
-        UniformValue value(&uniform.second, _glprogram);
-        _uniforms[uniform.second.location] = value;
-        _uniformsByName[uniform.first] = uniform.second.location;
+        _uniformsByName[uniform.first] = (int)_uniforms.size();
+        _uniforms.push_back(UniformValue(&uniform.second, _glprogram));
     }
 #endif
+    updateUniformsHash();
+    _uniformsDirty = true;
 
     return true;
 }
@@ -330,9 +400,27 @@ void GLProgramState::resetGLProgram()
 {
     CC_SAFE_RELEASE(_glprogram);
     _uniforms.clear();
+    _uniformsByName.clear();
     _attributes.clear();
+    _boundTextureUnits.clear();
     // first texture is GL_TEXTURE1
     _textureUnitIndex = 1;
+    updateUniformsHash();
+    // the handles of the previous program are not valid anymore
+    _uniformsGeneration++;
+}
+
+void GLProgramState::updateUniformsHash()
+{
+    // computed on the cocos2d thread when a uniform changes: the workers visiting the scene in parallel only read it.
+    // The iteration order of _uniforms is not stable, so the per uniform hashes are summed up
+    _uniformsHash = 0;
+    _uniformsBatchable = true;
+    for (const auto& uniform : _uniforms)
+    {
+        _uniformsHash += uniform.getHash();
+        _uniformsBatchable = _uniformsBatchable && uniform.isBatchable();
+    }
 }
 
 void GLProgramState::apply(const Mat4& modelView)
@@ -353,10 +441,14 @@ void GLProgramState::applyGLProgram(const Mat4& modelView)
 #if DIRECTX_ENABLED == 0
 	if (_uniformAttributeValueDirty)
     {
-        for(auto& uniformLocation : _uniformsByName)
+        for(auto& uniformIndex : _uniformsByName)
         {
-            _uniforms[uniformLocation.second]._uniform = _glprogram->getUniform(uniformLocation.first);
+            auto& value = _uniforms[uniformIndex.second];
+            value._uniform = _glprogram->getUniform(uniformIndex.first);
+            value._dirty = true;
         }
+        updateUniformsHash();
+        _uniformsDirty = true;
         
         _vertexAttribsFlags = 0;
         for(auto& attributeValue : _attributes)
@@ -394,10 +486,25 @@ void GLProgramState::applyAttributes(bool applyAttribFlags)
 }
 void GLProgramState::applyUniforms()
 {
-    // set uniforms
+    // the program keeps the values of the last state that applied its uniforms
+    bool programHasValues = (_glprogram->_uniformsStateId == _id);
+    if (programHasValues && !_uniformsDirty && !_hasVolatileUniforms)
+        return;
+
+    // set the uniforms that changed, or all of them if another state used the program since
+    _hasVolatileUniforms = false;
     for(auto& uniform : _uniforms) {
-        uniform.second.apply();
+        bool isVolatile = uniform.isVolatile();
+        if (!programHasValues || uniform._dirty || isVolatile)
+        {
+            uniform.apply();
+            uniform._dirty = false;
+        }
+        _hasVolatileUniforms = _hasVolatileUniforms || isVolatile;
     }
+
+    _glprogram->_uniformsStateId = _id;
+    _uniformsDirty = false;
 }
 
 void GLProgramState::setGLProgram(GLProgram *glprogram)
@@ -412,9 +519,12 @@ void GLProgramState::setGLProgram(GLProgram *glprogram)
 
 UniformValue* GLProgramState::getUniformValue(GLint uniformLocation)
 {
-    const auto itr = _uniforms.find(uniformLocation);
-    if( itr != _uniforms.end())
-        return &itr->second;
+    // there are a few uniforms, a linear search is cheaper than hashing
+    for (auto& uniform : _uniforms)
+    {
+        if (uniform._uniform->location == uniformLocation)
+            return &uniform;
+    }
     return nullptr;
 }
 
@@ -426,6 +536,26 @@ UniformValue* GLProgramState::getUniformValue(const std::string &name)
     return nullptr;
 }
 
+UniformValue* GLProgramState::getUniformValue(const UniformHandle &handle)
+{
+    if (handle._generation != _uniformsGeneration || handle._index < 0 || handle._index >= (int)_uniforms.size())
+    {
+        CCASSERT(false, "Invalid UniformHandle: it belongs to another GLProgram");
+        return nullptr;
+    }
+    return &_uniforms[handle._index];
+}
+
+UniformHandle GLProgramState::getUniformHandle(const std::string &uniformName) const
+{
+    const auto itr = _uniformsByName.find(uniformName);
+    if (itr != _uniformsByName.end())
+        return UniformHandle(itr->second, _uniformsGeneration);
+
+    CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
+    return UniformHandle();
+}
+
 VertexAttribValue* GLProgramState::getVertexAttribValue(const std::string &name)
 {
     const auto itr = _attributes.find(name);
@@ -463,11 +593,15 @@ void GLProgramState::setVertexAttribPointer(const std::string &name, GLint size,
 
 // Uniform Setters
 
-void GLProgramState::setUniformCallback(const std::string &uniformName, const std::function<void(GLProgram*, Uniform*)> &callback)
+void GLProgramState::setUniformCallback(const std::string &uniformName, const std::function<void(GLProgram*, Uniform*)> &callback, bool batchSafe)
 {
     auto v = getUniformValue(uniformName);
     if (v)
-        v->setCallback(callback);
+    {
+        v->setCallback(callback, batchSafe);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -476,7 +610,11 @@ void GLProgramState::setUniformFloat(const std::string &uniformName, float value
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setFloat(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -485,7 +623,11 @@ void GLProgramState::setUniformInt(const std::string &uniformName, int value)
 {
     auto v = getUniformValue(uniformName);
     if(v)
+    {
         v->setInt(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -494,7 +636,11 @@ void GLProgramState::setUniformVec2(const std::string &uniformName, const Vec2&
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setVec2(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -503,7 +649,11 @@ void GLProgramState::setUniformVec3(const std::string &uniformName, const Vec3&
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setVec3(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -512,7 +662,11 @@ void GLProgramState::setUniformVec4(const std::string &uniformName, const Vec4&
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setVec4(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -521,7 +675,11 @@ void GLProgramState::setUniformMat4(const std::string &uniformName, const Mat4&
 {
     auto v = getUniformValue(uniformName);
     if (v)
+    {
         v->setMat4(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
     else
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
 }
@@ -552,21 +710,9 @@ void GLProgramState::setUniformTexture(const std::string &uniformName, GLuint te
 #endif
     auto v = getUniformValue(uniformName);
     if (v)
-    {
-        if (_boundTextureUnits.find(uniformName) != _boundTextureUnits.end())
-        {
-            v->setTexture(textureId, _boundTextureUnits[uniformName]);
-        }
-        else
-        {
-            v->setTexture(textureId, _textureUnitIndex);
-            _boundTextureUnits[uniformName] = _textureUnitIndex++;
-        }
-    }
+        setUniformTexture(v, textureId);
     else
-    {
         CCLOG("cocos2d: warning: Uniform not found: %s", uniformName.c_str());
-    }
 }
 
 void GLProgramState::setUniformTexture(GLint uniformLocation, GLuint textureId)
@@ -576,21 +722,120 @@ void GLProgramState::setUniformTexture(GLint uniformLocation, GLuint textureId)
 #endif
     auto v = getUniformValue(uniformLocation);
     if (v)
+        setUniformTexture(v, textureId);
+    else
+        CCLOG("cocos2d: warning: Uniform at location not found: %i", uniformLocation);
+}
+
+void GLProgramState::setUniformTexture(UniformValue* v, GLuint textureId)
+{
+    const auto itr = _boundTextureUnits.find(v->_uniform->name);
+    if (itr != _boundTextureUnits.end())
     {
-        if (_boundTextureUnits.find(v->_uniform->name) != _boundTextureUnits.end())
-        {
-            v->setTexture(textureId, _boundTextureUnits[v->_uniform->name]);
-        }
-        else
-        {
-            v->setTexture(textureId, _textureUnitIndex);
-            _boundTextureUnits[v->_uniform->name] = _textureUnitIndex++;
-        }
+        v->setTexture(textureId, itr->second);
     }
     else
     {
-        CCLOG("cocos2d: warning: Uniform at location not found: %i", uniformLocation);
+        v->setTexture(textureId, _textureUnitIndex);
+        _boundTextureUnits[v->_uniform->name] = _textureUnitIndex++;
+    }
+    updateUniformsHash();
+    _uniformsDirty = true;
+}
+
+// Uniform Setters by handle
+
+void GLProgramState::setUniformCallback(const UniformHandle &handle, const std::function<void(GLProgram*, Uniform*)> &callback, bool batchSafe)
+{
+    auto v = getUniformValue(handle);
+    if (v)
+    {
+        v->setCallback(callback, batchSafe);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
+}
+
+void GLProgramState::setUniformFloat(const UniformHandle &handle, float value)
+{
+    auto v = getUniformValue(handle);
+    if (v)
+    {
+        v->setFloat(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
+}
+
+void GLProgramState::setUniformInt(const UniformHandle &handle, int value)
+{
+    auto v = getUniformValue(handle);
+    if (v)
+    {
+        v->setInt(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
+}
+
+void GLProgramState::setUniformVec2(const UniformHandle &handle, const Vec2& value)
+{
+    auto v = getUniformValue(handle);
+    if (v)
+    {
+        v->setVec2(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
+}
+
+void GLProgramState::setUniformVec3(const UniformHandle &handle, const Vec3& value)
+{
+    auto v = getUniformValue(handle);
+    if (v)
+    {
+        v->setVec3(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
+}
+
+void GLProgramState::setUniformVec4(const UniformHandle &handle, const Vec4& value)
+{
+    auto v = getUniformValue(handle);
+    if (v)
+    {
+        v->setVec4(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
     }
 }
 
+void GLProgramState::setUniformMat4(const UniformHandle &handle, const Mat4& value)
+{
+    auto v = getUniformValue(handle);
+    if (v)
+    {
+        v->setMat4(value);
+        updateUniformsHash();
+        _uniformsDirty = true;
+    }
+}
+
+void GLProgramState::setUniformTexture(const UniformHandle &handle, Texture2D *texture)
+{
+    CCASSERT(texture, "Invalid texture");
+    setUniformTexture(handle, texture->getName());
+}
+
+void GLProgramState::setUniformTexture(const UniformHandle &handle, GLuint textureId)
+{
+#if DIRECTX_ENABLED == 1
+	CCASSERT(false, "Not supported yet.");
+#endif
+    auto v = getUniformValue(handle);
+    if (v)
+        setUniformTexture(v, textureId);
+}
+
 NS_CC_END
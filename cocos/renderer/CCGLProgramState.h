@@ -26,6 +26,7 @@ THE SOFTWARE.
 #define __CCGLPROGRAMSTATE_H__
 
 #include <unordered_map>
+#include <vector>
 
 #include "base/ccTypes.h"
 #include "base/CCVector.h"
@@ -62,15 +63,30 @@ public:
     void setVec3(const Vec3& value);
     void setVec4(const Vec4& value);
     void setMat4(const Mat4& value);
-    void setCallback(const std::function<void(GLProgram*, Uniform*)> &callback);
+    /** Sets a callback that sets the uniform by itself.
+     If `batchSafe` is true, the callback must set the same value for all the nodes
+     using the GLProgram, so that they can still be batched together.
+     */
+    void setCallback(const std::function<void(GLProgram*, Uniform*)> &callback, bool batchSafe = false);
     void setTexture(GLuint textureId, GLuint activeTexture);
 
     void apply();
 
+    /** returns false if the value is set by a callback that is not batch safe */
+    bool isBatchable() const { return !_useCallback || _batchSafeCallback; }
+    /** returns a hash of the current value and the uniform location */
+    uint32_t getHash() const;
+
+    /** returns true if the value has to be applied every time: callbacks and textures, whose binding is global */
+    bool isVolatile() const;
+
 protected:
 	Uniform* _uniform;  // weak ref
     GLProgram* _glprogram; // weak ref
     bool _useCallback;
+    bool _batchSafeCallback;
+    // the value changed since it was applied
+    bool _dirty;
 
     union U{
         float floatValue;
@@ -138,6 +154,26 @@ protected:
 };
 
 
+/**
+ A uniform of a GLProgramState resolved once, so that it can be set without looking its name up.
+ It stays valid until the GLProgram of the GLProgramState changes.
+ */
+class UniformHandle
+{
+    friend class GLProgramState;
+public:
+    UniformHandle() : _index(-1), _generation(0) {}
+
+    /** returns false if the uniform was not found */
+    bool isValid() const { return _index >= 0; }
+
+protected:
+    UniformHandle(int index, unsigned int generation) : _index(index), _generation(generation) {}
+
+    int _index;
+    unsigned int _generation;
+};
+
 /**
  GLProgramState holds the 'state' (uniforms and attributes) of the GLProgram.
  A GLProgram can be used by thousands of Nodes, but if different uniform values 
@@ -185,7 +221,7 @@ public:
     void setUniformVec3(const std::string &uniformName, const Vec3& value);
     void setUniformVec4(const std::string &uniformName, const Vec4& value);
     void setUniformMat4(const std::string &uniformName, const Mat4& value);
-    void setUniformCallback(const std::string &uniformName, const std::function<void(GLProgram*, Uniform*)> &callback);
+    void setUniformCallback(const std::string &uniformName, const std::function<void(GLProgram*, Uniform*)> &callback, bool batchSafe = false);
     void setUniformTexture(const std::string &uniformName, Texture2D *texture);
     void setUniformTexture(const std::string &uniformName, GLuint textureId);
 
@@ -199,18 +235,51 @@ public:
     void setUniformTexture(GLint uniformLocation, Texture2D *texture);
     void setUniformTexture(GLint uniformLocation, GLuint textureId);
 
+    /** returns a handle to set the uniform without looking its name up. Callers should keep it */
+    UniformHandle getUniformHandle(const std::string &uniformName) const;
+    void setUniformInt(const UniformHandle &handle, int value);
+    void setUniformFloat(const UniformHandle &handle, float value);
+    void setUniformVec2(const UniformHandle &handle, const Vec2& value);
+    void setUniformVec3(const UniformHandle &handle, const Vec3& value);
+    void setUniformVec4(const UniformHandle &handle, const Vec4& value);
+    void setUniformMat4(const UniformHandle &handle, const Mat4& value);
+    void setUniformCallback(const UniformHandle &handle, const std::function<void(GLProgram*, Uniform*)> &callback, bool batchSafe = false);
+    void setUniformTexture(const UniformHandle &handle, Texture2D *texture);
+    void setUniformTexture(const UniformHandle &handle, GLuint textureId);
+
+    /** Returns a hash of the current uniform values.
+     Two GLProgramStates of the same GLProgram with the same hash set the same uniforms,
+     so QuadCommands using them can be drawn in the same batch.
+     */
+    uint32_t getUniformsHash() const { return _uniformsHash; }
+    /** returns false if a uniform is set by a callback that is not batch safe */
+    bool areUniformsBatchable() const { return _uniformsBatchable; }
+
 protected:
     GLProgramState();
     ~GLProgramState();
     bool init(GLProgram* program);
     void resetGLProgram();
+    void updateUniformsHash();
+    void setUniformTexture(UniformValue* value, GLuint textureId);
     VertexAttribValue* getVertexAttribValue(const std::string &attributeName);
     UniformValue* getUniformValue(const std::string &uniformName);
     UniformValue* getUniformValue(GLint uniformLocation);
+    UniformValue* getUniformValue(const UniformHandle &handle);
     
     bool _uniformAttributeValueDirty;
-    std::unordered_map<std::string, GLint> _uniformsByName;
-    std::unordered_map<GLint, UniformValue> _uniforms;
+    bool _uniformsBatchable;
+    uint32_t _uniformsHash;
+    // a uniform changed since applyUniforms()
+    bool _uniformsDirty;
+    // some uniforms have to be applied every time
+    bool _hasVolatileUniforms;
+    // identifies this state in GLProgram::_uniformsStateId
+    unsigned int _id;
+    // changes with the GLProgram, to catch stale UniformHandles
+    unsigned int _uniformsGeneration;
+    std::unordered_map<std::string, int> _uniformsByName;
+    std::vector<UniformValue> _uniforms;
     std::unordered_map<std::string, VertexAttribValue> _attributes;
     std::unordered_map<std::string, int> _boundTextureUnits;
 
@@ -27,6 +27,7 @@
 #define _CC_GROUPCOMMAND_H_
 
 #include <unordered_map>
+#include <mutex>
 
 #include "base/CCRef.h"
 #include "CCRenderCommand.h"
@@ -46,6 +47,8 @@ protected:
     ~GroupCommandManager();
     bool init();
     std::unordered_map<int, bool> _groupMapping;
+    // GroupCommands can be initialized from Renderer::visitInParallel workers
+    std::mutex _groupMappingMutex;
 };
 
 class GroupCommand : public RenderCommand
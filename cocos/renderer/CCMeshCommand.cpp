@@ -127,16 +127,16 @@ void MeshCommand::applyRenderState()
 #if DIRECTX_ENABLED == 0
     if (_cullFaceEnabled)
     {
-        glEnable(GL_CULL_FACE);
-        glCullFace(_cullFace);
+        GL::enableCullFace(true);
+        GL::cullFace(_cullFace);
     }
     if (_depthTestEnabled)
     {
-        glEnable(GL_DEPTH_TEST);
+        GL::enableDepthTest(true);
     }
     if (_depthWriteEnabled)
     {
-        glDepthMask(GL_TRUE);
+        GL::depthMask(GL_TRUE);
     }
 #endif
 }
@@ -146,15 +146,15 @@ void MeshCommand::restoreRenderState()
 #if DIRECTX_ENABLED == 0
     if (_cullFaceEnabled)
     {
-        glDisable(GL_CULL_FACE);
+        GL::enableCullFace(false);
     }
     if (_depthTestEnabled)
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::enableDepthTest(false);
     }
     if (_depthWriteEnabled)
     {
-        glDepthMask(GL_FALSE);
+        GL::depthMask(GL_FALSE);
     }
 #endif
 }
@@ -195,13 +195,13 @@ void MeshCommand::preBatchDraw()
     if (_vao)
     {
         GL::bindVAO(_vao);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
         _glProgramState->applyAttributes();
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
     }
 #else
 	CCASSERT(false, "Not supported.");
@@ -241,8 +241,8 @@ void MeshCommand::postBatchDraw()
     }
     else
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
     }
 #else
 	CCASSERT(false, "Not supported.");
@@ -258,7 +258,7 @@ void MeshCommand::execute()
     GL::bindTexture2D(_textureID);
     GL::blendFunc(_blendType.src, _blendType.dst);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
     _glProgramState->setUniformVec4("u_color", _displayColor);
     
     if (_matrixPaletteSize && _matrixPalette)
@@ -269,7 +269,7 @@ void MeshCommand::execute()
     
     _glProgramState->apply(_mv);
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
     
     // Draw
     glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
@@ -278,8 +278,8 @@ void MeshCommand::execute()
     
     //restore render state
     restoreRenderState();
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 #else
 	CCASSERT(false, "Not supported.");
 #endif
@@ -293,7 +293,7 @@ void MeshCommand::buildVAO()
     {
         glGenVertexArrays(1, &_vao);
         GL::bindVAO(_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+        GL::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
         auto flags = _glProgramState->getVertexAttribsFlags();
         for (int i = 0; flags > 0; i++) {
             int flag = 1 << i;
@@ -303,11 +303,11 @@ void MeshCommand::buildVAO()
         }
         _glProgramState->applyAttributes(false);
         
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
         
         GL::bindVAO(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 #else
 	CCASSERT(false, "Not supported.");
@@ -35,6 +35,7 @@ NS_CC_BEGIN
 
 QuadCommand::QuadCommand()
 :_materialID(0)
+,_uniformsHash(0)
 ,_texture(nullptr)
 ,_glProgramState(nullptr)
 ,_blendType(BlendFunc::DISABLE)
@@ -56,11 +57,14 @@ void QuadCommand::init(float globalOrder, Texture2D* texture, GLProgramState* gl
 
     _mv = mv;
 
-	if (_texture != texture || _blendType.src != blendType.src || _blendType.dst != blendType.dst || _glProgramState != glProgramState) {
+    uint32_t uniformsHash = glProgramState->getUniformsHash();
+
+	if (_texture != texture || _blendType.src != blendType.src || _blendType.dst != blendType.dst || _glProgramState != glProgramState || _uniformsHash != uniformsHash) {
 
         _texture = texture;
         _blendType = blendType;
         _glProgramState = glProgramState;
+        _uniformsHash = uniformsHash;
 
         generateMaterialID();
     }
@@ -73,14 +77,15 @@ QuadCommand::~QuadCommand()
 void QuadCommand::generateMaterialID()
 {
 
-    if(_glProgramState->getUniformCount() > 0)
+    // commands whose uniforms hash the same apply the same values, so they can share a draw call
+    if(!_glProgramState->areUniformsBatchable())
     {
         _materialID = QuadCommand::MATERIAL_ID_DO_NOT_BATCH;
     }
     else
     {
         int glProgram = (int)_glProgramState->getGLProgram()->getProgram();
-        int intArray[4] = { glProgram, (int)_texture->getName(), (int)_blendType.src, (int)_blendType.dst};
+        int intArray[5] = { glProgram, (int)_texture->getName(), (int)_blendType.src, (int)_blendType.dst, (int)_uniformsHash};
 
         _materialID = XXH32((const void*)intArray, sizeof(intArray), 0);
     }
@@ -48,6 +48,7 @@ public:
     void useMaterial() const;
 
     inline uint32_t getMaterialID() const { return _materialID; }
+    inline Texture2D* getTexture() const { return _texture; }
     inline V3F_C4B_T2F_Quad* getQuads() const { return _quads; }
     inline ssize_t getQuadCount() const { return _quadsCount; }
     inline GLProgramState* getGLProgramState() const { return _glProgramState; }
@@ -58,6 +59,7 @@ protected:
     void generateMaterialID();
 
     uint32_t _materialID;
+    uint32_t _uniformsHash;
 
 	Texture2D* _texture;
     GLProgramState* _glProgramState;
@@ -30,6 +30,7 @@ NS_CC_BEGIN
 RenderCommand::RenderCommand()
 : _type(RenderCommand::Type::UNKNOWN_COMMAND)
 , _globalOrder(0)
+, _sortKey(0)
 {
 }
 
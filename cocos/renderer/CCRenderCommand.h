@@ -49,6 +49,8 @@ public:
         BATCH_COMMAND,
         GROUP_COMMAND,
         MESH_COMMAND,
+        SCISSOR_COMMAND,
+        TRIANGLES_COMMAND,
     };
 
     /** Get Render Command Id */
@@ -57,7 +59,17 @@ public:
     /** Returns the Command type */
     inline Type getType() const { return _type; }
 
+    /** Returns the key used to sort the command inside its `RenderQueue`.
+     From the most to the least significant bits: global order (32 bits), run (20 bits) and material ID (12 bits).
+     A run is a sequence of batchable commands between two commands that can't be batched, which get a run of their own,
+     so only the batchable commands are reordered, never across a custom, group or scissor command.
+     It is valid once the command was added to the renderer.
+     */
+    inline uint64_t getSortKey() const { return _sortKey; }
+
 protected:
+    friend class RenderQueue;
+
     RenderCommand();
     virtual ~RenderCommand();
 
@@ -68,6 +80,9 @@ protected:
 
     // commands are sort by depth
     float _globalOrder;
+
+    // packed global order, material ID and submission index
+    uint64_t _sortKey;
 };
 
 NS_CC_END
@@ -0,0 +1,334 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCRenderTargetPool.h"
+
+#include <algorithm>
+
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventType.h"
+#include "base/ccMacros.h"
+#include "base/ccUtils.h"
+#include "renderer/ccGLStateCache.h"
+
+NS_CC_BEGIN
+
+static const size_t DEFAULT_MEMORY_LIMIT = 32 * 1024 * 1024;
+
+// implementation of RenderTarget
+
+RenderTarget::RenderTarget()
+: _framebuffer(0)
+, _depthStencilBuffer(0)
+, _texture(nullptr)
+, _width(0)
+, _height(0)
+, _pixelFormat(Texture2D::PixelFormat::RGBA8888)
+, _depthStencilFormat(0)
+, _memorySize(0)
+{
+}
+
+RenderTarget::~RenderTarget()
+{
+    deleteFramebuffer();
+    CC_SAFE_RELEASE(_texture);
+}
+
+bool RenderTarget::init(int width, int height, Texture2D::PixelFormat format, GLuint depthStencilFormat)
+{
+    CCASSERT(width > 0 && height > 0, "Invalid size");
+
+    _width = width;
+    _height = height;
+    _pixelFormat = format;
+    _depthStencilFormat = depthStencilFormat;
+
+    // textures must be power of two squared
+    int powW = width;
+    int powH = height;
+    if (!Configuration::getInstance()->supportsNPOT())
+    {
+        powW = ccNextPOT(width);
+        powH = ccNextPOT(height);
+    }
+
+    auto dataLen = powW * powH * 4;
+    void* data = calloc(dataLen, 1);
+    if (!data)
+    {
+        return false;
+    }
+
+    _texture = new Texture2D();
+#if DIRECTX_ENABLED == 1
+    _texture->prepareForRenderTarget();
+#endif
+    bool ret = _texture->initWithData(data, dataLen, format, powW, powH, Size((float)width, (float)height));
+    free(data);
+    if (!ret)
+    {
+        return false;
+    }
+
+    _memorySize = powW * powH * _texture->getBitsPerPixelForFormat() / 8;
+    if (depthStencilFormat != 0)
+    {
+        _memorySize += powW * powH * (depthStencilFormat == GL_DEPTH_COMPONENT16 ? 2 : 4);
+    }
+
+    return createFramebuffer();
+}
+
+bool RenderTarget::createFramebuffer()
+{
+#if DIRECTX_ENABLED == 0
+    GLint oldFBO;
+    GLint oldRBO;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &oldFBO);
+    glGetIntegerv(GL_RENDERBUFFER_BINDING, &oldRBO);
+
+    glGenFramebuffers(1, &_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
+
+    if (_depthStencilFormat != 0)
+    {
+        glGenRenderbuffers(1, &_depthStencilBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, _depthStencilBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, _depthStencilFormat, (GLsizei)_texture->getPixelsWide(), (GLsizei)_texture->getPixelsHigh());
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthStencilBuffer);
+
+        // if depth format is the one with stencil part, bind same render buffer as stencil attachment
+        if (_depthStencilFormat == GL_DEPTH24_STENCIL8)
+        {
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _depthStencilBuffer);
+        }
+    }
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    CCASSERT(complete, "Could not attach texture to framebuffer");
+
+    glBindRenderbuffer(GL_RENDERBUFFER, oldRBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
+    return complete;
+#else
+    return true;
+#endif
+}
+
+void RenderTarget::deleteFramebuffer()
+{
+#if DIRECTX_ENABLED == 0
+    if (_framebuffer)
+    {
+        glDeleteFramebuffers(1, &_framebuffer);
+        _framebuffer = 0;
+    }
+    if (_depthStencilBuffer)
+    {
+        glDeleteRenderbuffers(1, &_depthStencilBuffer);
+        _depthStencilBuffer = 0;
+    }
+#endif
+}
+
+void RenderTarget::restoreFramebuffer()
+{
+    // the names are not valid anymore, so they are forgotten rather than deleted
+    _framebuffer = 0;
+    _depthStencilBuffer = 0;
+    createFramebuffer();
+}
+
+void RenderTarget::reset()
+{
+    Texture2D::TexParams texParams = { GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+    _texture->setTexParameters(texParams);
+
+#if DIRECTX_ENABLED == 0
+    GLint oldFBO;
+    GLfloat oldClearColor[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &oldFBO);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, oldClearColor);
+    bool scissorEnabled = GL::isScissorTestEnabled();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+    GL::enableScissorTest(false);
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glClearColor(oldClearColor[0], oldClearColor[1], oldClearColor[2], oldClearColor[3]);
+    GL::enableScissorTest(scissorEnabled);
+    glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
+#endif
+}
+
+// implementation of RenderTargetPool
+
+static RenderTargetPool* s_sharedRenderTargetPool = nullptr;
+
+RenderTargetPool* RenderTargetPool::getInstance()
+{
+    if (!s_sharedRenderTargetPool)
+    {
+        s_sharedRenderTargetPool = new RenderTargetPool();
+    }
+
+    return s_sharedRenderTargetPool;
+}
+
+void RenderTargetPool::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedRenderTargetPool);
+}
+
+RenderTargetPool::RenderTargetPool()
+: _memoryLimit(DEFAULT_MEMORY_LIMIT)
+{
+    memset(&_statistics, 0, sizeof(_statistics));
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the pooled targets are not restored with the GL context
+    _backgroundListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(EVENT_COME_TO_BACKGROUND, [this](EventCustom*){
+        purge();
+    });
+#endif
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_backgroundListener);
+#endif
+
+    purge();
+
+    // the targets still in use are destroyed when they are recycled
+    _targetsInUse.clear();
+}
+
+RenderTarget* RenderTargetPool::acquire(int width, int height, Texture2D::PixelFormat format, GLuint depthStencilFormat)
+{
+    RenderTarget* target = nullptr;
+
+    for (auto iter = _freeTargets.rbegin(); iter != _freeTargets.rend(); ++iter)
+    {
+        RenderTarget* candidate = *iter;
+        if (candidate->_width == width && candidate->_height == height &&
+            candidate->_pixelFormat == format && candidate->_depthStencilFormat == depthStencilFormat)
+        {
+            target = candidate;
+            _freeTargets.erase(std::next(iter).base());
+            _statistics.pooled--;
+            _statistics.pooledMemory -= target->_memorySize;
+            _statistics.reused++;
+            target->reset();
+            break;
+        }
+    }
+
+    if (!target)
+    {
+        target = new RenderTarget();
+        if (!target->init(width, height, format, depthStencilFormat))
+        {
+            CCLOG("cocos2d: RenderTargetPool: could not create a %dx%d render target", width, height);
+            delete target;
+            return nullptr;
+        }
+        _statistics.created++;
+    }
+
+    _targetsInUse.insert(target);
+    _statistics.inUse++;
+    _statistics.inUseMemory += target->_memorySize;
+    return target;
+}
+
+void RenderTargetPool::recycle(RenderTarget* target)
+{
+    if (nullptr == target)
+    {
+        return;
+    }
+
+    auto iter = _targetsInUse.find(target);
+    if (iter == _targetsInUse.end())
+    {
+        // acquired from a pool destroyed since then
+        destroyTarget(target);
+        return;
+    }
+    _targetsInUse.erase(iter);
+    _statistics.inUse--;
+    _statistics.inUseMemory -= target->_memorySize;
+
+    if (target->_texture->getReferenceCount() > 1 || target->_memorySize > _memoryLimit)
+    {
+        destroyTarget(target);
+        return;
+    }
+
+    _freeTargets.push_back(target);
+    _statistics.pooled++;
+    _statistics.pooledMemory += target->_memorySize;
+    trim(_memoryLimit);
+}
+
+void RenderTargetPool::purge()
+{
+    trim(0);
+}
+
+void RenderTargetPool::setMemoryLimit(size_t bytes)
+{
+    _memoryLimit = bytes;
+    trim(_memoryLimit);
+}
+
+void RenderTargetPool::destroyTarget(RenderTarget* target)
+{
+    delete target;
+    _statistics.destroyed++;
+}
+
+void RenderTargetPool::trim(size_t memoryLimit)
+{
+    // the least recently recycled targets go first
+    size_t count = 0;
+    while (count < _freeTargets.size() && _statistics.pooledMemory > memoryLimit)
+    {
+        RenderTarget* target = _freeTargets[count++];
+        _statistics.pooled--;
+        _statistics.pooledMemory -= target->_memorySize;
+        destroyTarget(target);
+    }
+    _freeTargets.erase(_freeTargets.begin(), _freeTargets.begin() + count);
+}
+
+NS_CC_END
@@ -0,0 +1,173 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCRENDERTARGETPOOL_H__
+#define __CCRENDERTARGETPOOL_H__
+
+#include <unordered_set>
+#include <vector>
+
+#include "base/CCPlatformMacros.h"
+#include "renderer/CCTexture2D.h"
+#include "CCGL.h"
+
+NS_CC_BEGIN
+
+class EventListenerCustom;
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @brief A texture with the framebuffer and the depth/stencil buffer used to render into it.
+
+ Render targets are created and recycled by RenderTargetPool.
+ With DirectX, only the texture is pooled: the views are created by the users of the target.
+ @since v3.2
+ */
+class CC_DLL RenderTarget
+{
+public:
+    /** The framebuffer the texture is attached to. 0 with DirectX */
+    inline GLuint getFramebuffer() const { return _framebuffer; }
+
+    /** The color attachment. Its content size is the size of the target in pixels */
+    inline Texture2D* getTexture() const { return _texture; }
+
+    /** The depth/stencil renderbuffer, or 0 if the target has none */
+    inline GLuint getDepthStencilBuffer() const { return _depthStencilBuffer; }
+
+    inline int getWidth() const { return _width; }
+    inline int getHeight() const { return _height; }
+    inline Texture2D::PixelFormat getPixelFormat() const { return _pixelFormat; }
+    inline GLuint getDepthStencilFormat() const { return _depthStencilFormat; }
+
+    /** The video memory used by the texture and the depth/stencil buffer, in bytes */
+    inline size_t getMemorySize() const { return _memorySize; }
+
+    /** Creates the framebuffer and the depth/stencil buffer again, once the GL context was recreated */
+    void restoreFramebuffer();
+
+protected:
+    friend class RenderTargetPool;
+
+    RenderTarget();
+    ~RenderTarget();
+
+    bool init(int width, int height, Texture2D::PixelFormat format, GLuint depthStencilFormat);
+    bool createFramebuffer();
+    void deleteFramebuffer();
+
+    // prepares a recycled target to be used again: default texture parameters and a transparent texture
+    void reset();
+
+    GLuint _framebuffer;
+    GLuint _depthStencilBuffer;
+    Texture2D* _texture;
+    int _width;
+    int _height;
+    Texture2D::PixelFormat _pixelFormat;
+    GLuint _depthStencilFormat;
+    size_t _memorySize;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(RenderTarget);
+};
+
+/** @brief Keeps the render targets released by RenderTexture and the grid effects, to hand them out again.
+
+ Targets are matched by size, pixel format and depth/stencil format. Once warm, repeated transitions
+ and effects don't create any GL object. The pool keeps the most recently released targets up to a memory limit.
+
+ A target whose texture is still retained by someone else when it is recycled is not pooled, so its
+ content is never overwritten.
+ @since v3.2
+ */
+class CC_DLL RenderTargetPool
+{
+public:
+    struct Statistics
+    {
+        /** Targets created because none was available in the pool */
+        unsigned int created;
+        /** Targets taken from the pool */
+        unsigned int reused;
+        /** Targets destroyed, because of the memory limit or a purge */
+        unsigned int destroyed;
+        /** Targets currently acquired, and their memory */
+        unsigned int inUse;
+        size_t inUseMemory;
+        /** Targets waiting in the pool, and their memory */
+        unsigned int pooled;
+        size_t pooledMemory;
+    };
+
+    /** Returns the shared pool. It must be used on the cocos2d thread */
+    static RenderTargetPool* getInstance();
+
+    /** Destroys the shared pool and the targets it holds */
+    static void destroyInstance();
+
+    /** Returns a target of `width` x `height` pixels, taken from the pool when possible. The texture is transparent.
+     Give it back with recycle(). Returns nullptr if the target can't be created.
+     @param depthStencilFormat 0, GL_DEPTH_COMPONENT16 or GL_DEPTH24_STENCIL8
+     */
+    RenderTarget* acquire(int width, int height, Texture2D::PixelFormat format, GLuint depthStencilFormat);
+
+    /** Gives back a target returned by acquire(). It must not be used anymore */
+    void recycle(RenderTarget* target);
+
+    /** Destroys the targets waiting in the pool */
+    void purge();
+
+    /** Sets the memory the pooled targets can use, in bytes. 0 disables pooling. Defaults to 32 MB */
+    void setMemoryLimit(size_t bytes);
+    inline size_t getMemoryLimit() const { return _memoryLimit; }
+
+    inline const Statistics& getStatistics() const { return _statistics; }
+
+protected:
+    RenderTargetPool();
+    ~RenderTargetPool();
+
+    void destroyTarget(RenderTarget* target);
+    void trim(size_t memoryLimit);
+
+    // the most recently recycled targets are at the end
+    std::vector<RenderTarget*> _freeTargets;
+    std::unordered_set<RenderTarget*> _targetsInUse;
+    size_t _memoryLimit;
+    Statistics _statistics;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    EventListenerCustom* _backgroundListener;
+#endif
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif // __CCRENDERTARGETPOOL_H__
@@ -25,6 +25,7 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <cfloat>
 
 #include "renderer/CCQuadCommand.h"
 #include "renderer/CCBatchCommand.h"
@@ -33,31 +34,85 @@
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCMeshCommand.h"
+#include "renderer/CCScissorCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCThreadPool.h"
+#include "math/MathUtil.h"
+#include "2d/CCNode.h"
+#include "CCGLView.h"
 
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+static bool isBatchable(RenderCommand* command)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    auto commandType = command->getType();
+    return RenderCommand::Type::QUAD_COMMAND == commandType
+        || RenderCommand::Type::MESH_COMMAND == commandType
+        || RenderCommand::Type::TRIANGLES_COMMAND == commandType;
+}
+
+static uint64_t makeSortKey(RenderCommand* command, uint32_t run)
+{
+    // flip the float bits so that the unsigned ordering matches the float ordering
+    float z = command->getGlobalOrder();
+    uint32_t zBits;
+    memcpy(&zBits, &z, sizeof(zBits));
+    zBits = (zBits & 0x80000000) ? ~zBits : (zBits | 0x80000000);
+
+    uint32_t materialID = 0;
+    auto commandType = command->getType();
+    if (RenderCommand::Type::QUAD_COMMAND == commandType)
+        materialID = static_cast<QuadCommand*>(command)->getMaterialID();
+    else if (RenderCommand::Type::MESH_COMMAND == commandType)
+        materialID = static_cast<MeshCommand*>(command)->getMaterialID();
+    else if (RenderCommand::Type::TRIANGLES_COMMAND == commandType)
+        materialID = static_cast<TrianglesCommand*>(command)->getMaterialID();
+
+    // fold the 32 bit hash: a collision only costs a batch, the sort is stable anyway
+    uint64_t material = (materialID ^ (materialID >> 12) ^ (materialID >> 24)) & 0xFFF;
+
+    return ((uint64_t)zBits << 32) | ((uint64_t)std::min<uint32_t>(run, 0xFFFFF) << 12) | material;
 }
 
 // queue
 
+RenderQueue::RenderQueue()
+: _sortRun(0)
+{
+}
+
 void RenderQueue::push_back(RenderCommand* command)
 {
+    // commands that aren't batched (custom, group, scissor...) bracket the commands around them: they get a run of
+    // their own, so only the batchable commands between two of them are grouped by material
+    uint32_t run = _sortRun;
+    if (!isBatchable(command))
+    {
+        run = ++_sortRun;
+        ++_sortRun;
+    }
+
+    command->_sortKey = makeSortKey(command, run);
+
     float z = command->getGlobalOrder();
     if(z < 0)
+    {
         _queueNegZ.push_back(command);
+    }
     else if(z > 0)
+    {
         _queuePosZ.push_back(command);
+    }
     else
+    {
         _queue0.push_back(command);
+    }
 }
 
 ssize_t RenderQueue::size() const
@@ -68,8 +123,54 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::sort(std::begin(_queueNegZ), std::end(_queueNegZ), compareRenderCommand);
-    std::sort(std::begin(_queuePosZ), std::end(_queuePosZ), compareRenderCommand);
+    radixSort(_queueNegZ);
+    radixSort(_queuePosZ);
+}
+
+void RenderQueue::radixSort(std::vector<RenderCommand*>& queue)
+{
+    size_t count = queue.size();
+    if (count < 2)
+        return;
+
+    _sortEntries.resize(count);
+    _sortScratch.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        _sortEntries[i].key = queue[i]->_sortKey;
+        _sortEntries[i].command = queue[i];
+    }
+
+    SortEntry* src = _sortEntries.data();
+    SortEntry* dst = _sortScratch.data();
+
+    // 8 passes of 8 bits, least significant first
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        size_t offsets[256] = {0};
+        for (size_t i = 0; i < count; ++i)
+            ++offsets[(src[i].key >> shift) & 0xFF];
+
+        // skip the pass when every key has the same digit, e.g. the upper bytes of z
+        if (offsets[(src[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        size_t total = 0;
+        for (int digit = 0; digit < 256; ++digit)
+        {
+            size_t digitCount = offsets[digit];
+            offsets[digit] = total;
+            total += digitCount;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+            dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+        std::swap(src, dst);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        queue[i] = src[i].command;
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -93,6 +194,7 @@ RenderCommand* RenderQueue::operator[](ssize_t index) const
 
 void RenderQueue::clear()
 {
+    _sortRun = 0;
     _queueNegZ.clear();
     _queue0.clear();
     _queuePosZ.clear();
@@ -109,24 +211,55 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 Renderer::Renderer()
 :_lastMaterialID(0)
 ,_lastBatchedMeshCommand(nullptr)
+,_quadsCapacity(VBO_SIZE)
+,_useUintIndices(false)
+#if (DIRECTX_ENABLED == 1)
+, _bufferVertex(nullptr)
+, _bufferIndex(nullptr)
+#else
+,_currentVertexBuffer(0)
+#if CC_RENDERER_STREAM_VBO
+,_streamVertexBuffers(false)
+,_streamOffset(0)
+#endif
+#endif
 ,_numQuads(0)
+,_numTriangleVertices(0)
+#if (DIRECTX_ENABLED == 0)
+,_trianglesVAO(0)
+,_trianglesVBO(0)
+#endif
 ,_glViewAssigned(false)
+,_batchReorderingEnabled(false)
+,_reorderSavedBatches(0)
+,_unbatchableQuadCommands(0)
+,_frameStamp(0)
 ,_isRendering(false)
+,_isVisitingInParallel(false)
+,_parallelVisitThreshold(64)
+,_scissorStateValid(false)
+,_scissorEnabled(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
-#if (DIRECTX_ENABLED == 1)
-, _bufferVertex(nullptr)
-, _bufferIndex(nullptr)
-#endif
 {
     _groupCommandManager = new GroupCommandManager();
+
+    _quads.resize(_quadsCapacity);
+#if (DIRECTX_ENABLED == 0)
+    memset(_quadVAOs, 0, sizeof(_quadVAOs));
+    memset(_buffersVBO, 0, sizeof(_buffersVBO));
+#if CC_RENDERER_STREAM_VBO
+    memset(_vertexBufferFences, 0, sizeof(_vertexBufferFences));
+#endif
+#endif
     
     _commandGroupStack.push(DEFAULT_RENDER_QUEUE);
     
     RenderQueue defaultRenderQueue;
     _renderGroups.push_back(defaultRenderQueue);
     _batchedQuadCommands.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
+    _batchedQuadCounts.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
 }
 
 Renderer::~Renderer()
@@ -138,11 +271,20 @@ Renderer::~Renderer()
 	DXResourceManager::getInstance().remove(&_bufferVertex);
 	DXResourceManager::getInstance().remove(&_bufferIndex);	
 #else
-    glDeleteBuffers(2, _buffersVBO);
+#if CC_RENDERER_STREAM_VBO
+    for (auto& fence : _vertexBufferFences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+    }
+#endif
+    GL::deleteBuffers(VERTEX_BUFFER_COUNT + 1, _buffersVBO);
+    GL::deleteBuffers(1, &_trianglesVBO);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
-        glDeleteVertexArrays(1, &_quadVAO);
+        glDeleteVertexArrays(VERTEX_BUFFER_COUNT, _quadVAOs);
+        glDeleteVertexArrays(1, &_trianglesVAO);
         GL::bindVAO(0);
     }
 #endif
@@ -169,16 +311,35 @@ void Renderer::initGLView()
     _glViewAssigned = true;
 }
 
+template <typename T>
+static void fillQuadIndices(std::vector<T>& indices, ssize_t quadCount)
+{
+    indices.resize(quadCount * 6);
+    for (ssize_t i = 0; i < quadCount; i++)
+    {
+        indices[i*6+0] = (T) (i*4+0);
+        indices[i*6+1] = (T) (i*4+1);
+        indices[i*6+2] = (T) (i*4+2);
+        indices[i*6+3] = (T) (i*4+3);
+        indices[i*6+4] = (T) (i*4+2);
+        indices[i*6+5] = (T) (i*4+1);
+    }
+}
+
 void Renderer::setupIndices()
 {
-    for( int i=0; i < VBO_SIZE; i++)
+    // 16 bit indices can't address the vertices past MAX_QUADS_16BIT_INDICES quads
+    _useUintIndices = _quadsCapacity > MAX_QUADS_16BIT_INDICES;
+
+    if (_useUintIndices)
     {
-        _indices[i*6+0] = (GLushort) (i*4+0);
-        _indices[i*6+1] = (GLushort) (i*4+1);
-        _indices[i*6+2] = (GLushort) (i*4+2);
-        _indices[i*6+3] = (GLushort) (i*4+3);
-        _indices[i*6+4] = (GLushort) (i*4+2);
-        _indices[i*6+5] = (GLushort) (i*4+1);
+        _indices.clear();
+        fillQuadIndices(_indices32, _quadsCapacity);
+    }
+    else
+    {
+        _indices32.clear();
+        fillQuadIndices(_indices, _quadsCapacity);
     }
 }
 
@@ -187,6 +348,12 @@ void Renderer::setupBuffer()
 #if (DIRECTX_ENABLED == 1)
 	mapBuffers();
 #else
+#if CC_RENDERER_STREAM_VBO
+    auto conf = Configuration::getInstance();
+    _streamVertexBuffers = conf->supportsMapBufferRange() && conf->supportsFenceSync();
+    // the fences belong to the previous context, if any
+    memset(_vertexBufferFences, 0, sizeof(_vertexBufferFences));
+#endif
     if(Configuration::getInstance()->supportsShareableVAO())
     {
         setupVBOAndVAO();
@@ -201,42 +368,60 @@ void Renderer::setupBuffer()
 void Renderer::setupVBOAndVAO()
 {
 #if (DIRECTX_ENABLED == 0)
-    glGenVertexArrays(1, &_quadVAO);
-    GL::bindVAO(_quadVAO);
+    glGenBuffers(VERTEX_BUFFER_COUNT + 1, &_buffersVBO[0]);
+    glGenVertexArrays(VERTEX_BUFFER_COUNT, &_quadVAOs[0]);
+
+    // one VAO per vertex buffer, all of them sharing the index buffer
+    for (int i = 0; i < VERTEX_BUFFER_COUNT; ++i)
+    {
+        GL::bindVAO(_quadVAOs[i]);
+
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[i]);
 
-    glGenBuffers(2, &_buffersVBO[0]);
+        // vertices
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
+
+        // colors
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, _quads, GL_DYNAMIC_DRAW);
+        // tex coords
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
+
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[VERTEX_BUFFER_COUNT]);
+    }
+
+    // triangles are not indexed
+    glGenBuffers(1, &_trianglesVBO);
+    glGenVertexArrays(1, &_trianglesVAO);
+    GL::bindVAO(_trianglesVAO);
+    GL::bindBuffer(GL_ARRAY_BUFFER, _trianglesVBO);
 
-    // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
 
-    // colors
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
 
-    // tex coords
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
-
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
-    CHECK_GL_ERROR_DEBUG();
+    mapBuffers();
 #endif
 }
 
 void Renderer::setupVBO()
 {
 #if (DIRECTX_ENABLED == 0)    
-    glGenBuffers(2, &_buffersVBO[0]);
+    glGenBuffers(VERTEX_BUFFER_COUNT + 1, &_buffersVBO[0]);
+    glGenBuffers(1, &_trianglesVBO);
 #endif
 
     mapBuffers();
@@ -250,10 +435,10 @@ void Renderer::mapBuffers()
 	DXResourceManager::getInstance().remove(&_bufferIndex);
 
 	D3D11_SUBRESOURCE_DATA vertexBufferData = { 0 };
-	vertexBufferData.pSysMem = _quads;
+	vertexBufferData.pSysMem = _quads.data();
 	vertexBufferData.SysMemPitch = 0;
 	vertexBufferData.SysMemSlicePitch = 0;
-	CD3D11_BUFFER_DESC vertexBufferDesc(sizeof(_quads[0]) * VBO_SIZE, D3D11_BIND_VERTEX_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
+	CD3D11_BUFFER_DESC vertexBufferDesc(sizeof(_quads[0]) * _quadsCapacity, D3D11_BIND_VERTEX_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE);
 	DX::ThrowIfFailed(
 		view->GetDevice()->CreateBuffer(
 		&vertexBufferDesc,
@@ -261,11 +446,11 @@ void Renderer::mapBuffers()
 		&_bufferVertex));
 
 	D3D11_SUBRESOURCE_DATA indexBufferData = { 0 };
-	indexBufferData.pSysMem = _indices;
+	indexBufferData.pSysMem = _indices.data();
 	indexBufferData.SysMemPitch = 0;
 	indexBufferData.SysMemSlicePitch = 0;
 
-	CD3D11_BUFFER_DESC indexBufferDesc(sizeof(_indices[0]) * VBO_SIZE * 6, D3D11_BIND_INDEX_BUFFER);
+	CD3D11_BUFFER_DESC indexBufferDesc(sizeof(_indices[0]) * _quadsCapacity * 6, D3D11_BIND_INDEX_BUFFER);
 	DX::ThrowIfFailed(
 		view->GetDevice()->CreateBuffer(
 		&indexBufferDesc,
@@ -279,21 +464,154 @@ void Renderer::mapBuffers()
     // Avoid changing the element buffer for whatever VAO might be bound.
     GL::bindVAO(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * VBO_SIZE, _quads, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#if CC_RENDERER_STREAM_VBO
+    // reallocating the storage already keeps the GPU reads safe
+    for (auto& fence : _vertexBufferFences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    _streamOffset = 0;
+#endif
+
+    for (int i = 0; i < VERTEX_BUFFER_COUNT; ++i)
+    {
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[i]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _quadsCapacity, nullptr, GL_DYNAMIC_DRAW);
+    }
+    GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * VBO_SIZE * 6, _indices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[VERTEX_BUFFER_COUNT]);
+    if (_useUintIndices)
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices32[0]) * _indices32.size(), _indices32.data(), GL_STATIC_DRAW);
+    else
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _indices.size(), _indices.data(), GL_STATIC_DRAW);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     CHECK_GL_ERROR_DEBUG();
 #endif
 }
 
+bool Renderer::growQuadCapacity(ssize_t quadCount)
+{
+    ssize_t maxCapacity = MAX_QUADS_16BIT_INDICES;
+#if (DIRECTX_ENABLED == 0)
+    if (Configuration::getInstance()->supportsElementIndexUint())
+    {
+        maxCapacity = MAX_QUADS_32BIT_INDICES;
+    }
+#endif
+
+    if (_quadsCapacity >= quadCount || _quadsCapacity >= maxCapacity)
+    {
+        return _quadsCapacity >= quadCount;
+    }
+
+    ssize_t capacity = _quadsCapacity;
+    while (capacity < quadCount && capacity < maxCapacity)
+    {
+        capacity *= 2;
+    }
+    _quadsCapacity = std::min(capacity, maxCapacity);
+
+    // the quads already batched are kept
+    _quads.resize(_quadsCapacity);
+    setupIndices();
+    mapBuffers();
+
+    return _quadsCapacity >= quadCount;
+}
+
+ssize_t Renderer::uploadBatchedQuads()
+{
+#if (DIRECTX_ENABLED == 1)
+	auto view = GLView::sharedOpenGLView();
+
+	if (!_bufferVertex || !_bufferIndex)
+		mapBuffers();
+
+	D3D11_MAPPED_SUBRESOURCE resource;
+	view->GetContext()->Map(_bufferVertex, 0, D3D11_MAP_WRITE_DISCARD, 0, &resource);
+	memcpy(resource.pData, _quads.data(), sizeof(_quads[0]) * _numQuads);
+	view->GetContext()->Unmap(_bufferVertex, 0);
+
+	return 0;
+#else
+#if CC_RENDERER_STREAM_VBO
+    if (_streamVertexBuffers)
+    {
+        if (_streamOffset + _numQuads > _quadsCapacity)
+        {
+            // The current buffer is full. Fence it and continue at the start of the next one,
+            // once the GPU is done with the draws that were fenced the last time it was used.
+            _vertexBufferFences[_currentVertexBuffer] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            _currentVertexBuffer = (_currentVertexBuffer + 1) % VERTEX_BUFFER_COUNT;
+            _streamOffset = 0;
+
+            GLsync fence = _vertexBufferFences[_currentVertexBuffer];
+            if (fence)
+            {
+                while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+                glDeleteSync(fence);
+                _vertexBufferFences[_currentVertexBuffer] = nullptr;
+            }
+        }
+
+        // the range is not used by any pending draw, so there is no need to synchronize
+        GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[_currentVertexBuffer]);
+        void *buf = glMapBufferRange(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _streamOffset, sizeof(_quads[0]) * _numQuads,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (buf)
+        {
+            memcpy(buf, _quads.data(), sizeof(_quads[0]) * _numQuads);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        else
+        {
+            // the mapping can fail, e.g. out of memory: the driver synchronizes the copy itself
+            glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _streamOffset, sizeof(_quads[0]) * _numQuads, _quads.data());
+        }
+
+        ssize_t firstQuad = _streamOffset;
+        _streamOffset += _numQuads;
+        return firstQuad;
+    }
+#endif
+
+    // rotate the buffers, so that a buffer still used by the previous batch isn't orphaned
+    _currentVertexBuffer = (_currentVertexBuffer + 1) % VERTEX_BUFFER_COUNT;
+    GL::bindBuffer(GL_ARRAY_BUFFER, _buffersVBO[_currentVertexBuffer]);
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        // orphaning + glMapBuffer
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _quadsCapacity, nullptr, GL_DYNAMIC_DRAW);
+        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+        if (buf)
+        {
+            memcpy(buf, _quads.data(), sizeof(_quads[0]) * _numQuads);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        else
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(_quads[0]) * _numQuads, _quads.data());
+        }
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _numQuads, _quads.data(), GL_DYNAMIC_DRAW);
+    }
+
+    return 0;
+#endif
+}
+
 void Renderer::addCommand(RenderCommand* command)
 {
-    int renderQueue =_commandGroupStack.top();
+    int renderQueue = _isVisitingInParallel ? getParallelVisitContext().commandGroupStack.top() : _commandGroupStack.top();
     addCommand(command, renderQueue);
 }
 
@@ -302,28 +620,256 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(!_isRendering, "Cannot add command while rendering");
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
+    if (_isVisitingInParallel)
+    {
+        // merged into _renderGroups once all the workers are done
+        getParallelVisitContext().slice->push_back(std::make_pair(renderQueue, command));
+        return;
+    }
     _renderGroups[renderQueue].push_back(command);
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
-    _commandGroupStack.push(renderQueueID);
+    if (_isVisitingInParallel)
+        getParallelVisitContext().commandGroupStack.push(renderQueueID);
+    else
+        _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
-    _commandGroupStack.pop();
+    if (_isVisitingInParallel)
+        getParallelVisitContext().commandGroupStack.pop();
+    else
+        _commandGroupStack.pop();
 }
 
 int Renderer::createRenderQueue()
 {
+    // GroupCommands might be initialized by several workers at the same time
+    std::lock_guard<std::mutex> lock(_renderQueuesMutex);
     RenderQueue newRenderQueue;
     _renderGroups.push_back(newRenderQueue);
     return (int)_renderGroups.size() - 1;
 }
 
+Renderer::ParallelVisitContext& Renderer::getParallelVisitContext()
+{
+    // index 0 is the cocos2d thread, which visits chunks too
+    return _parallelVisitContexts[ThreadPool::getInstance()->getWorkerIndex() + 1];
+}
+
+std::stack<Mat4>& Renderer::getParallelVisitMatrixStack()
+{
+    CCASSERT(_isVisitingInParallel, "Not visiting in parallel");
+    return getParallelVisitContext().modelViewMatrixStack;
+}
+
+std::vector<Renderer::ClipRect>& Renderer::getClipRects()
+{
+    return _isVisitingInParallel ? getParallelVisitContext().clipRects : _clipRects;
+}
+
+bool Renderer::pushClipRect(ScissorCommand* command, float globalOrder, const Rect& rect)
+{
+    auto& clipRects = getClipRects();
+
+    ClipRect clipRect;
+    clipRect.enabled = true;
+    clipRect.rect = rect;
+    if (!clipRects.empty() && clipRects.back().enabled)
+    {
+        // intersect with the parent clip
+        const Rect& parent = clipRects.back().rect;
+        float minX = std::max(rect.getMinX(), parent.getMinX());
+        float minY = std::max(rect.getMinY(), parent.getMinY());
+        float maxX = std::min(rect.getMaxX(), parent.getMaxX());
+        float maxY = std::min(rect.getMaxY(), parent.getMaxY());
+        clipRect.rect.setRect(minX, minY, std::max(0.0f, maxX - minX), std::max(0.0f, maxY - minY));
+    }
+    clipRects.push_back(clipRect);
+
+    command->init(globalOrder, true, clipRect.rect);
+    addCommand(command);
+
+    return clipRect.rect.size.width > 0 && clipRect.rect.size.height > 0;
+}
+
+void Renderer::pushNoClipRect(ScissorCommand* command, float globalOrder)
+{
+    auto& clipRects = getClipRects();
+
+    ClipRect clipRect;
+    clipRect.enabled = false;
+    clipRects.push_back(clipRect);
+
+    command->init(globalOrder, false, Rect::ZERO);
+    addCommand(command);
+}
+
+void Renderer::popClipRect(ScissorCommand* command, float globalOrder)
+{
+    auto& clipRects = getClipRects();
+    CCASSERT(!clipRects.empty(), "popClipRect without pushClipRect");
+    clipRects.pop_back();
+
+    if (clipRects.empty())
+    {
+        command->init(globalOrder, false, Rect::ZERO);
+    }
+    else
+    {
+        command->init(globalOrder, clipRects.back().enabled, clipRects.back().rect);
+    }
+    addCommand(command);
+}
+
+bool Renderer::isClipRectAvailable()
+{
+    auto& clipRects = getClipRects();
+    return clipRects.empty() || clipRects.back().enabled;
+}
+
+bool Renderer::transformClipRect(const Rect& rect, const Mat4& transform, Rect* outRect)
+{
+    // max distance, in points, between the corners of a rect still considered aligned
+    static const float ALIGNMENT_TOLERANCE = 0.01f;
+
+    Vec3 corners[4] = {
+        Vec3(rect.getMinX(), rect.getMinY(), 0),
+        Vec3(rect.getMaxX(), rect.getMinY(), 0),
+        Vec3(rect.getMaxX(), rect.getMaxY(), 0),
+        Vec3(rect.getMinX(), rect.getMaxY(), 0),
+    };
+    for (auto& corner : corners)
+    {
+        transform.transformPoint(&corner);
+    }
+
+    float minX = std::min(std::min(corners[0].x, corners[1].x), std::min(corners[2].x, corners[3].x));
+    float maxX = std::max(std::max(corners[0].x, corners[1].x), std::max(corners[2].x, corners[3].x));
+    float minY = std::min(std::min(corners[0].y, corners[1].y), std::min(corners[2].y, corners[3].y));
+    float maxY = std::max(std::max(corners[0].y, corners[1].y), std::max(corners[2].y, corners[3].y));
+    outRect->setRect(minX, minY, maxX - minX, maxY - minY);
+
+    // a perspective, or a depth with the 3D projection, moves the rect on the screen
+    const float* m = transform.m;
+    if (m[3] != 0 || m[7] != 0 || m[11] != 0 || m[15] != 1)
+        return false;
+
+    auto projection = Director::getInstance()->getProjection();
+    if (projection == Director::Projection::CUSTOM)
+        return false;
+
+    for (const auto& corner : corners)
+    {
+        if (projection == Director::Projection::_3D && fabsf(corner.z) > ALIGNMENT_TOLERANCE)
+            return false;
+    }
+
+    // every edge is either horizontal or vertical
+    return fabsf(corners[0].y - corners[1].y) <= ALIGNMENT_TOLERANCE && fabsf(corners[2].y - corners[3].y) <= ALIGNMENT_TOLERANCE &&
+           fabsf(corners[0].x - corners[3].x) <= ALIGNMENT_TOLERANCE && fabsf(corners[1].x - corners[2].x) <= ALIGNMENT_TOLERANCE;
+}
+
+void Renderer::applyScissor(const ScissorCommand* command)
+{
+    bool enabled = command->isEnabled();
+    const Rect& rect = command->getRect();
+    if (_scissorStateValid && enabled == _scissorEnabled && (!enabled || rect.equals(_scissorRect)))
+    {
+        // same clip: the batch goes on
+        return;
+    }
+
+    flush();
+
+    auto glview = Director::getInstance()->getOpenGLView();
+#if DIRECTX_ENABLED == 0
+    if (enabled)
+    {
+        // round the edges like the rasterizer does, so the clip matches a stencil of the same rect
+        const Rect& viewport = glview->getViewPortRect();
+        float scaleX = glview->getScaleX();
+        float scaleY = glview->getScaleY();
+        GLint x0 = (GLint)floorf(rect.getMinX() * scaleX + viewport.origin.x + 0.5f);
+        GLint x1 = (GLint)floorf(rect.getMaxX() * scaleX + viewport.origin.x + 0.5f);
+        GLint y0 = (GLint)floorf(rect.getMinY() * scaleY + viewport.origin.y + 0.5f);
+        GLint y1 = (GLint)floorf(rect.getMaxY() * scaleY + viewport.origin.y + 0.5f);
+        GL::scissor(x0, y0, std::max(0, x1 - x0), std::max(0, y1 - y0));
+    }
+    GL::enableScissorTest(enabled);
+#else
+    if (enabled)
+    {
+        glview->setScissorInPoints(rect.origin.x, rect.origin.y, rect.size.width, rect.size.height);
+    }
+    DXStateCache::getInstance().enableScissor(enabled);
+#endif
+
+    _scissorStateValid = true;
+    _scissorEnabled = enabled;
+    _scissorRect = rect;
+}
+
+void Renderer::visitInParallel(const Vector<Node*>& nodes, ssize_t first, ssize_t last, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    CCASSERT(!_isVisitingInParallel, "Nested parallel visits are not supported");
+
+    ssize_t count = last - first;
+    if (count <= 0)
+        return;
+
+    auto pool = ThreadPool::getInstance();
+    int chunks = (int)std::min<ssize_t>(pool->getThreadCount() + 1, count);
+
+    _parallelVisitContexts.resize(pool->getThreadCount() + 1);
+    _parallelVisitSlices.resize(chunks);
+    for (int i = 0; i < chunks; ++i)
+        _parallelVisitSlices[i].clear();
+
+    int renderQueue = _commandGroupStack.top();
+    Mat4 modelView = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+
+    auto visitChunk = [&](int chunk) {
+        auto& context = getParallelVisitContext();
+        context.slice = &_parallelVisitSlices[chunk];
+        context.commandGroupStack = std::stack<int>();
+        context.commandGroupStack.push(renderQueue);
+        context.modelViewMatrixStack = std::stack<Mat4>();
+        context.modelViewMatrixStack.push(modelView);
+        context.clipRects = _clipRects;
+
+        ssize_t begin = first + count * chunk / chunks;
+        ssize_t end = first + count * (chunk + 1) / chunks;
+        for (ssize_t i = begin; i < end; ++i)
+            nodes.at(i)->visit(this, parentTransform, parentFlags);
+
+        context.slice = nullptr;
+    };
+
+    _isVisitingInParallel = true;
+
+    // the cocos2d thread claims chunks too, so chunks queued behind long tasks (texture decodes,
+    // glyphs...) are visited by it instead of stalling the frame. Only the chunks already started are waited for
+    pool->parallelFor(chunks, [&](int begin, int end) {
+        for (int chunk = begin; chunk < end; ++chunk)
+            visitChunk(chunk);
+    });
+
+    _isVisitingInParallel = false;
+
+    // merge in node order: same queues, same order as a serial visit
+    for (int i = 0; i < chunks; ++i)
+    {
+        for (const auto& entry : _parallelVisitSlices[i])
+            _renderGroups[entry.first].push_back(entry.second);
+    }
+}
+
 void Renderer::visitRenderQueue(const RenderQueue& queue)
 {
     ssize_t size = queue.size();
@@ -335,23 +881,65 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
         if(RenderCommand::Type::QUAD_COMMAND == commandType)
         {
             flush3D();
+            if (!_batchedTrianglesCommands.empty())
+            {
+                // the pending triangles must be drawn first
+                flush2D();
+            }
             auto cmd = static_cast<QuadCommand*>(command);
-            //Batch quads
-            if(_numQuads + cmd->getQuadCount() > VBO_SIZE)
+            if(cmd->getMaterialID() == QuadCommand::MATERIAL_ID_DO_NOT_BATCH)
+            {
+                _unbatchableQuadCommands++;
+            }
+            //Batch quads, growing the VBO if needed
+            ssize_t quadCount = cmd->getQuadCount();
+            const V3F_C4B_T2F_Quad* quads = cmd->getQuads();
+            if(_numQuads + quadCount > _quadsCapacity && !growQuadCapacity(_numQuads + quadCount))
             {
-                CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() < VBO_SIZE, "VBO is not big enough for quad data, please break the quad data down or use customized render command");
-                
                 //Draw batched quads if VBO is full
                 drawBatchedQuads();
             }
-            
-            _batchedQuadCommands.push_back(cmd);
-            
-            memcpy(_quads + _numQuads, cmd->getQuads(), sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount());
-            convertToWorldCoordinates(_quads + _numQuads, cmd->getQuadCount(), cmd->getModelView());
-            
-            _numQuads += cmd->getQuadCount();
 
+            //Commands bigger than the VBO, once at its max capacity, are split across several batches
+            while (true)
+            {
+                ssize_t count = std::min(quadCount, _quadsCapacity - _numQuads);
+                _batchedQuadCommands.push_back(cmd);
+                _batchedQuadCounts.push_back(count);
+
+                memcpy(&_quads[_numQuads], quads, sizeof(V3F_C4B_T2F_Quad) * count);
+                convertToWorldCoordinates(&_quads[_numQuads], count, cmd->getModelView());
+
+                _numQuads += count;
+                quads += count;
+                quadCount -= count;
+                if (quadCount <= 0)
+                    break;
+
+                drawBatchedQuads();
+            }
+
+        }
+        else if(RenderCommand::Type::TRIANGLES_COMMAND == commandType)
+        {
+            flush3D();
+            if (!_batchedQuadCommands.empty())
+            {
+                // the pending quads must be drawn first
+                flush2D();
+            }
+            auto cmd = static_cast<TrianglesCommand*>(command);
+            ssize_t vertexCount = cmd->getVertexCount();
+            if (_numTriangleVertices + vertexCount > (ssize_t)_triangleVertices.size())
+            {
+                _triangleVertices.resize(std::max<size_t>(_numTriangleVertices + vertexCount, _triangleVertices.size() * 2));
+            }
+
+            _batchedTrianglesCommands.push_back(cmd);
+
+            convertToWorldCoordinates(&_triangleVertices[_numTriangleVertices], cmd->getVertices(), vertexCount, cmd->getModelView());
+
+            _numTriangleVertices += vertexCount;
         }
         else if(RenderCommand::Type::GROUP_COMMAND == commandType)
         {
@@ -364,12 +952,19 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
             flush();
             auto cmd = static_cast<CustomCommand*>(command);
             cmd->execute();
+            // custom commands may set the scissor themselves
+            _scissorStateValid = false;
         }
         else if(RenderCommand::Type::BATCH_COMMAND == commandType)
         {
             flush();
             auto cmd = static_cast<BatchCommand*>(command);
             cmd->execute();
+            cmd->getTexture()->setLastUsedFrame(_frameStamp);
+        }
+        else if(RenderCommand::Type::SCISSOR_COMMAND == commandType)
+        {
+            applyScissor(static_cast<ScissorCommand*>(command));
         }
         else if (RenderCommand::Type::MESH_COMMAND == commandType)
         {
@@ -404,8 +999,12 @@ void Renderer::render()
     
     if (_glViewAssigned)
     {
+        // textures bound from now on are stamped with this frame, the TextureCache evicts the oldest ones first
+        _frameStamp = Director::getInstance()->getTotalFrames();
+
         // cleanup
-        _drawnBatches = _drawnVertices = 0;
+        _drawnBatches = _drawnVertices = _reorderSavedBatches = _unbatchableQuadCommands = 0;
+        _scissorStateValid = false;
 
         //Process render commands
         //1. Sort render commands based on ID
@@ -435,10 +1034,16 @@ void Renderer::clean()
 
     // Clear batch quad commands
     _batchedQuadCommands.clear();
+    _batchedQuadCounts.clear();
     _numQuads = 0;
+    _batchedTrianglesCommands.clear();
+    _numTriangleVertices = 0;
 
     _lastMaterialID = 0;
     _lastBatchedMeshCommand = nullptr;
+
+    // the clip rects are balanced unless a visit was interrupted
+    _clipRects.clear();
 }
 
 void Renderer::convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const Mat4& modelView)
@@ -446,21 +1051,163 @@ void Renderer::convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quanti
 //    kmMat4 matrixP, mvp;
 //    kmGLGetMatrix(KM_GL_PROJECTION, &matrixP);
 //    kmMat4Multiply(&mvp, &matrixP, &modelView);
-    for(ssize_t i=0; i<quantity; ++i)
+
+    // the 4 vertices of every quad are contiguous, so the whole run is transformed in one go
+    MathUtil::transformVertices(modelView.m, (float*)&quads[0].tl.vertices, quantity * 4, sizeof(V3F_C4B_T2F));
+}
+
+void Renderer::convertToWorldCoordinates(V3F_C4B_T2F* outVertices, const V2F_C4B_T2F* vertices, ssize_t quantity, const Mat4& modelView)
+{
+    // z is 0 in the node space
+    const float* m = modelView.m;
+    for (ssize_t i = 0; i < quantity; ++i)
+    {
+        float x = vertices[i].vertices.x;
+        float y = vertices[i].vertices.y;
+        outVertices[i].vertices.x = m[0] * x + m[4] * y + m[12];
+        outVertices[i].vertices.y = m[1] * x + m[5] * y + m[13];
+        outVertices[i].vertices.z = m[2] * x + m[6] * y + m[14];
+        outVertices[i].colors = vertices[i].colors;
+        outVertices[i].texCoords = vertices[i].texCoords;
+    }
+}
+
+// how many groups a command may jump over to join a group with the same material
+static const int REORDER_MAX_LOOKBACK = 16;
+
+static bool isBatchBreak(uint32_t lastMaterialID, uint32_t materialID)
+{
+    return lastMaterialID != materialID || materialID == QuadCommand::MATERIAL_ID_DO_NOT_BATCH;
+}
+
+void Renderer::reorderBatchedQuads()
+{
+    int commandCount = (int)_batchedQuadCommands.size();
+    if (commandCount < 3)
+        return;
+
+    // same projection as the one GLProgram::setUniformsForBuiltins will use for these quads
+    Mat4 projection = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    const float* m = projection.m;
+
+    _reorderEntries.resize(commandCount);
+    _reorderGroups.clear();
+
+    ssize_t firstQuad = 0;
+    ssize_t batchesBefore = 0;
+    uint32_t lastMaterialID = _lastMaterialID;
+    for (int i = 0; i < commandCount; ++i)
+    {
+        auto& entry = _reorderEntries[i];
+        entry.command = _batchedQuadCommands[i];
+        entry.firstQuad = firstQuad;
+        entry.quadCount = _batchedQuadCounts[i];
+        entry.next = -1;
+        entry.minX = entry.minY = FLT_MAX;
+        entry.maxX = entry.maxY = -FLT_MAX;
+
+        ssize_t quadCount = entry.quadCount;
+        const V3F_C4B_T2F* vertices = &_quads[firstQuad].tl;
+        for (ssize_t v = 0; v < quadCount * 4; ++v)
+        {
+            const Vec3& p = vertices[v].vertices;
+            float w = p.x * m[3] + p.y * m[7] + p.z * m[11] + m[15];
+            if (w <= 0)
+            {
+                // behind the eye: can't be bounded, so it overlaps everything
+                entry.minX = entry.minY = -FLT_MAX;
+                entry.maxX = entry.maxY = FLT_MAX;
+                break;
+            }
+            float x = (p.x * m[0] + p.y * m[4] + p.z * m[8] + m[12]) / w;
+            float y = (p.x * m[1] + p.y * m[5] + p.z * m[9] + m[13]) / w;
+            entry.minX = std::min(entry.minX, x);
+            entry.maxX = std::max(entry.maxX, x);
+            entry.minY = std::min(entry.minY, y);
+            entry.maxY = std::max(entry.maxY, y);
+        }
+        firstQuad += quadCount;
+
+        uint32_t materialID = entry.command->getMaterialID();
+        if (isBatchBreak(lastMaterialID, materialID))
+            ++batchesBefore;
+        lastMaterialID = materialID;
+
+        // look for an earlier group with the same material that the command can join
+        // without jumping over anything it overlaps
+        int target = -1;
+        if (materialID != QuadCommand::MATERIAL_ID_DO_NOT_BATCH)
+        {
+            int lookback = 0;
+            for (int g = (int)_reorderGroups.size() - 1; g >= 0 && lookback < REORDER_MAX_LOOKBACK; --g, ++lookback)
+            {
+                const auto& group = _reorderGroups[g];
+                if (group.materialID == materialID)
+                {
+                    target = g;
+                    break;
+                }
+                if (entry.minX <= group.maxX && group.minX <= entry.maxX &&
+                    entry.minY <= group.maxY && group.minY <= entry.maxY)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (target < 0)
+        {
+            ReorderGroup group;
+            group.materialID = materialID;
+            group.minX = entry.minX; group.minY = entry.minY;
+            group.maxX = entry.maxX; group.maxY = entry.maxY;
+            group.first = group.last = i;
+            _reorderGroups.push_back(group);
+        }
+        else
+        {
+            auto& group = _reorderGroups[target];
+            _reorderEntries[group.last].next = i;
+            group.last = i;
+            group.minX = std::min(group.minX, entry.minX);
+            group.minY = std::min(group.minY, entry.minY);
+            group.maxX = std::max(group.maxX, entry.maxX);
+            group.maxY = std::max(group.maxY, entry.maxY);
+        }
+    }
+
+    // count the batches of the new order like drawBatchedQuads does
+    ssize_t batchesAfter = 0;
+    lastMaterialID = _lastMaterialID;
+    for (const auto& group : _reorderGroups)
     {
-        V3F_C4B_T2F_Quad *q = &quads[i];
-        Vec3 *vec1 = (Vec3*)&q->bl.vertices;
-        modelView.transformPoint(vec1);
+        if (isBatchBreak(lastMaterialID, group.materialID))
+            ++batchesAfter;
+        lastMaterialID = group.materialID;
+        // DO_NOT_BATCH groups only ever hold one command
+    }
 
-        Vec3 *vec2 = (Vec3*)&q->br.vertices;
-        modelView.transformPoint(vec2);
+    if (batchesAfter >= batchesBefore)
+        return;
 
-        Vec3 *vec3 = (Vec3*)&q->tr.vertices;
-        modelView.transformPoint(vec3);
+    _reorderSavedBatches += batchesBefore - batchesAfter;
 
-        Vec3 *vec4 = (Vec3*)&q->tl.vertices;
-        modelView.transformPoint(vec4);
+    _reorderedQuads.resize(_numQuads);
+    ssize_t quadIndex = 0;
+    int commandIndex = 0;
+    for (const auto& group : _reorderGroups)
+    {
+        for (int i = group.first; i >= 0; i = _reorderEntries[i].next)
+        {
+            const auto& entry = _reorderEntries[i];
+            ssize_t quadCount = entry.quadCount;
+            memcpy(&_reorderedQuads[quadIndex], &_quads[entry.firstQuad], sizeof(V3F_C4B_T2F_Quad) * quadCount);
+            quadIndex += quadCount;
+            _batchedQuadCommands[commandIndex] = entry.command;
+            _batchedQuadCounts[commandIndex++] = quadCount;
+        }
     }
+    memcpy(_quads.data(), _reorderedQuads.data(), sizeof(V3F_C4B_T2F_Quad) * _numQuads);
 }
 
 void Renderer::drawBatchedQuads()
@@ -468,7 +1215,6 @@ void Renderer::drawBatchedQuads()
     //TODO we can improve the draw performance by insert material switching command before hand.
 
     int quadsToDraw = 0;
-    int startQuad = 0;
 
     //Upload buffer to VBO
     if(_numQuads <= 0 || _batchedQuadCommands.empty())
@@ -476,51 +1222,34 @@ void Renderer::drawBatchedQuads()
         return;
     }
 
-#if (DIRECTX_ENABLED == 1)
-	auto view = GLView::sharedOpenGLView();
+    if (_batchReorderingEnabled)
+    {
+        reorderBatchedQuads();
+    }
 
-	if (!_bufferVertex || !_bufferIndex)
-		mapBuffers();
+    ssize_t startQuad = uploadBatchedQuads();
 
-	D3D11_MAPPED_SUBRESOURCE resource;
-	view->GetContext()->Map(_bufferVertex, 0, D3D11_MAP_WRITE_DISCARD, 0, &resource);
-	memcpy(resource.pData, _quads, sizeof(_quads[0]) * _numQuads);
-	view->GetContext()->Unmap(_bufferVertex, 0);
+#if (DIRECTX_ENABLED == 1)
+	auto view = GLView::sharedOpenGLView();
 
 	DXStateCache::getInstance().setVertexBuffer(_bufferVertex, sizeof(V3F_C4B_T2F), 0);
 	DXStateCache::getInstance().setIndexBuffer(_bufferIndex);
 	DXStateCache::getInstance().setPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	
 #else
+    GLenum indexType = _useUintIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    size_t indexSize = _useUintIndices ? sizeof(GLuint) : sizeof(GLushort);
+
     if (Configuration::getInstance()->supportsShareableVAO())
     {
-        //Set VBO data
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        // option 1: subdata
-//        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
-
-        // option 2: data
-//        glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
-
-        // option 3: orphaning + glMapBuffer
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * (_numQuads), nullptr, GL_DYNAMIC_DRAW);
-        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _quads, sizeof(_quads[0])* (_numQuads));
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
 
         //Bind VAO
-        GL::bindVAO(_quadVAO);
+        GL::bindVAO(_quadVAOs[_currentVertexBuffer]);
     }
     else
     {
 #define kQuadSize sizeof(_quads[0].bl)
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _numQuads , _quads, GL_DYNAMIC_DRAW);
-
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
         // vertices
@@ -532,13 +1261,14 @@ void Renderer::drawBatchedQuads()
         // tex coords
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[VERTEX_BUFFER_COUNT]);
     }
 #endif
 
     //Start drawing verties in batch
-    for(const auto& cmd : _batchedQuadCommands)
+    for(size_t i = 0; i < _batchedQuadCommands.size(); ++i)
     {
+        auto cmd = _batchedQuadCommands[i];
         auto newMaterialID = cmd->getMaterialID();
         if(_lastMaterialID != newMaterialID || newMaterialID == QuadCommand::MATERIAL_ID_DO_NOT_BATCH)
         {
@@ -546,9 +1276,9 @@ void Renderer::drawBatchedQuads()
             if(quadsToDraw > 0)
             {
 #if (DIRECTX_ENABLED == 1)                
-				view->GetContext()->DrawIndexed(quadsToDraw * 6, startQuad * 6, 0);
+				view->GetContext()->DrawIndexed(quadsToDraw * 6, (UINT) startQuad * 6, 0);
 #else
-                glDrawElements(GL_TRIANGLES, (GLsizei) quadsToDraw*6, GL_UNSIGNED_SHORT, (GLvoid*) (startQuad*6*sizeof(_indices[0])) );
+                glDrawElements(GL_TRIANGLES, (GLsizei) quadsToDraw*6, indexType, (GLvoid*) (startQuad*6*indexSize) );
 #endif
                 _drawnBatches++;
                 _drawnVertices += quadsToDraw*6;
@@ -559,19 +1289,20 @@ void Renderer::drawBatchedQuads()
 
             //Use new material
             cmd->useMaterial();
+            cmd->getTexture()->setLastUsedFrame(_frameStamp);
             _lastMaterialID = newMaterialID;
         }
 
-        quadsToDraw += cmd->getQuadCount();
+        quadsToDraw += _batchedQuadCounts[i];
     }
 
     //Draw any remaining quad
     if(quadsToDraw > 0)
     {
 #if (DIRECTX_ENABLED == 1)   
-		view->GetContext()->DrawIndexed(quadsToDraw * 6, startQuad * 6, 0);
+		view->GetContext()->DrawIndexed(quadsToDraw * 6, (UINT) startQuad * 6, 0);
 #else
-        glDrawElements(GL_TRIANGLES, (GLsizei) quadsToDraw*6, GL_UNSIGNED_SHORT, (GLvoid*) (startQuad*6*sizeof(_indices[0])) );
+        glDrawElements(GL_TRIANGLES, (GLsizei) quadsToDraw*6, indexType, (GLvoid*) (startQuad*6*indexSize) );
 #endif
         _drawnBatches++;
         _drawnVertices += quadsToDraw*6;
@@ -584,15 +1315,89 @@ void Renderer::drawBatchedQuads()
     }
     else
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 #endif
 
     _batchedQuadCommands.clear();
+    _batchedQuadCounts.clear();
     _numQuads = 0;
 }
 
+void Renderer::drawBatchedTriangles()
+{
+    if(_numTriangleVertices <= 0 || _batchedTrianglesCommands.empty())
+    {
+        return;
+    }
+
+#if (DIRECTX_ENABLED == 1)
+    CCASSERT(false, "Not supported yet.");
+#else
+    GL::bindBuffer(GL_ARRAY_BUFFER, _trianglesVBO);
+    // the storage used by the previous batch is orphaned
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_triangleVertices[0]) * _numTriangleVertices, _triangleVertices.data(), GL_STREAM_DRAW);
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+        GL::bindVAO(_trianglesVAO);
+    }
+    else
+    {
+        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof(V3F_C4B_T2F, colors));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
+    }
+
+    ssize_t firstVertex = 0;
+    ssize_t verticesToDraw = 0;
+    for(const auto& cmd : _batchedTrianglesCommands)
+    {
+        auto newMaterialID = cmd->getMaterialID();
+        if(_lastMaterialID != newMaterialID || newMaterialID == QuadCommand::MATERIAL_ID_DO_NOT_BATCH)
+        {
+            if(verticesToDraw > 0)
+            {
+                glDrawArrays(GL_TRIANGLES, (GLint) firstVertex, (GLsizei) verticesToDraw);
+                _drawnBatches++;
+                _drawnVertices += verticesToDraw;
+
+                firstVertex += verticesToDraw;
+                verticesToDraw = 0;
+            }
+
+            cmd->useMaterial();
+            _lastMaterialID = newMaterialID;
+        }
+
+        verticesToDraw += cmd->getVertexCount();
+    }
+
+    if(verticesToDraw > 0)
+    {
+        glDrawArrays(GL_TRIANGLES, (GLint) firstVertex, (GLsizei) verticesToDraw);
+        _drawnBatches++;
+        _drawnVertices += verticesToDraw;
+    }
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        GL::bindVAO(0);
+    }
+    else
+    {
+        GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+#endif
+
+    _batchedTrianglesCommands.clear();
+    _numTriangleVertices = 0;
+}
+
 void Renderer::flush()
 {
     flush2D();
@@ -602,6 +1407,7 @@ void Renderer::flush()
 void Renderer::flush2D()
 {
     drawBatchedQuads();
+    drawBatchedTriangles();
     _lastMaterialID = 0;
 }
 
@@ -28,8 +28,10 @@
 
 #include <vector>
 #include <stack>
+#include <mutex>
 
 #include "base/CCPlatformMacros.h"
+#include "base/CCVector.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
 #include "CCGL.h"
@@ -37,17 +39,24 @@
 NS_CC_BEGIN
 
 class EventListenerCustom;
+class Node;
 class QuadCommand;
 class MeshCommand;
+class ScissorCommand;
+class TrianglesCommand;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
  the correct order, the only `RenderCommand` objects that need to be sorted,
  are the ones that have `z < 0` and `z > 0`.
+ They are sorted by `RenderCommand::getSortKey()` with a stable LSD radix sort, so commands
+ with the same global order end up grouped by material, and keep their submission order otherwise.
 */
 class RenderQueue {
 
 public:
+    RenderQueue();
+
     void push_back(RenderCommand* command);
     ssize_t size() const;
     void sort();
@@ -55,9 +64,24 @@ public:
     void clear();
 
 protected:
+    struct SortEntry
+    {
+        uint64_t key;
+        RenderCommand* command;
+    };
+
+    void radixSort(std::vector<RenderCommand*>& queue);
+
     std::vector<RenderCommand*> _queueNegZ;
     std::vector<RenderCommand*> _queue0;
     std::vector<RenderCommand*> _queuePosZ;
+
+    // incremented around every command that can't be batched, in submission order
+    uint32_t _sortRun;
+
+    // scratch buffers, kept to avoid allocating every frame
+    std::vector<SortEntry> _sortEntries;
+    std::vector<SortEntry> _sortScratch;
 };
 
 struct RenderStackElement
@@ -68,6 +92,13 @@ struct RenderStackElement
 
 class GroupCommandManager;
 
+// Desktop GL can stream quads into fence protected vertex buffers with glMapBufferRange
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) && (DIRECTX_ENABLED == 0)
+#define CC_RENDERER_STREAM_VBO 1
+#else
+#define CC_RENDERER_STREAM_VBO 0
+#endif
+
 /* Class responsible for the rendering in.
 
 Whenever possible prefer to use `QuadCommand` objects since the renderer will automatically batch them.
@@ -75,7 +106,14 @@ Whenever possible prefer to use `QuadCommand` objects since the renderer will au
 class Renderer
 {
 public:
+    /** Initial number of quads that can be batched. The buffers grow when a batch needs more */
     static const int VBO_SIZE = 65536 / 6;
+    /** Maximum number of quads that can be batched with 16 bit indices */
+    static const int MAX_QUADS_16BIT_INDICES = 65536 / 4;
+    /** Maximum number of quads that can be batched with 32 bit indices */
+    static const int MAX_QUADS_32BIT_INDICES = 1 << 17;
+    /** Number of vertex buffers the quads are streamed into, in turns */
+    static const int VERTEX_BUFFER_COUNT = 3;
     static const int BATCH_QUADCOMMAND_RESEVER_SIZE = 64;
 
     Renderer();
@@ -119,7 +157,85 @@ public:
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
+    /** Enables regrouping the pending `QuadCommand`s by material before they are drawn.
+     A command is only moved ahead of commands it doesn't overlap in screen space, so the
+     result looks the same while issuing fewer draw calls. Default is false.
+     */
+    void setBatchReorderingEnabled(bool enabled) { _batchReorderingEnabled = enabled; }
+    bool isBatchReorderingEnabled() const { return _batchReorderingEnabled; }
+
+    /** returns the number of batches saved by the reordering in the last frame */
+    ssize_t getReorderSavedBatches() const { return _reorderSavedBatches; }
+
+    /** returns the number of `QuadCommand`s that couldn't be batched because of their uniforms in the last frame */
+    ssize_t getUnbatchableQuadCommands() const { return _unbatchableQuadCommands; }
+
+    /** returns the frame the textures drawn by the current render are stamped with */
+    unsigned int getFrameStamp() const { return _frameStamp; }
+
+    /** Minimum number of children a node must have before they are visited on the `ThreadPool`. Default is 64 */
+    void setParallelVisitThreshold(ssize_t threshold) { _parallelVisitThreshold = threshold; }
+    ssize_t getParallelVisitThreshold() const { return _parallelVisitThreshold; }
+
+    /** Returns whether `count` children can be visited in parallel: nested parallel visits are not supported */
+    bool canVisitInParallel(ssize_t count) const { return !_isVisitingInParallel && count >= _parallelVisitThreshold; }
+
+    /** Visits the nodes in [first, last) on the `ThreadPool`.
+     Every worker records its `RenderCommand`s into its own slice, and the slices are merged in
+     node order once all workers are done, so the render queues end up exactly as after a serial visit.
+     */
+    void visitInParallel(const Vector<Node*>& nodes, ssize_t first, ssize_t last, const Mat4& parentTransform, uint32_t parentFlags);
+
+    /** Returns true while `visitInParallel` is running */
+    bool isVisitingInParallel() const { return _isVisitingInParallel; }
+
+    /** Returns the model view stack of the calling worker. Only valid while visiting in parallel */
+    std::stack<Mat4>& getParallelVisitMatrixStack();
+
+    /** Clips the commands added until the matching popClipRect to `rect`, in world coordinates.
+     The rect is intersected with the current clip rect on the CPU, and applied with the scissor test.
+     `command` is added to the current render queue and must stay alive until the frame is rendered.
+     Returns false if the clipped rect is empty: nothing added until popClipRect will be visible.
+     */
+    bool pushClipRect(ScissorCommand* command, float globalOrder, const Rect& rect);
+
+    /** Disables clipping for the commands added until the matching popClipRect, e.g. while rendering into a texture */
+    void pushNoClipRect(ScissorCommand* command, float globalOrder);
+
+    /** Restores the clip rect that was current before the matching push */
+    void popClipRect(ScissorCommand* command, float globalOrder);
+
+    /** Whether pushClipRect can be used now. It can't while rendering into a texture, where world coordinates don't match the screen */
+    bool isClipRectAvailable();
+
+    /** Computes the rect covered on the screen by `rect` transformed by `transform`, in world coordinates.
+     Returns false when the transformed rect is not aligned with the axes of the screen: `outRect` is then its bounding box.
+     */
+    static bool transformClipRect(const Rect& rect, const Mat4& transform, Rect* outRect);
+
 protected:
+    struct ClipRect
+    {
+        bool enabled;
+        Rect rect;
+    };
+
+    struct ParallelVisitContext
+    {
+        // commands recorded by the chunk being visited, with their render queue ID
+        std::vector<std::pair<int, RenderCommand*>>* slice;
+        std::stack<int> commandGroupStack;
+        std::stack<Mat4> modelViewMatrixStack;
+        std::vector<ClipRect> clipRects;
+    };
+
+    // the clip rects pushed while visiting, on the calling worker when visiting in parallel
+    std::vector<ClipRect>& getClipRects();
+
+    // sets the scissor test of `command`, flushing the pending batches only if it changes
+    void applyScissor(const ScissorCommand* command);
+
+    ParallelVisitContext& getParallelVisitContext();
 
     void setupIndices();
     //Setup VBO or VAO based on OpenGL extensions
@@ -128,8 +244,19 @@ protected:
     void setupVBO();
     void mapBuffers();
 
+    //Grows the quad buffers so that they can hold quadCount quads. Returns false if they can't grow anymore
+    bool growQuadCapacity(ssize_t quadCount);
+    //Copies _quads into the current vertex buffer, and returns the index of the first quad in it
+    ssize_t uploadBatchedQuads();
+
     void drawBatchedQuads();
 
+    //Draws the triangles of the pending `TrianglesCommand`s, one draw call per material
+    void drawBatchedTriangles();
+
+    //Regroup _batchedQuadCommands by material when they don't overlap, and reorder _quads accordingly
+    void reorderBatchedQuads();
+
     //Draw the previews queued quads and flush previous context
     void flush();
     
@@ -140,6 +267,7 @@ protected:
     void visitRenderQueue(const RenderQueue& queue);
 
     void convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const Mat4& modelView);
+    void convertToWorldCoordinates(V3F_C4B_T2F* outVertices, const V2F_C4B_T2F* vertices, ssize_t quantity, const Mat4& modelView);
 
     std::stack<int> _commandGroupStack;
     
@@ -149,29 +277,88 @@ protected:
 
     MeshCommand*              _lastBatchedMeshCommand;
     std::vector<QuadCommand*> _batchedQuadCommands;
+    // quads batched for each command, less than its quad count when it is split across batches
+    std::vector<ssize_t> _batchedQuadCounts;
 
-    V3F_C4B_T2F_Quad _quads[VBO_SIZE];
-    GLushort _indices[6 * VBO_SIZE];
+    std::vector<V3F_C4B_T2F_Quad> _quads;
+    std::vector<GLushort> _indices;
+    std::vector<GLuint> _indices32;
+    ssize_t _quadsCapacity;
+    bool _useUintIndices;
 
 #if (DIRECTX_ENABLED == 1)
 	ID3D11Buffer* _bufferVertex;
 	ID3D11Buffer* _bufferIndex;
 #else
-    GLuint _quadVAO;
-    GLuint _buffersVBO[2]; //0: vertex  1: indices
+    GLuint _quadVAOs[VERTEX_BUFFER_COUNT];
+    GLuint _buffersVBO[VERTEX_BUFFER_COUNT + 1]; //0..VERTEX_BUFFER_COUNT-1: vertex  VERTEX_BUFFER_COUNT: indices
+    int _currentVertexBuffer;
+#if CC_RENDERER_STREAM_VBO
+    // quads are appended to the current vertex buffer without synchronization,
+    // and a fence protects it before moving to the next one
+    bool _streamVertexBuffers;
+    ssize_t _streamOffset;
+    GLsync _vertexBufferFences[VERTEX_BUFFER_COUNT];
+#endif
 #endif
 
     int _numQuads;
+
+    // triangles, drawn from their own vertex buffer. Quads and triangles are never pending at the same time
+    std::vector<TrianglesCommand*> _batchedTrianglesCommands;
+    std::vector<V3F_C4B_T2F> _triangleVertices;
+    ssize_t _numTriangleVertices;
+#if (DIRECTX_ENABLED == 0)
+    GLuint _trianglesVAO;
+    GLuint _trianglesVBO;
+#endif
     
     bool _glViewAssigned;
 
+    // batch reordering
+    struct ReorderEntry
+    {
+        QuadCommand* command;
+        ssize_t firstQuad;
+        ssize_t quadCount;
+        float minX, minY, maxX, maxY;
+        int next;
+    };
+    struct ReorderGroup
+    {
+        uint32_t materialID;
+        float minX, minY, maxX, maxY;
+        int first;
+        int last;
+    };
+    bool _batchReorderingEnabled;
+    std::vector<ReorderEntry> _reorderEntries;
+    std::vector<ReorderGroup> _reorderGroups;
+    std::vector<V3F_C4B_T2F_Quad> _reorderedQuads;
+
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _reorderSavedBatches;
+    ssize_t _unbatchableQuadCommands;
+    unsigned int _frameStamp;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     GroupCommandManager* _groupCommandManager;
+
+    // parallel visit
+    bool _isVisitingInParallel;
+    ssize_t _parallelVisitThreshold;
+    std::vector<ParallelVisitContext> _parallelVisitContexts;
+    std::vector<std::vector<std::pair<int, RenderCommand*>>> _parallelVisitSlices;
+    std::mutex _renderQueuesMutex;
+
+    // clip rects
+    std::vector<ClipRect> _clipRects;
+    bool _scissorStateValid;
+    bool _scissorEnabled;
+    Rect _scissorRect;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
@@ -0,0 +1,59 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef _CC_SCISSORCOMMAND_H_
+#define _CC_SCISSORCOMMAND_H_
+
+#include "renderer/CCRenderCommand.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+/** Sets the scissor test for the commands that follow it.
+ The renderer only breaks the current batch when the scissor actually changes,
+ so consecutive clips with the same rect don't cost a draw call.
+ ScissorCommands are created by Renderer::pushClipRect and Renderer::popClipRect.
+ */
+class ScissorCommand : public RenderCommand
+{
+public:
+    ScissorCommand();
+    ~ScissorCommand();
+
+    /** @param enabled whether the scissor test is enabled
+        @param rect the scissor rect in world coordinates (points), when enabled
+     */
+    void init(float globalOrder, bool enabled, const Rect& rect);
+
+    inline bool isEnabled() const { return _enabled; }
+    inline const Rect& getRect() const { return _rect; }
+
+protected:
+    bool _enabled;
+    Rect _rect;
+};
+
+NS_CC_END
+
+#endif //_CC_SCISSORCOMMAND_H_
@@ -0,0 +1,280 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCStringTextureCache.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
+#include "base/ccMacros.h"
+#include "deprecated/CCString.h"
+
+NS_CC_BEGIN
+
+static const size_t DEFAULT_MEMORY_LIMIT = 4 * 1024 * 1024;
+
+static StringTextureCache* s_sharedStringTextureCache = nullptr;
+
+StringTextureCache* StringTextureCache::getInstance()
+{
+    if (!s_sharedStringTextureCache)
+    {
+        s_sharedStringTextureCache = new StringTextureCache();
+    }
+
+    return s_sharedStringTextureCache;
+}
+
+void StringTextureCache::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedStringTextureCache);
+}
+
+StringTextureCache::StringTextureCache()
+: _useCount(0)
+, _memoryLimit(DEFAULT_MEMORY_LIMIT)
+{
+    memset(&_statistics, 0, sizeof(_statistics));
+}
+
+StringTextureCache::~StringTextureCache()
+{
+    // the strings still being rendered are dropped
+    auto pendingRequests = std::move(_pendingRequests);
+    for (auto& item : pendingRequests)
+    {
+        for (auto& callback : item.second)
+        {
+            callback(nullptr);
+        }
+    }
+
+    for (auto& item : _entries)
+    {
+        item.second.texture->release();
+    }
+}
+
+std::string StringTextureCache::getKey(const std::string& text, const FontDefinition& textDefinition)
+{
+    // the shadow is never rendered in the texture
+    const auto& stroke = textDefinition._stroke;
+    return StringUtils::format("%s|%d|%d|%d|%.2f|%.2f|%d,%d,%d|%d|%d,%d,%d|%.2f|%.2f|",
+        textDefinition._fontName.c_str(), textDefinition._fontSize,
+        (int)textDefinition._alignment, (int)textDefinition._vertAlignment,
+        textDefinition._dimensions.width, textDefinition._dimensions.height,
+        textDefinition._fontFillColor.r, textDefinition._fontFillColor.g, textDefinition._fontFillColor.b,
+        stroke._strokeEnabled ? 1 : 0, stroke._strokeColor.r, stroke._strokeColor.g, stroke._strokeColor.b, stroke._strokeSize,
+        CC_CONTENT_SCALE_FACTOR()) + text;
+}
+
+Texture2D* StringTextureCache::getTexture(const std::string& text, const FontDefinition& textDefinition)
+{
+    if (text.empty())
+    {
+        return nullptr;
+    }
+
+    auto key = getKey(text, textDefinition);
+    auto texture = findTexture(key);
+    if (texture)
+    {
+        return texture;
+    }
+
+    _statistics.misses++;
+    texture = new Texture2D();
+    if (!texture->initWithString(text.c_str(), textDefinition))
+    {
+        texture->release();
+        return nullptr;
+    }
+    return addTexture(key, texture);
+}
+
+void StringTextureCache::getTextureAsync(const std::string& text, const FontDefinition& textDefinition, const std::function<void(Texture2D*)>& callback)
+{
+    if (text.empty())
+    {
+        callback(nullptr);
+        return;
+    }
+
+    auto key = getKey(text, textDefinition);
+    auto texture = findTexture(key);
+    if (texture)
+    {
+        callback(texture);
+        return;
+    }
+
+    auto& requests = _pendingRequests[key];
+    requests.push_back(callback);
+    if (requests.size() > 1)
+    {
+        return;
+    }
+
+    _statistics.misses++;
+    ThreadPool::getInstance()->pushTask([key, text, textDefinition]{
+        struct RenderedString
+        {
+            Data data;
+            int width;
+            int height;
+            bool premultipliedAlpha;
+        };
+        std::shared_ptr<RenderedString> rendered(new RenderedString());
+        rendered->data = Texture2D::renderString(text.c_str(), textDefinition, rendered->width, rendered->height, rendered->premultipliedAlpha);
+
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([key, text, textDefinition, rendered]{
+            if (!s_sharedStringTextureCache)
+            {
+                return;
+            }
+
+            Texture2D* texture = nullptr;
+            if (!rendered->data.isNull())
+            {
+                texture = new Texture2D();
+                if (!texture->initWithRenderedString(text.c_str(), textDefinition, rendered->data, rendered->width, rendered->height, rendered->premultipliedAlpha))
+                {
+                    CC_SAFE_RELEASE_NULL(texture);
+                }
+            }
+            s_sharedStringTextureCache->onStringRendered(key, texture);
+        });
+    });
+}
+
+void StringTextureCache::onStringRendered(const std::string& key, Texture2D* texture)
+{
+    if (texture)
+    {
+        texture = addTexture(key, texture);
+    }
+
+    auto iter = _pendingRequests.find(key);
+    if (iter == _pendingRequests.end())
+    {
+        return;
+    }
+    auto callbacks = std::move(iter->second);
+    _pendingRequests.erase(iter);
+
+    // a callback may trim the cache: the texture is kept until they all ran
+    CC_SAFE_RETAIN(texture);
+    for (auto& callback : callbacks)
+    {
+        callback(texture);
+    }
+    CC_SAFE_RELEASE(texture);
+}
+
+void StringTextureCache::purge()
+{
+    trim(0);
+}
+
+void StringTextureCache::setMemoryLimit(size_t bytes)
+{
+    _memoryLimit = bytes;
+    trim(_memoryLimit);
+}
+
+Texture2D* StringTextureCache::findTexture(const std::string& key)
+{
+    auto iter = _entries.find(key);
+    if (iter == _entries.end())
+    {
+        return nullptr;
+    }
+
+    _statistics.hits++;
+    iter->second.lastUse = ++_useCount;
+    return iter->second.texture;
+}
+
+Texture2D* StringTextureCache::addTexture(const std::string& key, Texture2D* texture)
+{
+    auto iter = _entries.find(key);
+    if (iter != _entries.end())
+    {
+        // rendered synchronously while it was being rendered on the ThreadPool
+        texture->release();
+        iter->second.lastUse = ++_useCount;
+        return iter->second.texture;
+    }
+
+    // the texture is returned before anybody retains it, so it can't be trimmed right away
+    trim(_memoryLimit);
+
+    Entry entry;
+    entry.texture = texture;
+    entry.memorySize = (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+    entry.lastUse = ++_useCount;
+    _entries[key] = entry;
+
+    _statistics.cached++;
+    _statistics.cachedMemory += entry.memorySize;
+    return texture;
+}
+
+void StringTextureCache::trim(size_t memoryLimit)
+{
+    if (_statistics.cachedMemory <= memoryLimit)
+    {
+        return;
+    }
+
+    // only the textures retained by the cache alone can go, the least recently used first
+    std::vector<std::unordered_map<std::string, Entry>::iterator> unusedEntries;
+    for (auto iter = _entries.begin(); iter != _entries.end(); ++iter)
+    {
+        if (iter->second.texture->getReferenceCount() == 1)
+        {
+            unusedEntries.push_back(iter);
+        }
+    }
+    std::sort(unusedEntries.begin(), unusedEntries.end(), [](const std::unordered_map<std::string, Entry>::iterator& a, const std::unordered_map<std::string, Entry>::iterator& b){
+        return a->second.lastUse < b->second.lastUse;
+    });
+
+    for (auto& iter : unusedEntries)
+    {
+        if (_statistics.cachedMemory <= memoryLimit)
+        {
+            break;
+        }
+        _statistics.cached--;
+        _statistics.cachedMemory -= iter->second.memorySize;
+        iter->second.texture->release();
+        _entries.erase(iter);
+    }
+}
+
+NS_CC_END
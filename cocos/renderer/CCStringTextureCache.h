@@ -0,0 +1,123 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCSTRINGTEXTURECACHE_H__
+#define __CCSTRINGTEXTURECACHE_H__
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/CCPlatformMacros.h"
+#include "base/ccTypes.h"
+#include "renderer/CCTexture2D.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @brief Shares the textures of the strings rendered with the system fonts.
+
+ Textures are keyed by the text and the FontDefinition, dimensions included, so the labels showing the same
+ text with the same font share a single texture. The cache keeps a reference to each texture. The textures nobody
+ else retains are destroyed, least recently used first, once the cached textures use more than the memory limit.
+
+ Strings can also be rendered on the ThreadPool: the texture is created on the cocos2d thread once the pixels are ready.
+ It must be used on the cocos2d thread.
+ @since v3.2
+ */
+class CC_DLL StringTextureCache
+{
+public:
+    struct Statistics
+    {
+        /** Textures returned from the cache */
+        unsigned int hits;
+        /** Strings rendered because they weren't cached */
+        unsigned int misses;
+        /** Textures cached, and their memory */
+        unsigned int cached;
+        size_t cachedMemory;
+    };
+
+    /** Returns the shared cache */
+    static StringTextureCache* getInstance();
+
+    /** Destroys the shared cache. The pending asynchronous requests get a nullptr texture */
+    static void destroyInstance();
+
+    /** Returns the texture of the string, rendering it if it isn't cached, or nullptr if it can't be rendered.
+     The cache keeps the reference: retain the texture to use it
+     */
+    Texture2D* getTexture(const std::string& text, const FontDefinition& textDefinition);
+
+    /** Same as getTexture(), but the string is rendered on the ThreadPool. `callback` is called on the cocos2d thread
+     once the texture is ready, right away if it is cached. Requests for a string already being rendered share the rendering
+     */
+    void getTextureAsync(const std::string& text, const FontDefinition& textDefinition, const std::function<void(Texture2D*)>& callback);
+
+    /** Destroys the cached textures nobody else retains */
+    void purge();
+
+    /** Sets the memory the cached textures can use, in bytes. Defaults to 4 MB */
+    void setMemoryLimit(size_t bytes);
+    inline size_t getMemoryLimit() const { return _memoryLimit; }
+
+    inline const Statistics& getStatistics() const { return _statistics; }
+
+protected:
+    struct Entry
+    {
+        Texture2D* texture;
+        size_t memorySize;
+        unsigned int lastUse;
+    };
+
+    StringTextureCache();
+    ~StringTextureCache();
+
+    static std::string getKey(const std::string& text, const FontDefinition& textDefinition);
+
+    Texture2D* findTexture(const std::string& key);
+    Texture2D* addTexture(const std::string& key, Texture2D* texture);
+    void onStringRendered(const std::string& key, Texture2D* texture);
+    void trim(size_t memoryLimit);
+
+    std::unordered_map<std::string, Entry> _entries;
+    std::unordered_map<std::string, std::vector<std::function<void(Texture2D*)>>> _pendingRequests;
+    unsigned int _useCount;
+    size_t _memoryLimit;
+    Statistics _statistics;
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif // __CCSTRINGTEXTURECACHE_H__
@@ -33,6 +33,8 @@ THE SOFTWARE.
 
 #include "renderer/CCTexture2D.h"
 
+#include <mutex>
+
 #include "CCGL.h"
 #include "platform/CCImage.h"
 #include "base/ccUtils.h"
@@ -44,6 +46,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/ccPixelConversion.h"
 #include "renderer/CCGLProgramCache.h"
 
 #include "deprecated/CCString.h"
@@ -291,13 +294,7 @@ void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsi
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = data[i];         //R
-        *outData++ = data[i + 1];     //G
-        *outData++ = data[i + 2];     //B
-        *outData++ = 0xFF;            //A
-    }
+    PixelConversion::convertRGB888ToRGBA8888(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
@@ -314,125 +311,68 @@ void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00FC) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 3;    //B
-    }
+    PixelConversion::convertRGB888ToRGB565(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00FC) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 3;    //B
-    }
+    PixelConversion::convertRGBA8888ToRGB565(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIII
 void Texture2D::convertRGB888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-    }
+    PixelConversion::convertRGB888ToI8(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIII
 void Texture2D::convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-    }
+    PixelConversion::convertRGBA8888ToI8(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
 void Texture2D::convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen -3; i < l; i += 4)
-    {
-        *outData++ = data[i + 3]; //A
-    }
+    PixelConversion::convertRGBA8888ToA8(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIIIAAAAAAAA
 void Texture2D::convertRGB888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-        *outData++ = 0xFF;
-    }
+    PixelConversion::convertRGB888ToAI88(data, dataLen, outData);
 }
 
 
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIIIAAAAAAAA
 void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-        *outData++ = data[i + 3];
-    }
+    PixelConversion::convertRGBA8888ToAI88(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *out16++ = ((data[i] & 0x00F0) << 8           //R
-                    | (data[i + 1] & 0x00F0) << 4     //G
-                    | (data[i + 2] & 0xF0)            //B
-                    |  0x0F);                         //A
-    }
+    PixelConversion::convertRGB888ToRGBA4444(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i + 1] & 0x00F0) << 4         //G
-        | (data[i + 2] & 0xF0)                //B
-        |  (data[i + 3] & 0xF0) >> 4;         //A
-    }
+    PixelConversion::convertRGBA8888ToRGBA4444(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00F8) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 2     //B
-            |  0x01;                          //A
-    }
+    PixelConversion::convertRGB888ToRGB5A1(data, dataLen, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00F8) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 2     //B
-            |  (data[i + 3] & 0x0080) >> 7;   //A
-    }
+    PixelConversion::convertRGBA8888ToRGB5A1(data, dataLen, outData);
 }
 
 void Texture2D::convertRGBA4444ToBGRA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
@@ -460,6 +400,7 @@ Texture2D::Texture2D()
 , _hasMipmaps(false)
 , _shaderProgram(nullptr)
 , _antialiasEnabled(true)
+, _lastUsedFrame(0)
 #if (DIRECTX_ENABLED == 1)
 , _texture(nullptr)
 , _textureView(nullptr)
@@ -941,22 +882,54 @@ bool Texture2D::initWithImage(Image *image, PixelFormat format)
             free(outTempData);
         }
 
-        // set the premultiplied tag
-        if (!image->hasPremultipliedAlpha())
+        setPremultipliedAlphaFromImage(image);
+        return true;
+    }
+}
+
+#if (DIRECTX_ENABLED == 0)
+bool Texture2D::initWithImage(Image *image, GLuint name)
+{
+    CCASSERT(image != nullptr && name != 0, "Invalid image or texture name");
+
+    if(_name != 0)
+    {
+        GL::deleteTexture(_name);
+    }
+    _name = name;
+
+    _contentSize = Size((float)image->getWidth(), (float)image->getHeight());
+    _pixelsWide = image->getWidth();
+    _pixelsHigh = image->getHeight();
+    _pixelFormat = image->getRenderFormat();
+    _maxS = 1;
+    _maxT = 1;
+    _hasMipmaps = image->getNumberOfMipmaps() > 1;
+
+    setPremultipliedAlphaFromImage(image);
+
+    // shader
+    setGLProgram(GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE));
+    return true;
+}
+#endif
+
+void Texture2D::setPremultipliedAlphaFromImage(Image* image)
+{
+    // set the premultiplied tag
+    if (!image->hasPremultipliedAlpha())
+    {
+        if (image->getFileType() == Image::Format::PVR)
         {
-            if (image->getFileType() == Image::Format::PVR)
-            {
-                _hasPremultipliedAlpha = _PVRHaveAlphaPremultiplied;
-            }else
-            {
-                CCLOG("wanning: We cann't find the data is premultiplied or not, we will assume it's false.");
-                _hasPremultipliedAlpha = false;
-            }
+            _hasPremultipliedAlpha = _PVRHaveAlphaPremultiplied;
         }else
         {
-            _hasPremultipliedAlpha = image->isPremultipliedAlpha();
+            CCLOG("wanning: We cann't find the data is premultiplied or not, we will assume it's false.");
+            _hasPremultipliedAlpha = false;
         }
-        return true;
+    }else
+    {
+        _hasPremultipliedAlpha = image->isPremultipliedAlpha();
     }
 }
 
@@ -1238,12 +1211,24 @@ bool Texture2D::initWithString(const char *text, const FontDefinition& textDefin
         return false;
     }
 
+    int imageWidth;
+    int imageHeight;
+    bool hasPremultipliedAlpha;
+    Data outData = renderString(text, textDefinition, imageWidth, imageHeight, hasPremultipliedAlpha);
+    if(outData.isNull())
+    {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-    // cache the texture data
-    VolatileTextureMgr::addStringTexture(this, text, textDefinition);
+        VolatileTextureMgr::addStringTexture(this, text, textDefinition);
 #endif
+        return false;
+    }
 
-    bool ret = false;
+    return initWithRenderedString(text, textDefinition, outData, imageWidth, imageHeight, hasPremultipliedAlpha);
+}
+
+Data Texture2D::renderString(const char *text, const FontDefinition& textDefinition, int &outWidth, int &outHeight, bool &outPremultipliedAlpha)
+{
+    Data outData;
     Device::TextAlign align;
     
     if (TextVAlignment::TOP == textDefinition._vertAlignment)
@@ -1264,19 +1249,13 @@ bool Texture2D::initWithString(const char *text, const FontDefinition& textDefin
     else
     {
         CCASSERT(false, "Not supported alignment format!");
-        return false;
+        return outData;
     }
     
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID) && (CC_TARGET_PLATFORM != CC_PLATFORM_IOS)
     CCASSERT(textDefinition._stroke._strokeEnabled == false, "Currently stroke only supported on iOS and Android!");
 #endif
 
-    PixelFormat      pixelFormat = g_defaultAlphaPixelFormat;
-    unsigned char* outTempData = nullptr;
-    ssize_t outTempDataLen = 0;
-
-    int imageWidth;
-    int imageHeight;
     auto textDef = textDefinition;
     auto contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
     textDef._fontSize *= contentScaleFactor;
@@ -1284,24 +1263,36 @@ bool Texture2D::initWithString(const char *text, const FontDefinition& textDefin
     textDef._dimensions.height *= contentScaleFactor;
     textDef._stroke._strokeSize *= contentScaleFactor;
     textDef._shadow._shadowEnabled = false;
-    
-    bool hasPremultipliedAlpha;
-    Data outData = Device::getTextureDataForText(text, textDef, align, imageWidth, imageHeight, hasPremultipliedAlpha);
-    if(outData.isNull())
-    {
-        return false;
-    }
 
-    Size  imageSize = Size((float)imageWidth, (float)imageHeight);
-    pixelFormat = convertDataToFormat(outData.getBytes(), imageWidth*imageHeight*4, PixelFormat::RGBA8888, pixelFormat, &outTempData, &outTempDataLen);
+    // the Device implementations render into shared contexts
+    static std::mutex s_renderStringMutex;
+    std::lock_guard<std::mutex> lock(s_renderStringMutex);
+    outData = Device::getTextureDataForText(text, textDef, align, outWidth, outHeight, outPremultipliedAlpha);
+    return outData;
+}
+
+bool Texture2D::initWithRenderedString(const char *text, const FontDefinition& textDefinition, const Data& data, int width, int height, bool premultipliedAlpha)
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // cache the texture data
+    VolatileTextureMgr::addStringTexture(this, text, textDefinition);
+#endif
+
+    bool ret = false;
+    PixelFormat      pixelFormat = g_defaultAlphaPixelFormat;
+    unsigned char* outTempData = nullptr;
+    ssize_t outTempDataLen = 0;
+
+    Size  imageSize = Size((float)width, (float)height);
+    pixelFormat = convertDataToFormat(data.getBytes(), width*height*4, PixelFormat::RGBA8888, pixelFormat, &outTempData, &outTempDataLen);
 
-    ret = initWithData(outTempData, outTempDataLen, pixelFormat, imageWidth, imageHeight, imageSize);
+    ret = initWithData(outTempData, outTempDataLen, pixelFormat, width, height, imageSize);
 
-    if (outTempData != nullptr && outTempData != outData.getBytes())
+    if (outTempData != nullptr && outTempData != data.getBytes())
     {
         free(outTempData);
     }
-    _hasPremultipliedAlpha = hasPremultipliedAlpha;
+    _hasPremultipliedAlpha = premultipliedAlpha;
 
     return ret;
 }
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <map>
 
 #include "base/CCRef.h"
+#include "base/CCData.h"
 #include "math/CCGeometry.h"
 #include "base/ccTypes.h"
 #ifdef EMSCRIPTEN
@@ -253,11 +254,31 @@ public:
     **/
     bool initWithImage(Image * image, PixelFormat format);
 
+#if (DIRECTX_ENABLED == 0)
+    /**
+    Initializes a texture from a GL texture holding the pixels of the image, uploaded through a context shared with the cocos2d one.
+    The pixels of the image must be in the format they were uploaded with. The texture takes the ownership of `name`.
+    @since v3.2
+    */
+    bool initWithImage(Image * image, GLuint name);
+#endif
+
     /** Initializes a texture from a string with dimensions, alignment, font name and font size */
     bool initWithString(const char *text,  const std::string &fontName, float fontSize, const Size& dimensions = Size(0, 0), TextHAlignment hAlignment = TextHAlignment::CENTER, TextVAlignment vAlignment = TextVAlignment::TOP);
     /** Initializes a texture from a string using a text definition*/
     bool initWithString(const char *text, const FontDefinition& textDefinition);
 
+    /** Renders a string with the system fonts into RGBA8888 pixels, the way initWithString() does.
+     It can be called from any thread: the renderings are serialized.
+     @since v3.2
+     */
+    static Data renderString(const char *text, const FontDefinition& textDefinition, int &outWidth, int &outHeight, bool &outPremultipliedAlpha);
+
+    /** Initializes a texture from the pixels returned by renderString(). The text is kept to render it again if the GL context is lost
+     @since v3.2
+     */
+    bool initWithRenderedString(const char *text, const FontDefinition& textDefinition, const Data& data, int width, int height, bool premultipliedAlpha);
+
     /** sets the min filter, mag filter, wrap s and wrap t texture parameters.
     If the texture size is NPOT (non power of 2), then in can only use GL_CLAMP_TO_EDGE in GL_TEXTURE_WRAP_{S,T}.
 
@@ -339,6 +360,12 @@ public:
     
     /** Gets the texture name */
     GLuint getName() const;
+
+    /** Stamps the texture with the frame it was last used in. The renderer does it when it binds the texture
+     @since v3.2
+     */
+    inline void setLastUsedFrame(unsigned int frame) { _lastUsedFrame = frame; }
+    inline unsigned int getLastUsedFrame() const { return _lastUsedFrame; }
     
     /** Gets max S */
     GLfloat getMaxS() const;
@@ -357,16 +384,18 @@ public:
     
 public:
     static const PixelFormatInfoMap& getPixelFormatInfoMap();
-    
-private:
-
-    /**convert functions*/
 
     /**
     Convert the format to the format param you specified, if the format is PixelFormat::Automatic, it will detect it automatically and convert to the closest format for you.
     It will return the converted format to you. if the outData != data, you must delete it manually.
+    It doesn't touch GL, so loaders may call it from any thread.
     */
     static PixelFormat convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
+    
+private:
+
+    /**convert functions*/
+
 
     static PixelFormat convertI8ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     static PixelFormat convertAI88ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
@@ -411,6 +440,8 @@ private:
 	static void convertRGBA4444ToBGRA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
 
 protected:
+    void setPremultipliedAlphaFromImage(Image* image);
+
     /** pixel format of the texture */
     Texture2D::PixelFormat _pixelFormat;
 
@@ -444,6 +475,8 @@ protected:
 
     bool _antialiasEnabled;
 
+    unsigned int _lastUsedFrame;
+
 #if (DIRECTX_ENABLED == 1)
 	ID3D11Texture2D* _texture;
 	ID3D11ShaderResourceView* _textureView;
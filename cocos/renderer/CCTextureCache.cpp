@@ -31,13 +31,19 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <chrono>
 
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCDynamicAtlas.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
+#include "renderer/ccGLStateCache.h"
+#include "CCGLView.h"
 
 #include "deprecated/CCString.h"
 
@@ -49,6 +55,13 @@ THE SOFTWARE.
 
 using namespace std;
 
+// desktop GL can upload textures from a context shared with the cocos2d one
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC) && (DIRECTX_ENABLED == 0) && !CC_USE_NULL_GL
+#define CC_ENABLE_BACKGROUND_UPLOAD 1
+#else
+#define CC_ENABLE_BACKGROUND_UPLOAD 0
+#endif
+
 NS_CC_BEGIN
 
 // implementation TextureCache
@@ -59,22 +72,25 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _asyncStructQueue(nullptr)
-, _imageInfoQueue(nullptr)
-, _needQuit(false)
-, _asyncRefCount(0)
+: _asyncRefCount(0)
+, _lastAsyncRequestId(0)
+, _asyncUploadBudget(4.0f)
+, _uploadThread(nullptr)
+, _memoryBudget(0)
+, _evictedTexturesCount(0)
+, _evictedBytes(0)
 {
+    _dynamicAtlas = new DynamicAtlas(this);
 }
 
 TextureCache::~TextureCache()
 {
     CCLOGINFO("deallocing TextureCache: %p", this);
 
+    CC_SAFE_DELETE(_dynamicAtlas);
+
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
-
-    CC_SAFE_DELETE(_loadingThread);
 }
 
 void TextureCache::destroyInstance()
@@ -95,7 +111,79 @@ std::string TextureCache::getDescription() const
     return StringUtils::format("<TextureCache | Number of textures = %d>", static_cast<int>(_textures.size()));
 }
 
+// Requests are shared by every caller of addImageAsync() for the same file.
+// The callbacks are only touched on the cocos2d thread, the rest is guarded by the queue mutex.
+struct TextureCache::AsyncRequest
+{
+    struct Callback
+    {
+        unsigned int id;
+        std::function<void(Texture2D*)> function;
+    };
+
+    std::string filename;
+    int priority;
+    Texture2D::PixelFormat pixelFormat;     // the default alpha pixel format when the image was requested
+    std::vector<Callback> callbacks;
+    Image* image;
+    GLuint textureName;     // uploaded by the loader context
+    bool decoding;
+    bool cancelled;
+};
+
+// Shared with the decoding tasks, so tasks still queued in the ThreadPool don't outlive it
+struct TextureCache::AsyncQueue
+{
+    std::mutex mutex;
+    std::condition_variable decodingCondition;
+    std::unordered_map<std::string, AsyncRequest*> requests;
+    std::vector<AsyncRequest*> pending;
+    std::vector<AsyncRequest*> decoded;
+    int decodingCount;
+    bool quit;
+
+    // background uploads
+    std::condition_variable uploadCondition;
+    std::vector<AsyncRequest*> uploads;
+    bool backgroundUpload;
+    bool stopUploading;
+
+    AsyncQueue() : decodingCount(0), quit(false), backgroundUpload(false), stopUploading(false) {}
+
+    ~AsyncQueue()
+    {
+        for (auto& it : requests)
+        {
+            CC_SAFE_RELEASE(it.second->image);
+            delete it.second;
+        }
+    }
+
+    // requests are few, a linear search keeps the priority up to date when duplicates are coalesced
+    static AsyncRequest* popHighestPriority(std::vector<AsyncRequest*>& requests)
+    {
+        if (requests.empty())
+            return nullptr;
+
+        auto best = requests.begin();
+        for (auto it = requests.begin() + 1; it != requests.end(); ++it)
+        {
+            if ((*it)->priority > (*best)->priority)
+                best = it;
+        }
+
+        AsyncRequest* request = *best;
+        requests.erase(best);
+        return request;
+    }
+};
+
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
+{
+    addImageAsync(path, callback, 0);
+}
+
+unsigned int TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, int priority)
 {
     Texture2D *texture = nullptr;
 
@@ -107,22 +195,46 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     if (texture != nullptr)
     {
-        callback(texture);
-        return;
+        if (callback)
+            callback(texture);
+        return 0;
     }
 
     // lazy init
-    if (_asyncStructQueue == nullptr)
-    {             
-        _asyncStructQueue = new queue<AsyncStruct*>();
-        _imageInfoQueue   = new deque<ImageInfo*>();        
+    if (!_asyncQueue)
+    {
+        _asyncQueue = std::make_shared<AsyncQueue>();
+    }
+
+    unsigned int requestId = ++_lastAsyncRequestId;
 
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
+    std::unique_lock<std::mutex> lock(_asyncQueue->mutex);
 
-        _needQuit = false;
+    auto found = _asyncQueue->requests.find(fullpath);
+    if (found != _asyncQueue->requests.end())
+    {
+        // coalesce with the request already queued for this file
+        AsyncRequest* request = found->second;
+        request->callbacks.push_back({requestId, callback});
+        request->priority = std::max(request->priority, priority);
+        request->cancelled = false;
+        return requestId;
     }
 
+    AsyncRequest* request = new AsyncRequest();
+    request->filename = fullpath;
+    request->priority = priority;
+    request->pixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+    request->callbacks.push_back({requestId, callback});
+    request->image = nullptr;
+    request->textureName = 0;
+    request->decoding = false;
+    request->cancelled = false;
+
+    _asyncQueue->requests[fullpath] = request;
+    _asyncQueue->pending.push_back(request);
+    lock.unlock();
+
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->schedule(schedule_selector(TextureCache::addImageAsyncCallBack), this, 0, false);
@@ -130,187 +242,382 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     ++_asyncRefCount;
 
-    // generate async struct
-    AsyncStruct *data = new AsyncStruct(fullpath, callback);
+    // every task decodes the pending image with the highest priority, not necessarily this one
+    auto queue = _asyncQueue;
+    ThreadPool::getInstance()->pushTask([queue](){ TextureCache::decodeNextImage(queue); });
 
-    // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
+    return requestId;
+}
+
+void TextureCache::cancelImageAsync(unsigned int requestId)
+{
+    if (!_asyncQueue || requestId == 0)
+        return;
 
-    _sleepCondition.notify_one();
+    std::lock_guard<std::mutex> lock(_asyncQueue->mutex);
+
+    for (auto it = _asyncQueue->requests.begin(); it != _asyncQueue->requests.end(); ++it)
+    {
+        AsyncRequest* request = it->second;
+        auto callback = std::find_if(request->callbacks.begin(), request->callbacks.end(), [requestId](const AsyncRequest::Callback& cb){ return cb.id == requestId; });
+        if (callback == request->callbacks.end())
+            continue;
+
+        request->callbacks.erase(callback);
+        if (!request->callbacks.empty())
+            return;
+
+        // nobody wants the image anymore
+        if (request->decoding)
+        {
+            // the worker can't be stopped, the image is dropped once decoded
+            request->cancelled = true;
+            return;
+        }
+
+        auto& decoded = _asyncQueue->decoded;
+        auto& list = std::find(decoded.begin(), decoded.end(), request) != decoded.end() ? decoded : _asyncQueue->pending;
+        list.erase(std::find(list.begin(), list.end(), request));
+        _asyncQueue->requests.erase(it);
+
+        CC_SAFE_RELEASE(request->image);
+        delete request;
+
+        --_asyncRefCount;
+        return;
+    }
 }
 
 void TextureCache::unbindImageAsync(const std::string& filename)
 {
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
+    if (!_asyncQueue)
+        return;
+
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+
+    std::lock_guard<std::mutex> lock(_asyncQueue->mutex);
+    auto found = _asyncQueue->requests.find(fullpath);
+    if (found != _asyncQueue->requests.end())
+    {
+        for (auto& callback : found->second->callbacks)
+            callback.function = nullptr;
+    }
+}
+
+void TextureCache::unbindAllImageAsync()
+{
+    if (!_asyncQueue)
+        return;
+
+    std::lock_guard<std::mutex> lock(_asyncQueue->mutex);
+    for (auto& it : _asyncQueue->requests)
+    {
+        for (auto& callback : it.second->callbacks)
+            callback.function = nullptr;
+    }
+}
+
+void TextureCache::decodeNextImage(std::shared_ptr<AsyncQueue> queue)
+{
+    AsyncRequest* request = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (queue->quit)
+            return;
+
+        request = AsyncQueue::popHighestPriority(queue->pending);
+        if (!request)
+            return;
+
+        request->decoding = true;
+        queue->decodingCount++;
+    }
+
+    Image* image = new Image();
+    if (image->initWithImageFileThreadSafe(request->filename))
     {
-        std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
-        auto found = std::find_if(_imageInfoQueue->begin(), _imageInfoQueue->end(), [&fullpath](ImageInfo* ptr)->bool{ return ptr->asyncStruct->filename == fullpath; });
-        if (found != _imageInfoQueue->end())
+        // convert to the format of the texture here, so the cocos2d thread only uploads it
+        if (image->getNumberOfMipmaps() <= 1 && !image->isCompressed())
         {
-            (*found)->asyncStruct->callback = nullptr;
+            unsigned char* outData = nullptr;
+            ssize_t outDataLen = 0;
+            auto format = Texture2D::convertDataToFormat(image->_data, image->_dataLen, image->_renderFormat, request->pixelFormat, &outData, &outDataLen);
+            if (outData != image->_data)
+            {
+                image->freeData();
+                image->_data = outData;
+                image->_dataLen = outDataLen;
+                image->_renderFormat = format;
+            }
         }
     }
-    _imageInfoMutex.unlock();
+    else
+    {
+        CCLOG("can not load %s", request->filename.c_str());
+        CC_SAFE_RELEASE_NULL(image);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        request->image = image;
+        if (image && queue->backgroundUpload)
+        {
+            // still in flight until the loader context uploaded it
+            queue->uploads.push_back(request);
+            queue->uploadCondition.notify_one();
+        }
+        else
+        {
+            request->decoding = false;
+            queue->decoded.push_back(request);
+        }
+        queue->decodingCount--;
+    }
+    queue->decodingCondition.notify_all();
 }
 
-void TextureCache::unbindAllImageAsync()
+#if CC_ENABLE_BACKGROUND_UPLOAD
+// Uploads with raw GL calls: the GL state cache belongs to the cocos2d context.
+// Returns 0 for the images the cocos2d thread has to upload itself.
+static GLuint uploadImageData(Image* image)
 {
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
+    const auto& infos = Texture2D::getPixelFormatInfoMap();
+    auto found = infos.find(image->getRenderFormat());
+    if (found == infos.end() || found->second.compressed)
+        return 0;
+
+    const Texture2D::PixelFormatInfo& info = found->second;
+    int mipmapsNum = std::max(image->getNumberOfMipmaps(), 1);
+
+    GLuint name = 0;
+    glGenTextures(1, &name);
+    glBindTexture(GL_TEXTURE_2D, name);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapsNum > 1 ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    int width = image->getWidth();
+    int height = image->getHeight();
+    for (int i = 0; i < mipmapsNum; ++i)
     {
-        std::for_each(_imageInfoQueue->begin(), _imageInfoQueue->end(), [](ImageInfo* ptr) { ptr->asyncStruct->callback = nullptr; });
+        const unsigned char* data = mipmapsNum > 1 ? image->getMipmaps()[i].address : image->getData();
+        glTexImage2D(GL_TEXTURE_2D, i, info.internalFormat, (GLsizei)width, (GLsizei)height, 0, info.format, info.type, data);
+
+        width = std::max(width >> 1, 1);
+        height = std::max(height >> 1, 1);
     }
-    _imageInfoMutex.unlock();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        glDeleteTextures(1, &name);
+        return 0;
+    }
+    return name;
 }
 
-void TextureCache::loadImage()
+void TextureCache::uploadImages(std::shared_ptr<AsyncQueue> queue, GLView* view)
 {
-    AsyncStruct *asyncStruct = nullptr;
+    view->makeSharedContextCurrent(true);
 
     while (true)
     {
-        std::queue<AsyncStruct*> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock();
-        if (pQueue->empty())
+        AsyncRequest* request = nullptr;
         {
-            _asyncStructQueueMutex.unlock();
-            if (_needQuit) {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            queue->uploadCondition.wait(lock, [&queue](){ return queue->stopUploading || !queue->uploads.empty(); });
+            if (queue->stopUploading)
                 break;
+
+            request = AsyncQueue::popHighestPriority(queue->uploads);
+        }
+
+        GLuint name = uploadImageData(request->image);
+        if (name)
+        {
+            // only publish the texture once the GPU has it, so the first draw doesn't wait for the upload
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+            if (GLEW_ARB_sync)
+            {
+                GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+                    ;
+                glDeleteSync(fence);
             }
-            else {
-                std::unique_lock<std::mutex> lk(_sleepMutex);
-                _sleepCondition.wait(lk);
-                continue;
+            else
+#endif
+            {
+                glFinish();
             }
         }
-        else
+
         {
-            asyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
-        }        
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            request->textureName = name;
+            request->decoding = false;
+            queue->decoded.push_back(request);
+        }
+    }
+
+    view->makeSharedContextCurrent(false);
+}
+#endif
+
+bool TextureCache::setBackgroundUploadEnabled(bool enabled)
+{
+#if CC_ENABLE_BACKGROUND_UPLOAD
+    if (enabled == isBackgroundUploadEnabled())
+        return enabled;
 
-        Image *image = nullptr;
-        bool generateImage = false;
+    GLView* view = Director::getInstance()->getOpenGLView();
 
-        auto it = _textures.find(asyncStruct->filename);
-        if( it == _textures.end() )
+    if (enabled)
+    {
+        if (!view || !view->createSharedContext())
         {
-           _imageInfoMutex.lock();
-           ImageInfo *imageInfo;
-           size_t pos = 0;
-           size_t infoSize = _imageInfoQueue->size();
-           for (; pos < infoSize; pos++)
-           {
-               imageInfo = (*_imageInfoQueue)[pos];
-               if(imageInfo->asyncStruct->filename.compare(asyncStruct->filename) == 0)
-                   break;
-           }
-           _imageInfoMutex.unlock();
-           if(infoSize == 0 || pos == infoSize)
-               generateImage = true;
+            CCLOG("cocos2d: TextureCache: no shared context, images are uploaded on the cocos2d thread");
+            return false;
         }
 
-        if (generateImage)
+        if (!_asyncQueue)
         {
-            const std::string& filename = asyncStruct->filename;
-            // generate image      
-            image = new Image();
-            if (image && !image->initWithImageFileThreadSafe(filename))
-            {
-                CC_SAFE_RELEASE(image);
-                CCLOG("can not load %s", filename.c_str());
-                continue;
-            }
-        }    
+            _asyncQueue = std::make_shared<AsyncQueue>();
+        }
 
-        // generate image info
-        ImageInfo *imageInfo = new ImageInfo();
-        imageInfo->asyncStruct = asyncStruct;
-        imageInfo->image = image;
+        _asyncQueue->mutex.lock();
+        _asyncQueue->backgroundUpload = true;
+        _asyncQueue->stopUploading = false;
+        _asyncQueue->mutex.unlock();
 
-        // put the image info into the queue
-        _imageInfoMutex.lock();
-        _imageInfoQueue->push_back(imageInfo);
-        _imageInfoMutex.unlock();
+        _uploadThread = new std::thread(&TextureCache::uploadImages, _asyncQueue, view);
+        return true;
     }
-    
-	if(_asyncStructQueue != nullptr)
+
+    {
+        std::lock_guard<std::mutex> lock(_asyncQueue->mutex);
+        _asyncQueue->backgroundUpload = false;
+        _asyncQueue->stopUploading = true;
+    }
+    _asyncQueue->uploadCondition.notify_all();
+    _uploadThread->join();
+    CC_SAFE_DELETE(_uploadThread);
+
+    // the images left are uploaded by the cocos2d thread
     {
-        delete _asyncStructQueue;
-	    _asyncStructQueue = nullptr;
-        delete _imageInfoQueue;
-	    _imageInfoQueue = nullptr;
+        std::lock_guard<std::mutex> lock(_asyncQueue->mutex);
+        for (auto request : _asyncQueue->uploads)
+        {
+            request->decoding = false;
+            _asyncQueue->decoded.push_back(request);
+        }
+        _asyncQueue->uploads.clear();
     }
+
+    if (view)
+        view->destroySharedContext();
+    return false;
+#else
+    CC_UNUSED_PARAM(enabled);
+    return false;
+#endif
 }
 
 void TextureCache::addImageAsyncCallBack(float dt)
 {
-    // the image is generated in loading thread
-    std::deque<ImageInfo*> *imagesQueue = _imageInfoQueue;
+    auto start = std::chrono::steady_clock::now();
 
-    _imageInfoMutex.lock();
-    if (imagesQueue->empty())
-    {
-        _imageInfoMutex.unlock();
-    }
-    else
+    while (true)
     {
-        ImageInfo *imageInfo = imagesQueue->front();
-        imagesQueue->pop_front();
-        _imageInfoMutex.unlock();
+        AsyncRequest* request = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_asyncQueue->mutex);
+            request = AsyncQueue::popHighestPriority(_asyncQueue->decoded);
+            if (request)
+                _asyncQueue->requests.erase(request->filename);
+        }
 
-        AsyncStruct *asyncStruct = imageInfo->asyncStruct;
-        Image *image = imageInfo->image;
+        if (!request)
+            break;
 
-        const std::string& filename = asyncStruct->filename;
+        Image *image = request->image;
+        const std::string& filename = request->filename;
 
         Texture2D *texture = nullptr;
-        if (image)
+        bool uploaded = false;
+        if (!request->cancelled)
         {
-            // generate texture in render thread
-            texture = new Texture2D();
-
-            texture->initWithImage(image);
-
+            auto it = _textures.find(filename);
+            if (it != _textures.end())
+            {
+                // loaded synchronously in the meantime
+                texture = it->second;
+            }
+            else if (image)
+            {
+                // generate texture in render thread
+                texture = new Texture2D();
+
+#if CC_ENABLE_BACKGROUND_UPLOAD
+                bool initialized = request->textureName ? texture->initWithImage(image, request->textureName) : texture->initWithImage(image, request->pixelFormat);
+                request->textureName = 0;
+#else
+                bool initialized = texture->initWithImage(image, request->pixelFormat);
+#endif
+                if (initialized)
+                {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-            // cache the texture file name
-            VolatileTextureMgr::addImageTexture(texture, filename);
+                    // cache the texture file name
+                    VolatileTextureMgr::addImageTexture(texture, filename);
 #endif
-            // cache the texture. retain it, since it is added in the map
-            _textures.insert( std::make_pair(filename, texture) );
-            texture->retain();
+                    // texture already retained, no need to re-retain it
+                    _textures.insert( std::make_pair(filename, texture) );
 
-            texture->autorelease();
+                    texture->setLastUsedFrame(Director::getInstance()->getTotalFrames());
+                    evictTextures(texture);
+                }
+                else
+                {
+                    CC_SAFE_RELEASE_NULL(texture);
+                }
+                uploaded = true;
+            }
         }
-        else
+
+#if CC_ENABLE_BACKGROUND_UPLOAD
+        // uploaded for nothing: cancelled, or loaded synchronously in the meantime
+        if (request->textureName)
         {
-            auto it = _textures.find(asyncStruct->filename);
-            if(it != _textures.end())
-                texture = it->second;
+            GL::deleteTexture(request->textureName);
         }
-        
-        if (asyncStruct->callback)
+#endif
+
+        for (auto& callback : request->callbacks)
         {
-            asyncStruct->callback(texture);
+            if (callback.function)
+                callback.function(texture);
         }
-        
-        if(image)
-        {
-            image->release();
-        }       
-        delete asyncStruct;
-        delete imageInfo;
+
+        CC_SAFE_RELEASE(image);
+        delete request;
 
         --_asyncRefCount;
-        if (0 == _asyncRefCount)
+
+        if (uploaded)
         {
-            Director::getInstance()->getScheduler()->unschedule(schedule_selector(TextureCache::addImageAsyncCallBack), this);
+            float elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0f;
+            if (elapsed >= _asyncUploadBudget)
+                break;
         }
     }
+
+    if (0 == _asyncRefCount)
+    {
+        Director::getInstance()->getScheduler()->unschedule(schedule_selector(TextureCache::addImageAsyncCallBack), this);
+    }
 }
 
 Texture2D * TextureCache::addImage(const std::string &path)
@@ -328,7 +635,10 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if( it != _textures.end() )
+    {
         texture = it->second;
+        texture->setLastUsedFrame(Director::getInstance()->getTotalFrames());
+    }
 
     if (! texture)
     {
@@ -351,6 +661,9 @@ Texture2D * TextureCache::addImage(const std::string &path)
 #endif
                 // texture already retained, no need to re-retain it
                 _textures.insert( std::make_pair(fullpath, texture) );
+
+                texture->setLastUsedFrame(Director::getInstance()->getTotalFrames());
+                evictTextures(texture);
             }
             else
             {
@@ -375,6 +688,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if( it != _textures.end() ) {
             texture = it->second;
+            texture->setLastUsedFrame(Director::getInstance()->getTotalFrames());
             break;
         }
 
@@ -388,6 +702,9 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
             texture->retain();
 
             texture->autorelease();
+
+            texture->setLastUsedFrame(Director::getInstance()->getTotalFrames());
+            evictTextures(texture);
         }
         else
         {
@@ -443,6 +760,8 @@ bool TextureCache::reloadTexture(const std::string& fileName)
 
 void TextureCache::removeAllTextures()
 {
+    _dynamicAtlas->removeAllImages();
+
     for( auto it=_textures.begin(); it!=_textures.end(); ++it ) {
         (it->second)->release();
     }
@@ -451,6 +770,8 @@ void TextureCache::removeAllTextures()
 
 void TextureCache::removeUnusedTextures()
 {
+    _dynamicAtlas->removeUnusedPages();
+
     for( auto it=_textures.cbegin(); it!=_textures.cend(); /* nothing */) {
         Texture2D *tex = it->second;
         if( tex->getReferenceCount() == 1 ) {
@@ -496,6 +817,9 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
         (it->second)->release();
         _textures.erase(it);
     }
+    else {
+        _dynamicAtlas->removeImage(textureKeyName);
+    }
 }
 
 Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) const
@@ -509,7 +833,10 @@ Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) con
     }
 
     if( it != _textures.end() )
+    {
+        it->second->setLastUsedFrame(Director::getInstance()->getTotalFrames());
         return it->second;
+    }
     return nullptr;
 }
 
@@ -523,10 +850,83 @@ void TextureCache::reloadAllTextures()
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    if (!_asyncQueue)
+        return;
+
+    setBackgroundUploadEnabled(false);
+
+    // queued decodes are dropped, the ones running are waited for
+    std::unique_lock<std::mutex> lock(_asyncQueue->mutex);
+    _asyncQueue->quit = true;
+    _asyncQueue->decodingCondition.wait(lock, [this](){ return _asyncQueue->decodingCount == 0; });
+}
+
+static size_t getTextureBytes(Texture2D* texture)
+{
+    // Each texture takes up width * height * bytesPerPixel bytes.
+    return (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+}
+
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+    evictTextures(nullptr);
+}
+
+size_t TextureCache::getMemoryUsage() const
+{
+    size_t totalBytes = 0;
+    for( auto it = _textures.begin(); it != _textures.end(); ++it )
+        totalBytes += getTextureBytes(it->second);
+    return totalBytes;
+}
+
+void TextureCache::evictTextures(Texture2D* keep)
+{
+    if (_memoryBudget == 0)
+        return;
+
+    size_t usage = getMemoryUsage();
+    if (usage <= _memoryBudget)
+        return;
+
+    // only the textures retained by the cache alone and not used during this frame can go, oldest first
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+    std::vector<std::unordered_map<std::string, Texture2D*>::iterator> candidates;
+    for( auto it = _textures.begin(); it != _textures.end(); ++it ) {
+        Texture2D* tex = it->second;
+        if (tex != keep && tex->getReferenceCount() == 1 && tex->getLastUsedFrame() < frame)
+            candidates.push_back(it);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const std::unordered_map<std::string, Texture2D*>::iterator& a, const std::unordered_map<std::string, Texture2D*>::iterator& b){
+        return a->second->getLastUsedFrame() < b->second->getLastUsedFrame();
+    });
+
+    for (auto& it : candidates)
+    {
+        if (usage <= _memoryBudget)
+            break;
+
+        Texture2D* tex = it->second;
+        size_t bytes = getTextureBytes(tex);
+        CCLOG("cocos2d: TextureCache: evicting texture: %s (%lu KB, last used in frame %u)", it->first.c_str(), (unsigned long)bytes / 1024, tex->getLastUsedFrame());
+
+        if (_evictionCallback)
+            _evictionCallback(it->first, tex);
+
+        tex->release();
+        _textures.erase(it);
+
+        usage -= bytes;
+        _evictedTexturesCount++;
+        _evictedBytes += bytes;
+    }
+
+    if (usage > _memoryBudget)
+    {
+        CCLOG("cocos2d: TextureCache: %lu KB over budget, the remaining textures are in use", (unsigned long)(usage - _memoryBudget) / 1024);
+    }
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -544,8 +944,7 @@ std::string TextureCache::getCachedTextureInfo() const
 
         Texture2D* tex = it->second;
         unsigned int bpp = tex->getBitsPerPixelForFormat();
-        // Each texture takes up width * height * bytesPerPixel bytes.
-        auto bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
+        auto bytes = getTextureBytes(tex);
         totalBytes += bytes;
         count++;
         snprintf(buftmp,sizeof(buftmp)-1,"\"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB\n",
@@ -563,6 +962,18 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp)-1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (_memoryBudget > 0)
+    {
+        snprintf(buftmp, sizeof(buftmp)-1, "TextureCache budget: %lu KB (%.1f%% used), %ld textures evicted, for %lu KB\n",
+                 (long)_memoryBudget / 1024,
+                 100.0f * totalBytes / _memoryBudget,
+                 (long)_evictedTexturesCount,
+                 (long)_evictedBytes / 1024);
+        buffer += buftmp;
+    }
+
+    buffer += _dynamicAtlas->getDescription();
+
     return buffer;
 }
 
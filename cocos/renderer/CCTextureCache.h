@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <memory>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
@@ -61,6 +62,9 @@ NS_CC_BEGIN
 * Once the texture is loaded, the next time it will return
 * a reference of the previously loaded texture reducing GPU & CPU memory
 */
+class DynamicAtlas;
+class GLView;
+
 class CC_DLL TextureCache : public Ref
 {
 public:
@@ -118,6 +122,36 @@ public:
     * @since v0.8
     */
     virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback);
+
+    /* Same as addImageAsync(filepath, callback), with a priority: images with a higher priority are decoded and uploaded first.
+    * Images are decoded and converted to the default pixel format on the ThreadPool, and requests for the same file share one decode.
+    * The callback is called with nullptr if the image can't be loaded.
+    * Returns the id of the request, to be passed to cancelImageAsync(), or 0 if the texture was already loaded and the callback called.
+    * @since v3.2
+    */
+    unsigned int addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback, int priority);
+
+    /* Cancels a request returned by addImageAsync(). Its callback won't be called, and the image isn't loaded
+    * if no other request wants it.
+    * @since v3.2
+    */
+    void cancelImageAsync(unsigned int requestId);
+
+    /* Sets the time in milliseconds the main thread may spend per frame creating the textures of async loaded images.
+    * At least one texture is created per frame. Default is 4 ms.
+    * @since v3.2
+    */
+    void setAsyncUploadBudget(float milliseconds) { _asyncUploadBudget = milliseconds; }
+    float getAsyncUploadBudget() const { return _asyncUploadBudget; }
+
+    /* Uploads the async loaded images from a thread owning a GL context shared with the cocos2d one.
+    * The textures are only added to the cache once the GPU is done uploading them, so the cocos2d thread doesn't stall.
+    * Only desktop platforms can share contexts; elsewhere the images keep being uploaded on the cocos2d thread.
+    * Returns whether the background uploads are enabled. Disabled by default.
+    * @since v3.2
+    */
+    bool setBackgroundUploadEnabled(bool enabled);
+    bool isBackgroundUploadEnabled() const { return _uploadThread != nullptr; }
     
     /* Unbind a specified bound image asynchronous callback
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
@@ -185,47 +219,70 @@ public:
     */
     std::string getCachedTextureInfo() const;
 
+    /** Returns the atlas packing small images at runtime. It is disabled by default
+    * @since v3.2
+    */
+    DynamicAtlas* getDynamicAtlas() const { return _dynamicAtlas; }
+
+    /** Sets the memory budget of the cache in bytes. 0, the default, means no budget.
+    * Once the textures take more than the budget, the least recently used ones only retained by the cache are removed.
+    * Textures added or used during the current frame are never removed.
+    * @since v3.2
+    */
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Returns the bytes taken by the cached textures, computed from their size and pixel format
+    * @since v3.2
+    */
+    size_t getMemoryUsage() const;
+
+    /** Number of textures removed to fit the budget since the cache was created
+    * @since v3.2
+    */
+    unsigned int getEvictedTexturesCount() const { return _evictedTexturesCount; }
+
+    /** Bytes freed by the textures removed to fit the budget since the cache was created
+    * @since v3.2
+    */
+    size_t getEvictedBytes() const { return _evictedBytes; }
+
+    /** Sets a function called with the key and the texture every time a texture is removed to fit the budget.
+    * It is called right before the cache releases the texture, and must not add or remove textures.
+    * @since v3.2
+    */
+    void setEvictionCallback(const std::function<void(const std::string&, Texture2D*)>& callback) { _evictionCallback = callback; }
+
     //wait for texture cahe to quit befor destroy instance
     //called by director, please do not called outside
     void waitForQuit();
 
 private:
     void addImageAsyncCallBack(float dt);
-    void loadImage();
-
-public:
-    struct AsyncStruct
-    {
-    public:
-        AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f) {}
-
-        std::string filename;
-        std::function<void(Texture2D*)> callback;
-    };
+    void evictTextures(Texture2D* keep);
 
 protected:
-    typedef struct _ImageInfo
-    {
-        AsyncStruct *asyncStruct;
-        Image        *image;
-    } ImageInfo;
-    
-    std::thread* _loadingThread;
-
-    std::queue<AsyncStruct*>* _asyncStructQueue;
-    std::deque<ImageInfo*>* _imageInfoQueue;
+    struct AsyncRequest;
+    struct AsyncQueue;
 
-    std::mutex _asyncStructQueueMutex;
-    std::mutex _imageInfoMutex;
+    static void decodeNextImage(std::shared_ptr<AsyncQueue> queue);
+    static void uploadImages(std::shared_ptr<AsyncQueue> queue, GLView* view);
 
-    std::mutex _sleepMutex;
-    std::condition_variable _sleepCondition;
-
-    bool _needQuit;
+    std::shared_ptr<AsyncQueue> _asyncQueue;
 
     int _asyncRefCount;
+    unsigned int _lastAsyncRequestId;
+    float _asyncUploadBudget;
+    std::thread* _uploadThread;
 
     std::unordered_map<std::string, Texture2D*> _textures;
+
+    DynamicAtlas* _dynamicAtlas;
+
+    size_t _memoryBudget;
+    unsigned int _evictedTexturesCount;
+    size_t _evictedBytes;
+    std::function<void(const std::string&, Texture2D*)> _evictionCallback;
 };
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
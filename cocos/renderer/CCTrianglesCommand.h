@@ -0,0 +1,75 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef _CC_TRIANGLESCOMMAND_H_
+#define _CC_TRIANGLESCOMMAND_H_
+
+#include "renderer/CCRenderCommand.h"
+#include "renderer/CCGLProgramState.h"
+
+NS_CC_BEGIN
+
+/** Command used to render a list of triangles, e.g. the geometry of a DrawNode.
+ The renderer transforms the vertices into world coordinates and batches consecutive
+ TrianglesCommands that share the same material into a single draw call.
+ */
+class TrianglesCommand : public RenderCommand
+{
+public:
+    TrianglesCommand();
+    ~TrianglesCommand();
+
+    /** Initializes the command with a globalZOrder, a `GLProgramState`, a blending function, a pointer to the vertices
+     * of the triangles, the number of vertices (3 per triangle), and the Model View transform to be used for the vertices.
+     * The vertices must stay valid until the frame is rendered.
+     */
+    void init(float globalOrder, GLProgramState* glProgramState, BlendFunc blendType, const V2F_C4B_T2F* vertices, ssize_t vertexCount,
+              const Mat4& mv);
+
+    void useMaterial() const;
+
+    inline uint32_t getMaterialID() const { return _materialID; }
+    inline const V2F_C4B_T2F* getVertices() const { return _vertices; }
+    inline ssize_t getVertexCount() const { return _vertexCount; }
+    inline GLProgramState* getGLProgramState() const { return _glProgramState; }
+    inline BlendFunc getBlendType() const { return _blendType; }
+    inline const Mat4& getModelView() const { return _mv; }
+
+protected:
+    void generateMaterialID();
+
+    uint32_t _materialID;
+    uint32_t _uniformsHash;
+
+    GLProgramState* _glProgramState;
+    BlendFunc _blendType;
+    const V2F_C4B_T2F* _vertices;
+    ssize_t _vertexCount;
+    Mat4 _mv;
+};
+
+NS_CC_END
+
+#endif //_CC_TRIANGLESCOMMAND_H_
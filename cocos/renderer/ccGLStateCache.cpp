@@ -54,7 +54,35 @@ namespace
     static GLuint    s_VAO = 0;
     static GLenum    s_activeTexture = -1;
 
+    // -1 means the state is not known, and the next call has to reach GL
+    static int       s_depthMask = -1;
+    static GLenum    s_depthFunc = -1;
+    static GLenum    s_cullFaceMode = -1;
+    static GLint     s_scissorBox[4] = { -1, -1, -1, -1 };
+    static GLenum    s_stencilFunc = -1;
+    static GLint     s_stencilRef = 0;
+    static GLuint    s_stencilValueMask = 0;
+    static GLenum    s_stencilFail = -1;
+    static GLenum    s_stencilPassDepthFail = -1;
+    static GLenum    s_stencilPassDepthPass = -1;
+    static GLint     s_stencilWriteMask = -1;
+    static GLint     s_viewport[4] = { -1, -1, -1, -1 };
+    static GLuint    s_arrayBuffer = -1;
+    static GLuint    s_elementArrayBuffer = -1;
+
 #endif // CC_ENABLE_GL_STATE_CACHE
+
+    // capabilities, only read back from GL when the cache is disabled
+    static int       s_depthTest = -1;
+    static int       s_cullFace = -1;
+    static int       s_scissorTest = -1;
+    static int       s_stencilTest = -1;
+
+    // calls sent to GL and calls filtered out by the cache
+    static unsigned int s_issuedCalls = 0;
+    static unsigned int s_filteredCalls = 0;
+    static unsigned int s_lastFrameIssuedCalls = 0;
+    static unsigned int s_lastFrameFilteredCalls = 0;
 }
 
 // GL State Cache functions
@@ -78,6 +106,21 @@ void invalidateStateCache( void )
     s_blendingDest = -1;
     s_GLServerState = 0;
     s_VAO = 0;
+
+    s_depthTest = -1;
+    s_depthMask = -1;
+    s_depthFunc = -1;
+    s_cullFace = -1;
+    s_cullFaceMode = -1;
+    s_scissorTest = -1;
+    s_scissorBox[0] = -1;
+    s_stencilTest = -1;
+    s_stencilFunc = -1;
+    s_stencilFail = -1;
+    s_stencilWriteMask = -1;
+    s_viewport[0] = -1;
+    s_arrayBuffer = -1;
+    s_elementArrayBuffer = -1;
     
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -99,9 +142,15 @@ void useProgram( GLuint program )
 #if CC_ENABLE_GL_STATE_CACHE
     if( program != s_currentShaderProgram ) {
         s_currentShaderProgram = program;
+        s_issuedCalls++;
         glUseProgram(program);
     }
+    else
+    {
+        s_filteredCalls++;
+    }
 #else
+    s_issuedCalls++;
     glUseProgram(program);
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -126,9 +175,15 @@ void blendFunc(GLenum sfactor, GLenum dfactor)
     {
         s_blendingSource = sfactor;
         s_blendingDest = dfactor;
+        s_issuedCalls++;
         SetBlending(sfactor, dfactor);
     }
+    else
+    {
+        s_filteredCalls++;
+    }
 #else
+    s_issuedCalls++;
     SetBlending( sfactor, dfactor );
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -156,9 +211,15 @@ void bindTexture2DN(GLuint textureUnit, GLuint textureId)
     {
         s_currentBoundTexture[textureUnit] = textureId;
         activeTexture(GL_TEXTURE0 + textureUnit);
+        s_issuedCalls++;
         glBindTexture(GL_TEXTURE_2D, textureId);
     }
+    else
+    {
+        s_filteredCalls++;
+    }
 #else
+    s_issuedCalls += 2;
     glActiveTexture(GL_TEXTURE0 + textureUnit);
     glBindTexture(GL_TEXTURE_2D, textureId);
 #endif
@@ -190,9 +251,15 @@ void activeTexture(GLenum texture)
 #if CC_ENABLE_GL_STATE_CACHE
     if(s_activeTexture != texture) {
         s_activeTexture = texture;
+        s_issuedCalls++;
         glActiveTexture(s_activeTexture);
     }
+    else
+    {
+        s_filteredCalls++;
+    }
 #else
+    s_issuedCalls++;
     glActiveTexture(texture);
 #endif
 }
@@ -206,9 +273,17 @@ void bindVAO(GLuint vaoId)
         if (s_VAO != vaoId)
         {
             s_VAO = vaoId;
+            // the element array buffer binding is part of the VAO state
+            s_elementArrayBuffer = -1;
+            s_issuedCalls++;
             glBindVertexArray(vaoId);
         }
+        else
+        {
+            s_filteredCalls++;
+        }
 #else
+        s_issuedCalls++;
         glBindVertexArray(vaoId);
 #endif // CC_ENABLE_GL_STATE_CACHE
     
@@ -227,6 +302,7 @@ void enableVertexAttribs(uint32_t flags)
         bool enabled = flags & bit;
         bool enabledBefore = s_attributeFlags & bit;
         if(enabled != enabledBefore) {
+            s_issuedCalls++;
             if( enabled )
                 glEnableVertexAttribArray(i);
             else
@@ -236,6 +312,332 @@ void enableVertexAttribs(uint32_t flags)
     s_attributeFlags = flags;
 }
 
+// GL server side state functions
+
+static void setCapability(GLenum cap, bool enabled, int& cachedState)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (cachedState == (int)enabled)
+    {
+        s_filteredCalls++;
+        return;
+    }
+    cachedState = enabled;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    if (enabled)
+        glEnable(cap);
+    else
+        glDisable(cap);
+}
+
+static bool isCapabilityEnabled(GLenum cap, int& cachedState)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (cachedState == -1)
+    {
+        cachedState = glIsEnabled(cap) ? 1 : 0;
+    }
+    return cachedState == 1;
+#else
+    return glIsEnabled(cap) ? true : false;
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void enableDepthTest(bool enabled)
+{
+    setCapability(GL_DEPTH_TEST, enabled, s_depthTest);
+}
+
+bool isDepthTestEnabled()
+{
+    return isCapabilityEnabled(GL_DEPTH_TEST, s_depthTest);
+}
+
+void depthMask(GLboolean flag)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthMask == (flag ? 1 : 0))
+    {
+        s_filteredCalls++;
+        return;
+    }
+    s_depthMask = flag ? 1 : 0;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    glDepthMask(flag);
+}
+
+GLboolean getDepthMask()
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthMask != -1)
+    {
+        return s_depthMask ? GL_TRUE : GL_FALSE;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    GLboolean flag = GL_TRUE;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &flag);
+#if CC_ENABLE_GL_STATE_CACHE
+    s_depthMask = flag ? 1 : 0;
+#endif // CC_ENABLE_GL_STATE_CACHE
+    return flag;
+}
+
+void depthFunc(GLenum func)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthFunc == func)
+    {
+        s_filteredCalls++;
+        return;
+    }
+    s_depthFunc = func;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    glDepthFunc(func);
+}
+
+void enableCullFace(bool enabled)
+{
+    setCapability(GL_CULL_FACE, enabled, s_cullFace);
+}
+
+void cullFace(GLenum mode)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_cullFaceMode == mode)
+    {
+        s_filteredCalls++;
+        return;
+    }
+    s_cullFaceMode = mode;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    glCullFace(mode);
+}
+
+void enableScissorTest(bool enabled)
+{
+    setCapability(GL_SCISSOR_TEST, enabled, s_scissorTest);
+}
+
+bool isScissorTestEnabled()
+{
+    return isCapabilityEnabled(GL_SCISSOR_TEST, s_scissorTest);
+}
+
+void scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_scissorBox[0] == x && s_scissorBox[1] == y && s_scissorBox[2] == width && s_scissorBox[3] == height)
+    {
+        s_filteredCalls++;
+        return;
+    }
+    s_scissorBox[0] = x;
+    s_scissorBox[1] = y;
+    s_scissorBox[2] = width;
+    s_scissorBox[3] = height;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    glScissor(x, y, width, height);
+}
+
+void enableStencilTest(bool enabled)
+{
+    setCapability(GL_STENCIL_TEST, enabled, s_stencilTest);
+}
+
+bool isStencilTestEnabled()
+{
+    return isCapabilityEnabled(GL_STENCIL_TEST, s_stencilTest);
+}
+
+void stencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilFunc == func && s_stencilRef == ref && s_stencilValueMask == mask)
+    {
+        s_filteredCalls++;
+        return;
+    }
+    s_stencilFunc = func;
+    s_stencilRef = ref;
+    s_stencilValueMask = mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    glStencilFunc(func, ref, mask);
+}
+
+void getStencilFunc(GLenum* func, GLint* ref, GLuint* mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilFunc == (GLenum)-1)
+    {
+        glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&s_stencilFunc);
+        glGetIntegerv(GL_STENCIL_REF, &s_stencilRef);
+        glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint *)&s_stencilValueMask);
+    }
+    *func = s_stencilFunc;
+    *ref = s_stencilRef;
+    *mask = s_stencilValueMask;
+#else
+    glGetIntegerv(GL_STENCIL_FUNC, (GLint *)func);
+    glGetIntegerv(GL_STENCIL_REF, ref);
+    glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint *)mask);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void stencilOp(GLenum fail, GLenum passDepthFail, GLenum passDepthPass)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilFail == fail && s_stencilPassDepthFail == passDepthFail && s_stencilPassDepthPass == passDepthPass)
+    {
+        s_filteredCalls++;
+        return;
+    }
+    s_stencilFail = fail;
+    s_stencilPassDepthFail = passDepthFail;
+    s_stencilPassDepthPass = passDepthPass;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    glStencilOp(fail, passDepthFail, passDepthPass);
+}
+
+void getStencilOp(GLenum* fail, GLenum* passDepthFail, GLenum* passDepthPass)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilFail == (GLenum)-1)
+    {
+        glGetIntegerv(GL_STENCIL_FAIL, (GLint *)&s_stencilFail);
+        glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)&s_stencilPassDepthFail);
+        glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&s_stencilPassDepthPass);
+    }
+    *fail = s_stencilFail;
+    *passDepthFail = s_stencilPassDepthFail;
+    *passDepthPass = s_stencilPassDepthPass;
+#else
+    glGetIntegerv(GL_STENCIL_FAIL, (GLint *)fail);
+    glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)passDepthFail);
+    glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)passDepthPass);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void stencilMask(GLuint mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilWriteMask != -1 && (GLuint)s_stencilWriteMask == mask)
+    {
+        s_filteredCalls++;
+        return;
+    }
+    s_stencilWriteMask = mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    glStencilMask(mask);
+}
+
+GLuint getStencilMask()
+{
+    GLuint mask = 0;
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilWriteMask == -1)
+    {
+        glGetIntegerv(GL_STENCIL_WRITEMASK, &s_stencilWriteMask);
+    }
+    mask = s_stencilWriteMask;
+#else
+    glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&mask);
+#endif // CC_ENABLE_GL_STATE_CACHE
+    return mask;
+}
+
+void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_viewport[0] == x && s_viewport[1] == y && s_viewport[2] == width && s_viewport[3] == height)
+    {
+        s_filteredCalls++;
+        return;
+    }
+    s_viewport[0] = x;
+    s_viewport[1] = y;
+    s_viewport[2] = width;
+    s_viewport[3] = height;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    glViewport(x, y, width, height);
+}
+
+void bindBuffer(GLenum target, GLuint buffer)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    GLuint* cachedBuffer = nullptr;
+    if (target == GL_ARRAY_BUFFER)
+        cachedBuffer = &s_arrayBuffer;
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+        cachedBuffer = &s_elementArrayBuffer;
+
+    if (cachedBuffer)
+    {
+        if (*cachedBuffer == buffer)
+        {
+            s_filteredCalls++;
+            return;
+        }
+        *cachedBuffer = buffer;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    s_issuedCalls++;
+    glBindBuffer(target, buffer);
+}
+
+void deleteBuffers(GLsizei n, const GLuint* buffers)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    // deleted buffers are unbound by GL
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (s_arrayBuffer == buffers[i])
+            s_arrayBuffer = 0;
+        if (s_elementArrayBuffer == buffers[i])
+            s_elementArrayBuffer = 0;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glDeleteBuffers(n, buffers);
+}
+
+unsigned int getIssuedCalls()
+{
+    return s_lastFrameIssuedCalls;
+}
+
+unsigned int getFilteredCalls()
+{
+    return s_lastFrameFilteredCalls;
+}
+
+void endFrameCallsCount()
+{
+    s_lastFrameIssuedCalls = s_issuedCalls;
+    s_lastFrameFilteredCalls = s_filteredCalls;
+    s_issuedCalls = 0;
+    s_filteredCalls = 0;
+}
+
 // GL Uniforms functions
 
 void setProjectionMatrixDirty( void )
@@ -139,6 +139,141 @@ void CC_DLL activeTexture(GLenum texture);
  */
 void CC_DLL bindVAO(GLuint vaoId);
 
+/** Enables or disables GL_DEPTH_TEST in case it is not already in that state.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glEnable()/glDisable() directly.
+ @since v3.2
+ */
+void CC_DLL enableDepthTest(bool enabled);
+
+/** Returns whether GL_DEPTH_TEST is enabled. It only queries GL if the state is not known yet.
+ @since v3.2
+ */
+bool CC_DLL isDepthTestEnabled();
+
+/** Sets the depth write mask in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthMask() directly.
+ @since v3.2
+ */
+void CC_DLL depthMask(GLboolean flag);
+
+/** Returns the depth write mask. It only queries GL if the state is not known yet.
+ @since v3.2
+ */
+GLboolean CC_DLL getDepthMask();
+
+/** Sets the depth function in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthFunc() directly.
+ @since v3.2
+ */
+void CC_DLL depthFunc(GLenum func);
+
+/** Enables or disables GL_CULL_FACE in case it is not already in that state.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glEnable()/glDisable() directly.
+ @since v3.2
+ */
+void CC_DLL enableCullFace(bool enabled);
+
+/** Sets the faces to cull in case they are different than the current ones.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glCullFace() directly.
+ @since v3.2
+ */
+void CC_DLL cullFace(GLenum mode);
+
+/** Enables or disables GL_SCISSOR_TEST in case it is not already in that state.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glEnable()/glDisable() directly.
+ @since v3.2
+ */
+void CC_DLL enableScissorTest(bool enabled);
+
+/** Returns whether GL_SCISSOR_TEST is enabled. It only queries GL if the state is not known yet.
+ @since v3.2
+ */
+bool CC_DLL isScissorTestEnabled();
+
+/** Sets the scissor box in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glScissor() directly.
+ @since v3.2
+ */
+void CC_DLL scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/** Enables or disables GL_STENCIL_TEST in case it is not already in that state.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glEnable()/glDisable() directly.
+ @since v3.2
+ */
+void CC_DLL enableStencilTest(bool enabled);
+
+/** Returns whether GL_STENCIL_TEST is enabled. It only queries GL if the state is not known yet.
+ @since v3.2
+ */
+bool CC_DLL isStencilTestEnabled();
+
+/** Sets the stencil function in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glStencilFunc() directly.
+ @since v3.2
+ */
+void CC_DLL stencilFunc(GLenum func, GLint ref, GLuint mask);
+
+/** Returns the stencil function. It only queries GL if the state is not known yet.
+ @since v3.2
+ */
+void CC_DLL getStencilFunc(GLenum* func, GLint* ref, GLuint* mask);
+
+/** Sets the stencil operations in case they are different than the current ones.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glStencilOp() directly.
+ @since v3.2
+ */
+void CC_DLL stencilOp(GLenum fail, GLenum passDepthFail, GLenum passDepthPass);
+
+/** Returns the stencil operations. It only queries GL if the state is not known yet.
+ @since v3.2
+ */
+void CC_DLL getStencilOp(GLenum* fail, GLenum* passDepthFail, GLenum* passDepthPass);
+
+/** Sets the stencil write mask in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glStencilMask() directly.
+ @since v3.2
+ */
+void CC_DLL stencilMask(GLuint mask);
+
+/** Returns the stencil write mask. It only queries GL if the state is not known yet.
+ @since v3.2
+ */
+GLuint CC_DLL getStencilMask();
+
+/** Sets the viewport in case it is different than the current one.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glViewport() directly.
+ @since v3.2
+ */
+void CC_DLL viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/** Binds a buffer to GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER in case it is not already bound.
+ The element array buffer binding belongs to the VAO, so it is forgotten when bindVAO() changes the VAO.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glBindBuffer() directly.
+ @since v3.2
+ */
+void CC_DLL bindBuffer(GLenum target, GLuint buffer);
+
+/** Deletes the buffers. If they are bound, it invalidates the cache.
+ If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDeleteBuffers() directly.
+ @since v3.2
+ */
+void CC_DLL deleteBuffers(GLsizei n, const GLuint* buffers);
+
+/** Returns how many calls of the state cache were sent to GL in the last frame.
+ @since v3.2
+ */
+unsigned int CC_DLL getIssuedCalls();
+
+/** Returns how many redundant calls the state cache filtered out in the last frame.
+ @since v3.2
+ */
+unsigned int CC_DLL getFilteredCalls();
+
+/** Ends the counting of the issued and filtered calls of the current frame. Called by the Director.
+ @since v3.2
+ */
+void CC_DLL endFrameCallsCount();
+
 // end of shaders group
 /// @}
 
@@ -0,0 +1,779 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/ccPixelConversion.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXEL_USE_SSE2 1
+#include <emmintrin.h>
+
+// AVX2 kernels are compiled for their own target and only called when the CPU supports them
+#if defined(_MSC_VER) && _MSC_VER >= 1700
+#define PIXEL_USE_AVX2 1
+#define PIXEL_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#elif defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define PIXEL_USE_AVX2 1
+#define PIXEL_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+#endif
+
+NS_CC_BEGIN
+
+namespace PixelConversion {
+
+namespace {
+
+#if PIXEL_USE_AVX2
+bool isAVX2Supported()
+{
+    unsigned int regs[4];
+    unsigned int xcr0 = 0;
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    regs[2] = (unsigned int)info[2];
+#else
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+    __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+    // the OS has to save the ymm registers: OSXSAVE, AVX, then XCR0 bits 1 and 2
+    if ((regs[2] & (1 << 27)) == 0 || (regs[2] & (1 << 28)) == 0)
+        return false;
+#if defined(_MSC_VER)
+    xcr0 = (unsigned int)_xgetbv(0);
+#else
+    __asm__ ("xgetbv" : "=a"(xcr0) : "c"(0) : "%edx");
+#endif
+    if ((xcr0 & 6) != 6)
+        return false;
+
+#if defined(_MSC_VER)
+    __cpuidex(info, 7, 0);
+    regs[1] = (unsigned int)info[1];
+#else
+    __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    return (regs[1] & (1 << 5)) != 0;
+}
+#endif
+
+InstructionSet detectInstructionSet()
+{
+#if PIXEL_USE_AVX2
+    if (isAVX2Supported())
+        return InstructionSet::AVX2;
+#endif
+#if PIXEL_USE_SSE2
+    return InstructionSet::SSE2;
+#else
+    return InstructionSet::SCALAR;
+#endif
+}
+
+const InstructionSet s_supportedInstructionSet = detectInstructionSet();
+InstructionSet s_instructionSet = s_supportedInstructionSet;
+
+inline unsigned char intensity(unsigned char r, unsigned char g, unsigned char b)
+{
+    return (r * 299 + g * 587 + b * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
+}
+
+#if PIXEL_USE_SSE2
+//
+// SSE2 helpers, working on 4 RGBA8888 pixels per register
+//
+
+// packs the low 16 bits of each 32 bit lane of a and b
+inline __m128i packLow16SSE2(__m128i a, __m128i b)
+{
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+}
+
+// R*299 + G*587 + B*114 + 500, divided by 8
+inline __m128i weightedSumSSE2(__m128i p)
+{
+    const __m128i weights = _mm_setr_epi16(299, 587, 114, 500, 299, 587, 114, 500);
+    const __m128i zero = _mm_setzero_si128();
+
+    // alpha is replaced by 1 so the multiply-add also adds the rounding term
+    p = _mm_or_si128(_mm_and_si128(p, _mm_set1_epi32(0x00FFFFFF)), _mm_set1_epi32(0x01000000));
+    __m128 lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(p, zero), weights));
+    __m128 hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(p, zero), weights));
+    __m128i sum = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))),
+                                _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))));
+    return _mm_srli_epi32(sum, 3);
+}
+
+// intensity of 8 pixels as 16 bit lanes. sum / 1000 == (sum / 8) / 125, and x / 125 == (x * 33555) >> 22 for x < 32768
+inline __m128i intensitySSE2(__m128i p0, __m128i p1)
+{
+    __m128i x = _mm_packs_epi32(weightedSumSSE2(p0), weightedSumSSE2(p1));
+    return _mm_srli_epi16(_mm_mulhi_epu16(x, _mm_set1_epi16((short)33555)), 6);
+}
+
+// alpha of 8 pixels as 16 bit lanes
+inline __m128i alphaSSE2(__m128i p0, __m128i p1)
+{
+    return _mm_packs_epi32(_mm_srli_epi32(p0, 24), _mm_srli_epi32(p1, 24));
+}
+
+inline __m128i premultiplyHalfSSE2(__m128i half)
+{
+    const __m128i colorMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+    const __m128i alphaFactor = _mm_setr_epi16(0, 0, 0, 256, 0, 0, 0, 256);
+
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(half, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i factor = _mm_or_si128(_mm_and_si128(_mm_add_epi16(alpha, _mm_set1_epi16(1)), colorMask), alphaFactor);
+    return _mm_srli_epi16(_mm_mullo_epi16(half, factor), 8);
+}
+#endif
+
+#if PIXEL_USE_AVX2
+//
+// AVX2 helpers, working on 8 RGBA8888 pixels per register.
+// Packs work inside 128 bit lanes, so their results are put back in order with a permute.
+//
+
+PIXEL_TARGET_AVX2 inline __m256i packLow16AVX2(__m256i a, __m256i b)
+{
+    __m256i packed = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16), _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16));
+    return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+PIXEL_TARGET_AVX2 inline __m256i weightedSumAVX2(__m256i p)
+{
+    const __m256i weights = _mm256_setr_epi16(299, 587, 114, 500, 299, 587, 114, 500, 299, 587, 114, 500, 299, 587, 114, 500);
+    const __m256i zero = _mm256_setzero_si256();
+
+    p = _mm256_or_si256(_mm256_and_si256(p, _mm256_set1_epi32(0x00FFFFFF)), _mm256_set1_epi32(0x01000000));
+    __m256 lo = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpacklo_epi8(p, zero), weights));
+    __m256 hi = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpackhi_epi8(p, zero), weights));
+    __m256i sum = _mm256_add_epi32(_mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))),
+                                   _mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))));
+    return _mm256_srli_epi32(sum, 3);
+}
+
+PIXEL_TARGET_AVX2 inline __m256i intensityAVX2(__m256i p0, __m256i p1)
+{
+    __m256i x = _mm256_permute4x64_epi64(_mm256_packs_epi32(weightedSumAVX2(p0), weightedSumAVX2(p1)), _MM_SHUFFLE(3, 1, 2, 0));
+    return _mm256_srli_epi16(_mm256_mulhi_epu16(x, _mm256_set1_epi16((short)33555)), 6);
+}
+
+PIXEL_TARGET_AVX2 inline __m256i alphaAVX2(__m256i p0, __m256i p1)
+{
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_srli_epi32(p0, 24), _mm256_srli_epi32(p1, 24)), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+// packs 16 lanes of 16 bits into 16 bytes
+PIXEL_TARGET_AVX2 inline __m128i packBytesAVX2(__m256i x)
+{
+    return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi16(x, x), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// expands 8 RGB888 pixels to RGBA8888 with an opaque alpha. Reads 28 bytes.
+PIXEL_TARGET_AVX2 inline __m256i loadRGB888AVX2(const unsigned char* data)
+{
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                             0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)data)),
+                                        _mm_loadu_si128((const __m128i*)(data + 12)), 1);
+    return _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), _mm256_set1_epi32((int)0xFF000000));
+}
+
+PIXEL_TARGET_AVX2 inline __m256i premultiplyHalfAVX2(__m256i half)
+{
+    const __m256i colorMask = _mm256_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0);
+    const __m256i alphaFactor = _mm256_setr_epi16(0, 0, 0, 256, 0, 0, 0, 256, 0, 0, 0, 256, 0, 0, 0, 256);
+
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(half, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i factor = _mm256_or_si256(_mm256_and_si256(_mm256_add_epi16(alpha, _mm256_set1_epi16(1)), colorMask), alphaFactor);
+    return _mm256_srli_epi16(_mm256_mullo_epi16(half, factor), 8);
+}
+#endif
+
+//
+// Output formats. Each one converts a single pixel in C, 8 pixels with SSE2 and 16 pixels with AVX2.
+//
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
+struct RGBA4444
+{
+    static const int BYTES = 2;
+
+    static void convert(unsigned char r, unsigned char g, unsigned char b, unsigned char a, unsigned char* out)
+    {
+        *(unsigned short*)out = (r & 0x00F0) << 8    //R
+            | (g & 0x00F0) << 4                       //G
+            | (b & 0xF0)                              //B
+            | (a & 0xF0) >> 4;                        //A
+    }
+
+#if PIXEL_USE_SSE2
+    static __m128i convertSSE2(__m128i p)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF0)), 8);
+        __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF000)), 4);
+        __m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF00000)), 16);
+        __m128i a = _mm_srli_epi32(p, 28);
+        return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    }
+
+    static void storeSSE2(__m128i p0, __m128i p1, unsigned char* out)
+    {
+        _mm_storeu_si128((__m128i*)out, packLow16SSE2(convertSSE2(p0), convertSSE2(p1)));
+    }
+#endif
+
+#if PIXEL_USE_AVX2
+    PIXEL_TARGET_AVX2 static __m256i convertAVX2(__m256i p)
+    {
+        __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF0)), 8);
+        __m256i g = _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF000)), 4);
+        __m256i b = _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF00000)), 16);
+        __m256i a = _mm256_srli_epi32(p, 28);
+        return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+    }
+
+    PIXEL_TARGET_AVX2 static void storeAVX2(__m256i p0, __m256i p1, unsigned char* out)
+    {
+        _mm256_storeu_si256((__m256i*)out, packLow16AVX2(convertAVX2(p0), convertAVX2(p1)));
+    }
+#endif
+};
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
+struct RGB565
+{
+    static const int BYTES = 2;
+
+    static void convert(unsigned char r, unsigned char g, unsigned char b, unsigned char /*a*/, unsigned char* out)
+    {
+        *(unsigned short*)out = (r & 0x00F8) << 8    //R
+            | (g & 0x00FC) << 3                       //G
+            | (b & 0x00F8) >> 3;                      //B
+    }
+
+#if PIXEL_USE_SSE2
+    static __m128i convertSSE2(__m128i p)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+        __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xFC00)), 5);
+        __m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 19);
+        return _mm_or_si128(_mm_or_si128(r, g), b);
+    }
+
+    static void storeSSE2(__m128i p0, __m128i p1, unsigned char* out)
+    {
+        _mm_storeu_si128((__m128i*)out, packLow16SSE2(convertSSE2(p0), convertSSE2(p1)));
+    }
+#endif
+
+#if PIXEL_USE_AVX2
+    PIXEL_TARGET_AVX2 static __m256i convertAVX2(__m256i p)
+    {
+        __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF8)), 8);
+        __m256i g = _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xFC00)), 5);
+        __m256i b = _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF80000)), 19);
+        return _mm256_or_si256(_mm256_or_si256(r, g), b);
+    }
+
+    PIXEL_TARGET_AVX2 static void storeAVX2(__m256i p0, __m256i p1, unsigned char* out)
+    {
+        _mm256_storeu_si256((__m256i*)out, packLow16AVX2(convertAVX2(p0), convertAVX2(p1)));
+    }
+#endif
+};
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGBBBBBA
+struct RGB5A1
+{
+    static const int BYTES = 2;
+
+    static void convert(unsigned char r, unsigned char g, unsigned char b, unsigned char a, unsigned char* out)
+    {
+        *(unsigned short*)out = (r & 0x00F8) << 8    //R
+            | (g & 0x00F8) << 3                       //G
+            | (b & 0x00F8) >> 2                       //B
+            | (a & 0x0080) >> 7;                      //A
+    }
+
+#if PIXEL_USE_SSE2
+    static __m128i convertSSE2(__m128i p)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+        __m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF800)), 5);
+        __m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 18);
+        __m128i a = _mm_srli_epi32(p, 31);
+        return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    }
+
+    static void storeSSE2(__m128i p0, __m128i p1, unsigned char* out)
+    {
+        _mm_storeu_si128((__m128i*)out, packLow16SSE2(convertSSE2(p0), convertSSE2(p1)));
+    }
+#endif
+
+#if PIXEL_USE_AVX2
+    PIXEL_TARGET_AVX2 static __m256i convertAVX2(__m256i p)
+    {
+        __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF8)), 8);
+        __m256i g = _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF800)), 5);
+        __m256i b = _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF80000)), 18);
+        __m256i a = _mm256_srli_epi32(p, 31);
+        return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+    }
+
+    PIXEL_TARGET_AVX2 static void storeAVX2(__m256i p0, __m256i p1, unsigned char* out)
+    {
+        _mm256_storeu_si256((__m256i*)out, packLow16AVX2(convertAVX2(p0), convertAVX2(p1)));
+    }
+#endif
+};
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIIIAAAAAAAA
+struct AI88
+{
+    static const int BYTES = 2;
+
+    static void convert(unsigned char r, unsigned char g, unsigned char b, unsigned char a, unsigned char* out)
+    {
+        out[0] = intensity(r, g, b);
+        out[1] = a;
+    }
+
+#if PIXEL_USE_SSE2
+    static void storeSSE2(__m128i p0, __m128i p1, unsigned char* out)
+    {
+        _mm_storeu_si128((__m128i*)out, _mm_or_si128(intensitySSE2(p0, p1), _mm_slli_epi16(alphaSSE2(p0, p1), 8)));
+    }
+#endif
+
+#if PIXEL_USE_AVX2
+    PIXEL_TARGET_AVX2 static void storeAVX2(__m256i p0, __m256i p1, unsigned char* out)
+    {
+        _mm256_storeu_si256((__m256i*)out, _mm256_or_si256(intensityAVX2(p0, p1), _mm256_slli_epi16(alphaAVX2(p0, p1), 8)));
+    }
+#endif
+};
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIII
+struct I8
+{
+    static const int BYTES = 1;
+
+    static void convert(unsigned char r, unsigned char g, unsigned char b, unsigned char /*a*/, unsigned char* out)
+    {
+        *out = intensity(r, g, b);
+    }
+
+#if PIXEL_USE_SSE2
+    static void storeSSE2(__m128i p0, __m128i p1, unsigned char* out)
+    {
+        __m128i i = intensitySSE2(p0, p1);
+        _mm_storel_epi64((__m128i*)out, _mm_packus_epi16(i, i));
+    }
+#endif
+
+#if PIXEL_USE_AVX2
+    PIXEL_TARGET_AVX2 static void storeAVX2(__m256i p0, __m256i p1, unsigned char* out)
+    {
+        _mm_storeu_si128((__m128i*)out, packBytesAVX2(intensityAVX2(p0, p1)));
+    }
+#endif
+};
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
+struct A8
+{
+    static const int BYTES = 1;
+
+    static void convert(unsigned char /*r*/, unsigned char /*g*/, unsigned char /*b*/, unsigned char a, unsigned char* out)
+    {
+        *out = a;
+    }
+
+#if PIXEL_USE_SSE2
+    static void storeSSE2(__m128i p0, __m128i p1, unsigned char* out)
+    {
+        __m128i a = alphaSSE2(p0, p1);
+        _mm_storel_epi64((__m128i*)out, _mm_packus_epi16(a, a));
+    }
+#endif
+
+#if PIXEL_USE_AVX2
+    PIXEL_TARGET_AVX2 static void storeAVX2(__m256i p0, __m256i p1, unsigned char* out)
+    {
+        _mm_storeu_si128((__m128i*)out, packBytesAVX2(alphaAVX2(p0, p1)));
+    }
+#endif
+};
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA, only used to expand RGB888
+struct RGBA8888
+{
+    static const int BYTES = 4;
+
+    static void convert(unsigned char r, unsigned char g, unsigned char b, unsigned char a, unsigned char* out)
+    {
+        out[0] = r;
+        out[1] = g;
+        out[2] = b;
+        out[3] = a;
+    }
+
+#if PIXEL_USE_AVX2
+    PIXEL_TARGET_AVX2 static void storeAVX2(__m256i p0, __m256i p1, unsigned char* out)
+    {
+        _mm256_storeu_si256((__m256i*)out, p0);
+        _mm256_storeu_si256((__m256i*)(out + 32), p1);
+    }
+#endif
+};
+
+//
+// Loops. The vector ones return the number of pixels they converted, the C loop converts the rest.
+//
+
+#if PIXEL_USE_SSE2
+template <typename FORMAT>
+ssize_t convertFromRGBA8888SSE2(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16));
+        FORMAT::storeSSE2(p0, p1, outData + i * FORMAT::BYTES);
+    }
+    return i;
+}
+#endif
+
+#if PIXEL_USE_AVX2
+template <typename FORMAT>
+PIXEL_TARGET_AVX2 ssize_t convertFromRGBA8888AVX2(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m256i p0 = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+        __m256i p1 = _mm256_loadu_si256((const __m256i*)(data + i * 4 + 32));
+        FORMAT::storeAVX2(p0, p1, outData + i * FORMAT::BYTES);
+    }
+    return i;
+}
+
+template <typename FORMAT>
+PIXEL_TARGET_AVX2 ssize_t convertFromRGB888AVX2(const unsigned char* data, ssize_t pixels, unsigned char* outData)
+{
+    ssize_t i = 0;
+    // the second load reads 4 bytes past its 8 pixels
+    for (; (i + 16) * 3 + 4 <= pixels * 3; i += 16)
+    {
+        __m256i p0 = loadRGB888AVX2(data + i * 3);
+        __m256i p1 = loadRGB888AVX2(data + i * 3 + 24);
+        FORMAT::storeAVX2(p0, p1, outData + i * FORMAT::BYTES);
+    }
+    return i;
+}
+
+PIXEL_TARGET_AVX2 ssize_t premultiplyAlphaAVX2(unsigned char* data, ssize_t pixels)
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    ssize_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m256i p = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+        __m256i lo = premultiplyHalfAVX2(_mm256_unpacklo_epi8(p, zero));
+        __m256i hi = premultiplyHalfAVX2(_mm256_unpackhi_epi8(p, zero));
+        _mm256_storeu_si256((__m256i*)(data + i * 4), _mm256_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+PIXEL_TARGET_AVX2 void decodePaletteBlocksAVX2(const PaletteBlock* blocks, int count, BlockAlpha alphaMode, uint32_t* outData, unsigned int stride)
+{
+    const __m256i colorShifts = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m256i explicitShifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    const __m256i interpolatedShifts = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+
+    for (int b = 0; b < count; ++b, outData += 4)
+    {
+        const PaletteBlock& block = blocks[b];
+
+        // 8 pixels per register: rows 0 and 1, then rows 2 and 3
+        __m256i colors = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)block.colors));
+        __m256i top = _mm256_permutevar8x32_epi32(colors, _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)block.colorIndices), colorShifts), _mm256_set1_epi32(3)));
+        __m256i bottom = _mm256_permutevar8x32_epi32(colors, _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)(block.colorIndices >> 16)), colorShifts), _mm256_set1_epi32(3)));
+
+        if (alphaMode == BlockAlpha::INTERPOLATED)
+        {
+            // the decoders mask the alpha indices with 5, kept as is so the output doesn't change
+            __m256i palette = _mm256_loadu_si256((const __m256i*)block.alphaPalette);
+            uint64_t bits = block.alpha >> 16;
+            __m256i mask = _mm256_set1_epi32(5);
+            __m256i topAlpha = _mm256_permutevar8x32_epi32(palette, _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)(bits & 0xFFFFFF)), interpolatedShifts), mask));
+            __m256i bottomAlpha = _mm256_permutevar8x32_epi32(palette, _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)((bits >> 24) & 0xFFFFFF)), interpolatedShifts), mask));
+            top = _mm256_add_epi32(top, _mm256_slli_epi32(topAlpha, 24));
+            bottom = _mm256_add_epi32(bottom, _mm256_slli_epi32(bottomAlpha, 24));
+        }
+        else if (alphaMode == BlockAlpha::EXPLICIT)
+        {
+            __m256i mask = _mm256_set1_epi32(0x0F);
+            __m256i topAlpha = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)(uint32_t)block.alpha), explicitShifts), mask);
+            __m256i bottomAlpha = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)(uint32_t)(block.alpha >> 32)), explicitShifts), mask);
+            top = _mm256_add_epi32(top, _mm256_or_si256(_mm256_slli_epi32(topAlpha, 28), _mm256_slli_epi32(topAlpha, 24)));
+            bottom = _mm256_add_epi32(bottom, _mm256_or_si256(_mm256_slli_epi32(bottomAlpha, 28), _mm256_slli_epi32(bottomAlpha, 24)));
+        }
+
+        _mm_storeu_si128((__m128i*)outData, _mm256_castsi256_si128(top));
+        _mm_storeu_si128((__m128i*)(outData + stride), _mm256_extracti128_si256(top, 1));
+        _mm_storeu_si128((__m128i*)(outData + 2 * stride), _mm256_castsi256_si128(bottom));
+        _mm_storeu_si128((__m128i*)(outData + 3 * stride), _mm256_extracti128_si256(bottom, 1));
+    }
+}
+#endif
+
+template <typename FORMAT>
+void convertFromRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 4;
+    ssize_t i = 0;
+
+#if PIXEL_USE_AVX2
+    if (s_instructionSet == InstructionSet::AVX2)
+        i = convertFromRGBA8888AVX2<FORMAT>(data, pixels, outData);
+#endif
+#if PIXEL_USE_SSE2
+    if (s_instructionSet == InstructionSet::SSE2)
+        i = convertFromRGBA8888SSE2<FORMAT>(data, pixels, outData);
+#endif
+
+    for (; i < pixels; ++i)
+    {
+        const unsigned char* p = data + i * 4;
+        FORMAT::convert(p[0], p[1], p[2], p[3], outData + i * FORMAT::BYTES);
+    }
+}
+
+template <typename FORMAT>
+void convertFromRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 3;
+    ssize_t i = 0;
+
+#if PIXEL_USE_AVX2
+    if (s_instructionSet == InstructionSet::AVX2)
+        i = convertFromRGB888AVX2<FORMAT>(data, pixels, outData);
+#endif
+
+    for (; i < pixels; ++i)
+    {
+        const unsigned char* p = data + i * 3;
+        FORMAT::convert(p[0], p[1], p[2], 0xFF, outData + i * FORMAT::BYTES);
+    }
+}
+
+} // anonymous namespace
+
+InstructionSet getSupportedInstructionSet()
+{
+    return s_supportedInstructionSet;
+}
+
+void setInstructionSet(InstructionSet instructionSet)
+{
+    s_instructionSet = (int)instructionSet > (int)s_supportedInstructionSet ? s_supportedInstructionSet : instructionSet;
+}
+
+InstructionSet getInstructionSet()
+{
+    return s_instructionSet;
+}
+
+const char* getInstructionSetName(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::SSE2:
+            return "SSE2";
+        case InstructionSet::AVX2:
+            return "AVX2";
+        default:
+            return "C";
+    }
+}
+
+void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGBA8888<RGBA4444>(data, dataLen, outData);
+}
+
+void convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGBA8888<RGB565>(data, dataLen, outData);
+}
+
+void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGBA8888<RGB5A1>(data, dataLen, outData);
+}
+
+void convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGBA8888<AI88>(data, dataLen, outData);
+}
+
+void convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGBA8888<I8>(data, dataLen, outData);
+}
+
+void convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGBA8888<A8>(data, dataLen, outData);
+}
+
+void convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGB888<RGBA8888>(data, dataLen, outData);
+}
+
+void convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGB888<RGBA4444>(data, dataLen, outData);
+}
+
+void convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGB888<RGB565>(data, dataLen, outData);
+}
+
+void convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGB888<RGB5A1>(data, dataLen, outData);
+}
+
+void convertRGB888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGB888<AI88>(data, dataLen, outData);
+}
+
+void convertRGB888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    convertFromRGB888<I8>(data, dataLen, outData);
+}
+
+void decodePaletteBlocks(const PaletteBlock* blocks, int count, BlockAlpha alphaMode, uint32_t* outData, unsigned int stride)
+{
+#if PIXEL_USE_AVX2
+    if (s_instructionSet == InstructionSet::AVX2)
+    {
+        decodePaletteBlocksAVX2(blocks, count, alphaMode, outData, stride);
+        return;
+    }
+#endif
+
+    for (int b = 0; b < count; ++b, outData += 4)
+    {
+        const PaletteBlock& block = blocks[b];
+        uint32_t colorIndices = block.colorIndices;
+        uint32_t* row = outData;
+
+        if (alphaMode == BlockAlpha::INTERPOLATED)
+        {
+            uint64_t alpha = block.alpha >> 16;
+            for (int y = 0; y < 4; ++y, row += stride)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    row[x] = (block.alphaPalette[alpha & 5] << 24) + block.colors[colorIndices & 3];
+                    colorIndices >>= 2;
+                    alpha >>= 3;
+                }
+            }
+        }
+        else
+        {
+            uint64_t alpha = alphaMode == BlockAlpha::EXPLICIT ? block.alpha : 0;
+            for (int y = 0; y < 4; ++y, row += stride)
+            {
+                for (int x = 0; x < 4; ++x)
+                {
+                    uint32_t explicitAlpha = ((uint32_t)alpha & 0x0F) << 28;
+                    row[x] = explicitAlpha + (explicitAlpha >> 4) + block.colors[colorIndices & 3];
+                    colorIndices >>= 2;
+                    alpha >>= 4;
+                }
+            }
+        }
+    }
+}
+
+void premultiplyAlpha(unsigned char* data, ssize_t dataLen)
+{
+    ssize_t pixels = dataLen / 4;
+    ssize_t i = 0;
+
+#if PIXEL_USE_AVX2
+    if (s_instructionSet == InstructionSet::AVX2)
+        i = premultiplyAlphaAVX2(data, pixels);
+#endif
+#if PIXEL_USE_SSE2
+    if (s_instructionSet == InstructionSet::SSE2)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128i p = _mm_loadu_si128((const __m128i*)(data + i * 4));
+            __m128i lo = premultiplyHalfSSE2(_mm_unpacklo_epi8(p, zero));
+            __m128i hi = premultiplyHalfSSE2(_mm_unpackhi_epi8(p, zero));
+            _mm_storeu_si128((__m128i*)(data + i * 4), _mm_packus_epi16(lo, hi));
+        }
+    }
+#endif
+
+    for (; i < pixels; ++i)
+    {
+        unsigned char* p = data + i * 4;
+        unsigned int a = p[3] + 1;
+        p[0] = (unsigned char)((p[0] * a) >> 8);
+        p[1] = (unsigned char)((p[1] * a) >> 8);
+        p[2] = (unsigned char)((p[2] * a) >> 8);
+    }
+}
+
+} // PixelConversion
+
+NS_CC_END
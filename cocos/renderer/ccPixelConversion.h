@@ -0,0 +1,113 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCPIXELCONVERSION_H__
+#define __CCPIXELCONVERSION_H__
+
+#include <cstdint>
+
+#include "base/ccTypes.h"
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @file ccPixelConversion.h
+ Vectorized kernels used by Texture2D to convert RGBA8888 and RGB888 pixels to the other formats,
+ and by Image to premultiply the alpha.
+
+ The kernel is picked at runtime: AVX2 when the CPU and the OS support it, SSE2 on x86 otherwise,
+ and plain C on the other targets. Every kernel gives the same bytes as the plain C one.
+ SSE2 has no byte shuffle, so the RGB888 conversions only have an AVX2 kernel.
+ The S3TC and ATITC software decoders also use it to expand their blocks.
+ */
+namespace PixelConversion {
+
+enum class InstructionSet
+{
+    SCALAR,
+    SSE2,
+    AVX2,
+};
+
+/** Returns the best instruction set the CPU supports */
+InstructionSet CC_DLL getSupportedInstructionSet();
+
+/** Forces the kernels to use an instruction set, clamped to the supported one. Meant for benchmarks and tests */
+void CC_DLL setInstructionSet(InstructionSet instructionSet);
+
+/** Returns the instruction set in use. Defaults to getSupportedInstructionSet() */
+InstructionSet CC_DLL getInstructionSet();
+
+/** Returns "C", "SSE2" or "AVX2" */
+const char* CC_DLL getInstructionSetName(InstructionSet instructionSet);
+
+void CC_DLL convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+
+void CC_DLL convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGB888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+void CC_DLL convertRGB888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+
+/** A 4x4 block of a S3TC or ATITC texture, once the decoder has computed its palettes */
+struct PaletteBlock
+{
+    uint32_t colors[4];         // RGBA8888 colors picked by the indices
+    uint32_t colorIndices;      // 2 bits per pixel, row by row
+    uint64_t alpha;             // 4 bits per pixel when explicit. When interpolated, 3 bit indices from bit 16
+    uint32_t alphaPalette[8];   // only used when interpolated
+};
+
+enum class BlockAlpha
+{
+    NONE,
+    EXPLICIT,
+    INTERPOLATED,
+};
+
+/** Writes `count` blocks side by side to 4 rows of RGBA8888 pixels, `stride` pixels apart */
+void CC_DLL decodePaletteBlocks(const PaletteBlock* blocks, int count, BlockAlpha alphaMode, uint32_t* outData, unsigned int stride);
+
+/** Premultiplies in place the colors of RGBA8888 pixels by their alpha, like CC_RGB_PREMULTIPLY_ALPHA */
+void CC_DLL premultiplyAlpha(unsigned char* data, ssize_t dataLen);
+
+} // PixelConversion
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif //__CCPIXELCONVERSION_H__
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/ccGLStateCache.h"
 #include "ui/UILayoutManager.h"
 #include "2d/CCDrawNode.h"
 #include "2d/CCLayer.h"
@@ -88,6 +89,7 @@ _currentAlphaTestFunc(GL_ALWAYS),
 _currentAlphaTestRef(1),
 _backGroundImageColor(Color3B::WHITE),
 _backGroundImageOpacity(255),
+_contentSkipped(false),
 _passFocusToChild(true),
 _loopFocus(false),
 _isFocusPassing(false)
@@ -240,6 +242,12 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
         return;
     
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
+    if (_contentSkipped)
+    {
+        // the transforms of the content were not updated while it was clipped out
+        flags |= FLAGS_DIRTY_MASK;
+        _contentSkipped = false;
+    }
 
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
@@ -255,6 +263,28 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
     
     renderer->pushGroup(_groupCommand.getRenderQueueID());
     
+    // the stencil is a rect: when it's aligned with the screen, the scissor test clips the same area
+    Rect stencilRect;
+    Rect scissorRect;
+    if (renderer->isClipRectAvailable() && _clippingStencil->getRectShape(&stencilRect) &&
+        Renderer::transformClipRect(stencilRect, _modelViewTransform * _clippingStencil->getNodeToParentTransform(), &scissorRect))
+    {
+        if (renderer->pushClipRect(&_beforeVisitCmdScissor, _globalZOrder, scissorRect))
+        {
+            visitContent(renderer, flags);
+        }
+        else
+        {
+            _contentSkipped = true;
+        }
+        renderer->popClipRect(&_afterVisitCmdScissor, _globalZOrder);
+        
+        renderer->popGroup();
+        
+        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        return;
+    }
+    
     _beforeVisitCmdStencil.init(_globalZOrder);
     _beforeVisitCmdStencil.func = CC_CALLBACK_0(Layout::onBeforeVisitStencil, this);
     renderer->addCommand(&_beforeVisitCmdStencil);
@@ -265,49 +295,7 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
     _afterDrawStencilCmd.func = CC_CALLBACK_0(Layout::onAfterDrawStencil, this);
     renderer->addCommand(&_afterDrawStencilCmd);
     
-    int i = 0;      // used by _children
-    int j = 0;      // used by _protectedChildren
-    
-    sortAllChildren();
-    sortAllProtectedChildren();
-    
-    //
-    // draw children and protectedChildren zOrder < 0
-    //
-    for( ; i < _children.size(); i++ )
-    {
-        auto node = _children.at(i);
-        
-        if ( node && node->getLocalZOrder() < 0 )
-            node->visit(renderer, _modelViewTransform, flags);
-        else
-            break;
-    }
-    
-    for( ; j < _protectedChildren.size(); j++ )
-    {
-        auto node = _protectedChildren.at(j);
-        
-        if ( node && node->getLocalZOrder() < 0 )
-            node->visit(renderer, _modelViewTransform, flags);
-        else
-            break;
-    }
-    
-    //
-    // draw self
-    //
-    this->draw(renderer, _modelViewTransform, flags);
-    
-    //
-    // draw children and protectedChildren zOrder >= 0
-    //
-    for(auto it=_protectedChildren.cbegin()+j; it != _protectedChildren.cend(); ++it)
-        (*it)->visit(renderer, _modelViewTransform, flags);
-    
-    for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
-        (*it)->visit(renderer, _modelViewTransform, flags);
-
+    visitContent(renderer, flags);
     
     _afterVisitCmdStencil.init(_globalZOrder);
     _afterVisitCmdStencil.func = CC_CALLBACK_0(Layout::onAfterVisitStencil, this);
@@ -325,27 +313,23 @@ void Layout::onBeforeVisitStencil()
     GLint mask_layer = 0x1 << s_layer;
     GLint mask_layer_l = mask_layer - 1;
     _mask_layer_le = mask_layer | mask_layer_l;
-    _currentStencilEnabled = glIsEnabled(GL_STENCIL_TEST);
-    glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&_currentStencilWriteMask);
-    glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&_currentStencilFunc);
-    glGetIntegerv(GL_STENCIL_REF, &_currentStencilRef);
-    glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint *)&_currentStencilValueMask);
-    glGetIntegerv(GL_STENCIL_FAIL, (GLint *)&_currentStencilFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)&_currentStencilPassDepthFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&_currentStencilPassDepthPass);
-    
-    glEnable(GL_STENCIL_TEST);
+    _currentStencilEnabled = GL::isStencilTestEnabled();
+    _currentStencilWriteMask = GL::getStencilMask();
+    GL::getStencilFunc(&_currentStencilFunc, &_currentStencilRef, &_currentStencilValueMask);
+    GL::getStencilOp(&_currentStencilFail, &_currentStencilPassDepthFail, &_currentStencilPassDepthPass);
+    
+    GL::enableStencilTest(true);
     CHECK_GL_ERROR_DEBUG();
-    glStencilMask(mask_layer);
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_currentDepthWriteMask);
-    glDepthMask(GL_FALSE);
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(GL_ZERO, GL_KEEP, GL_KEEP);
+    GL::stencilMask(mask_layer);
+    _currentDepthWriteMask = GL::getDepthMask();
+    GL::depthMask(GL_FALSE);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(GL_ZERO, GL_KEEP, GL_KEEP);
 
     this->drawFullScreenQuadClearStencil();
     
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
 #endif
 }
     
@@ -369,9 +353,9 @@ void Layout::drawFullScreenQuadClearStencil()
 void Layout::onAfterDrawStencil()
 {
 #if DIRECTX_ENABLED == 0
-    glDepthMask(_currentDepthWriteMask);
-    glStencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::depthMask(_currentDepthWriteMask);
+    GL::stencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 #endif
 }
 
@@ -379,45 +363,81 @@ void Layout::onAfterDrawStencil()
 void Layout::onAfterVisitStencil()
 {
 #if DIRECTX_ENABLED == 0
-    glStencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
-    glStencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
-    glStencilMask(_currentStencilWriteMask);
+    GL::stencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
+    GL::stencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
+    GL::stencilMask(_currentStencilWriteMask);
     if (!_currentStencilEnabled)
     {
-        glDisable(GL_STENCIL_TEST);
+        GL::enableStencilTest(false);
     }
     s_layer--;
 #endif
 }
     
-void Layout::onBeforeVisitScissor()
+void Layout::visitContent(Renderer *renderer, uint32_t flags)
 {
-#if DIRECTX_ENABLED == 0
-    Rect clippingRect = getClippingRect();
-    glEnable(GL_SCISSOR_TEST);
-    auto glview = Director::getInstance()->getOpenGLView();
-    glview->setScissorInPoints(clippingRect.origin.x, clippingRect.origin.y, clippingRect.size.width, clippingRect.size.height);
-#endif
-}
-
-void Layout::onAfterVisitScissor()
-{
-#if DIRECTX_ENABLED == 0
-    glDisable(GL_SCISSOR_TEST);
-#endif
+    int i = 0;      // used by _children
+    int j = 0;      // used by _protectedChildren
+    
+    sortAllChildren();
+    sortAllProtectedChildren();
+    
+    //
+    // draw children and protectedChildren zOrder < 0
+    //
+    for( ; i < _children.size(); i++ )
+    {
+        auto node = _children.at(i);
+        
+        if ( node && node->getLocalZOrder() < 0 )
+            node->visit(renderer, _modelViewTransform, flags);
+        else
+            break;
+    }
+    
+    for( ; j < _protectedChildren.size(); j++ )
+    {
+        auto node = _protectedChildren.at(j);
+        
+        if ( node && node->getLocalZOrder() < 0 )
+            node->visit(renderer, _modelViewTransform, flags);
+        else
+            break;
+    }
+    
+    //
+    // draw self
+    //
+    this->draw(renderer, _modelViewTransform, flags);
+    
+    //
+    // draw children and protectedChildren zOrder >= 0
+    //
+    for(auto it=_protectedChildren.cbegin()+j; it != _protectedChildren.cend(); ++it)
+        (*it)->visit(renderer, _modelViewTransform, flags);
+    
+    for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
+        (*it)->visit(renderer, _modelViewTransform, flags);
 }
     
 void Layout::scissorClippingVisit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags)
 {
-    _beforeVisitCmdScissor.init(_globalZOrder);
-    _beforeVisitCmdScissor.func = CC_CALLBACK_0(Layout::onBeforeVisitScissor, this);
-    renderer->addCommand(&_beforeVisitCmdScissor);
-
-    ProtectedNode::visit(renderer, parentTransform, parentFlags);
+    // the scissor clips the bounding box of the layout on the screen, intersected with the clip of the parents
+    Rect clippingRect;
+    Renderer::transformClipRect(Rect(0, 0, _contentSize.width, _contentSize.height), transform(parentTransform), &clippingRect);
+    
+    if (renderer->pushClipRect(&_beforeVisitCmdScissor, _globalZOrder, clippingRect))
+    {
+        // the transforms of the content were not updated while it was clipped out
+        ProtectedNode::visit(renderer, parentTransform, _contentSkipped ? (parentFlags | FLAGS_DIRTY_MASK) : parentFlags);
+        _contentSkipped = false;
+    }
+    else
+    {
+        _contentSkipped = true;
+    }
     
-    _afterVisitCmdScissor.init(_globalZOrder);
-    _afterVisitCmdScissor.func = CC_CALLBACK_0(Layout::onAfterVisitScissor, this);
-    renderer->addCommand(&_afterVisitCmdScissor);
+    renderer->popClipRect(&_afterVisitCmdScissor, _globalZOrder);
 }
 
 void Layout::setClippingEnabled(bool able)
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "ui/UIWidget.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
+#include "renderer/CCScissorCommand.h"
 
 NS_CC_BEGIN
 
@@ -327,6 +328,7 @@ protected:
     
     void stencilClippingVisit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags);
     void scissorClippingVisit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags);
+    void visitContent(Renderer *renderer, uint32_t flags);
     
     void setStencilClippingSize(const Size& size);
     const Rect& getClippingRect();
@@ -344,8 +346,6 @@ protected:
      */
     void drawFullScreenQuadClearStencil();
     
-    void onBeforeVisitScissor();
-    void onAfterVisitScissor();
     void updateBackGroundImageColor();
     void updateBackGroundImageOpacity();
     void updateBackGroundImageRGBA();
@@ -505,8 +505,10 @@ protected:
     CustomCommand _beforeVisitCmdStencil;
     CustomCommand _afterDrawStencilCmd;
     CustomCommand _afterVisitCmdStencil;
-    CustomCommand _beforeVisitCmdScissor;
-    CustomCommand _afterVisitCmdScissor;
+    ScissorCommand _beforeVisitCmdScissor;
+    ScissorCommand _afterVisitCmdScissor;
+    //whether the content was not visited last time, because its clip rect was empty
+    bool _contentSkipped;
     
     //whether enable loop focus or not
     bool _loopFocus;
@@ -31,6 +31,7 @@
 #include "2d/CCActionTween.h"
 #include "base/CCDirector.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/ccGLStateCache.h"
 
 #include <algorithm>
 
@@ -534,7 +535,7 @@ void ScrollView::onBeforeDraw()
         }
         else {
 #if DIRECTX_ENABLED == 0
-            glEnable(GL_SCISSOR_TEST);
+            GL::enableScissorTest(true);
 #endif			
             glview->setScissorInPoints(frame.origin.x, frame.origin.y, frame.size.width, frame.size.height);
         }
@@ -563,7 +564,7 @@ void ScrollView::onAfterDraw()
         }
         else {
 #if DIRECTX_ENABLED == 0
-            glDisable(GL_SCISSOR_TEST);
+            GL::enableScissorTest(false);
 #endif
         }
     }
@@ -665,7 +665,7 @@ void RawStencilBufferTest::draw(Renderer *renderer, const Mat4 &transform, uint3
 void RawStencilBufferTest::onEnableStencil()
 {
 #if DIRECTX_ENABLED == 0
-    glEnable(GL_STENCIL_TEST);
+    GL::enableStencilTest(true);
     CHECK_GL_ERROR_DEBUG();
 #endif
 }
@@ -673,7 +673,7 @@ void RawStencilBufferTest::onEnableStencil()
 void RawStencilBufferTest::onDisableStencil()
 {
 #if DIRECTX_ENABLED == 0
-    glDisable(GL_STENCIL_TEST);
+    GL::enableStencilTest(false);
     CHECK_GL_ERROR_DEBUG();
 #endif
 }
@@ -697,12 +697,12 @@ void RawStencilBufferTest::setupStencilForClippingOnPlane(GLint plane)
 {
 #if DIRECTX_ENABLED == 0
     GLint planeMask = 0x1 << plane;
-    glStencilMask(planeMask);
+    GL::stencilMask(planeMask);
     glClearStencil(0x0);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
-    glStencilFunc(GL_NEVER, planeMask, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, planeMask, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
 #endif
 }
 
@@ -710,8 +710,8 @@ void RawStencilBufferTest::setupStencilForDrawingOnPlane(GLint plane)
 {
 #if DIRECTX_ENABLED == 0
     GLint planeMask = 0x1 << plane;
-    glStencilFunc(GL_EQUAL, planeMask, planeMask);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_EQUAL, planeMask, planeMask);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 #endif
 }
 
@@ -726,14 +726,14 @@ void RawStencilBufferTest2::setupStencilForClippingOnPlane(GLint plane)
 {
 #if DIRECTX_ENABLED == 0
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 #endif
 }
 
 void RawStencilBufferTest2::setupStencilForDrawingOnPlane(GLint plane)
 {
 #if DIRECTX_ENABLED == 0
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 #endif
 }
@@ -749,15 +749,15 @@ void RawStencilBufferTest3::setupStencilForClippingOnPlane(GLint plane)
 {
 #if DIRECTX_ENABLED == 0
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::enableDepthTest(false);
+    GL::depthMask(GL_FALSE);
 #endif
 }
 
 void RawStencilBufferTest3::setupStencilForDrawingOnPlane(GLint plane)
 {
 #if DIRECTX_ENABLED == 0
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     //glEnable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 #endif
@@ -783,7 +783,7 @@ void RawStencilBufferTest4::setupStencilForClippingOnPlane(GLint plane)
 {
 #if DIRECTX_ENABLED == 0
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
@@ -805,7 +805,7 @@ void RawStencilBufferTest4::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 #endif
 }
@@ -821,8 +821,8 @@ void RawStencilBufferTest5::setupStencilForClippingOnPlane(GLint plane)
 {
 #if DIRECTX_ENABLED == 0
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::enableDepthTest(false);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
@@ -844,7 +844,7 @@ void RawStencilBufferTest5::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     //glEnable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 #endif
@@ -865,7 +865,7 @@ void RawStencilBufferTest6::setup()
     auto winPoint = Vec2(Director::getInstance()->getWinSize());
     //by default, glReadPixels will pack data with 4 bytes allignment
     unsigned char bits[4] = {0,0,0,0};
-    glStencilMask(~0);
+    GL::stencilMask(~0);
     glClearStencil(0);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
@@ -873,7 +873,7 @@ void RawStencilBufferTest6::setup()
     auto clearToZeroLabel = Label::createWithTTF(String::createWithFormat("00=%02x", bits[0])->getCString(), "fonts/arial.ttf", 20);
     clearToZeroLabel->setPosition( Vec2((winPoint.x / 3) * 1, winPoint.y - 10) );
     this->addChild(clearToZeroLabel);
-    glStencilMask(0x0F);
+    GL::stencilMask(0x0F);
     glClearStencil(0xAA);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
@@ -882,7 +882,7 @@ void RawStencilBufferTest6::setup()
     clearToMaskLabel->setPosition( Vec2((winPoint.x / 3) * 2, winPoint.y - 10) );
     this->addChild(clearToMaskLabel);
 #endif
-    glStencilMask(~0);
+    GL::stencilMask(~0);
 #endif
 }
 
@@ -890,14 +890,14 @@ void RawStencilBufferTest6::setupStencilForClippingOnPlane(GLint plane)
 {
 #if DIRECTX_ENABLED == 0
     GLint planeMask = 0x1 << plane;
-    glStencilMask(planeMask);
-    glStencilFunc(GL_NEVER, 0, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilMask(planeMask);
+    GL::stencilFunc(GL_NEVER, 0, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
     DrawPrimitives::drawSolidRect(Vec2::ZERO, Vec2(Director::getInstance()->getWinSize()), Color4F(1, 1, 1, 1));
-    glStencilFunc(GL_NEVER, planeMask, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::stencilFunc(GL_NEVER, planeMask, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::enableDepthTest(false);
+    GL::depthMask(GL_FALSE);
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
     glAlphaFunc(GL_GREATER, _alphaThreshold);
@@ -919,7 +919,7 @@ void RawStencilBufferTest6::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     //glEnable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
     glFlush();
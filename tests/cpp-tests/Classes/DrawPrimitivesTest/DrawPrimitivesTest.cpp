@@ -18,11 +18,13 @@ static Layer* create##className() \
 
 DRAWPRIMITIVES_CREATE_FUNC(DrawPrimitivesTest);
 DRAWPRIMITIVES_CREATE_FUNC(DrawNodeTest);
+DRAWPRIMITIVES_CREATE_FUNC(DrawNodeBatchingTest);
 
 static NEWDRAWPRIMITIVESFUNC createFunctions[] =
 {
     createDrawPrimitivesTest,
     createDrawNodeTest,
+    createDrawNodeBatchingTest,
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -324,6 +326,38 @@ string DrawNodeTest::subtitle() const
     return "Testing DrawNode - batched draws. Concave polygons are BROKEN";
 }
 
+DrawNodeBatchingTest::DrawNodeBatchingTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // a grid of small static nodes, drawn with a single draw call
+    const int columns = 20;
+    const int rows = 10;
+    for (int i = 0; i < columns * rows; i++)
+    {
+        auto draw = DrawNode::create();
+        draw->setBatchingEnabled(true);
+        draw->setPosition(Vec2(s.width * (i % columns + 0.5f) / columns, s.height * (i / columns + 0.5f) / rows));
+        addChild(draw);
+
+        Color4F color(CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1(), 1);
+        draw->drawDot(Vec2::ZERO, 6, color);
+        draw->drawSegment(Vec2(-8, -8), Vec2(8, 8), 1, color);
+
+        draw->runAction(RepeatForever::create(RotateBy::create(2, 360)));
+    }
+}
+
+string DrawNodeBatchingTest::title() const
+{
+    return "DrawNode batching";
+}
+
+string DrawNodeBatchingTest::subtitle() const
+{
+    return "200 DrawNodes should be drawn in 1 draw call";
+}
+
 void DrawPrimitivesTestScene::runThisTest()
 {
     auto layer = nextAction();
@@ -43,6 +43,15 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class DrawNodeBatchingTest : public BaseLayer
+{
+public:
+    DrawNodeBatchingTest();
+    
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 class DrawPrimitivesTestScene : public TestScene
 {
 public:
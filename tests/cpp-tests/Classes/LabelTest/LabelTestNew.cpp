@@ -80,7 +80,9 @@ static std::function<Layer*()> createFunctions[] =
     CL(LabelIssue4428Test),
     CL(LabelIssue4999Test),
     CL(LabelLineHeightTest),
-    CL(LabelAdditionalKerningTest)
+    CL(LabelAdditionalKerningTest),
+    CL(LabelAsyncRasterizationTest),
+    CL(LabelSystemFontCacheTest)
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -1863,3 +1865,117 @@ std::string LabelAdditionalKerningTest::subtitle() const
 {
     return "Testing additional kerning of label";
 }
+
+LabelAsyncRasterizationTest::LabelAsyncRasterizationTest()
+: _firstLetter(0)
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 96, GlyphCollection::DYNAMIC,nullptr,false);
+
+    _label = Label::createWithTTF(ttfConfig,"0123456789");
+    _label->setPosition( Vec2(size.width/2, size.height*0.6f) );
+    addChild(_label);
+
+    // two pages only hold part of the letters shown below, so the least recently used ones are evicted.
+    // The atlas is shared with the other labels using the font: its settings are restored on exit
+    auto atlas = _label->getFontAtlas();
+    _savedMaxPageCount = atlas->getMaxPageCount();
+    _savedAsyncRasterization = atlas->isAsyncRasterizationEnabled();
+    atlas->setMaxPageCount(2);
+    atlas->setAsyncRasterizationEnabled(true);
+    atlas->prewarm(std::string("ABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+
+    _infoLabel = Label::createWithSystemFont("", "Arial", 16);
+    _infoLabel->setPosition( Vec2(size.width/2, size.height*0.3f) );
+    addChild(_infoLabel);
+
+    schedule(schedule_selector(LabelAsyncRasterizationTest::updateString), 0.5f);
+}
+
+void LabelAsyncRasterizationTest::updateString(float dt)
+{
+    // cycles through the Latin-1 letters, 8 at a time
+    std::u16string utf16String;
+    for (int i = 0; i < 8; ++i)
+    {
+        utf16String.push_back(char16_t(0x41 + (_firstLetter + i) % 0xbe));
+    }
+    _firstLetter += 8;
+
+    std::string utf8String;
+    StringUtils::UTF16ToUTF8(utf16String, utf8String);
+    _label->setString(utf8String);
+
+    auto atlas = _label->getFontAtlas();
+    char info[100];
+    sprintf(info, "pages: %d  evictions: %u", (int)atlas->getTextures().size(), atlas->getEvictionCount());
+    _infoLabel->setString(info);
+}
+
+void LabelAsyncRasterizationTest::onExit()
+{
+    auto atlas = _label->getFontAtlas();
+    atlas->setMaxPageCount(_savedMaxPageCount);
+    atlas->setAsyncRasterizationEnabled(_savedAsyncRasterization);
+
+    AtlasDemoNew::onExit();
+}
+
+std::string LabelAsyncRasterizationTest::title() const
+{
+    return "New Label + TTF";
+}
+
+std::string LabelAsyncRasterizationTest::subtitle() const
+{
+    return "Letters rasterized on a worker, in 2 atlas pages at most";
+}
+
+LabelSystemFontCacheTest::LabelSystemFontCacheTest()
+: _score(0)
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    // the labels show the same strings, so they share the textures of the StringTextureCache
+    for (int i = 0; i < 12; ++i)
+    {
+        auto label = Label::createWithSystemFont("0", "Arial", 24);
+        label->setAsyncRenderingEnabled(true);
+        label->setPosition( Vec2(size.width * ((i % 4) + 1) / 5, size.height * (0.7f - (i / 4) * 0.15f)) );
+        addChild(label);
+        _labels.pushBack(label);
+    }
+
+    _infoLabel = Label::createWithSystemFont("", "Arial", 16);
+    _infoLabel->setPosition( Vec2(size.width/2, size.height*0.2f) );
+    addChild(_infoLabel);
+
+    schedule(schedule_selector(LabelSystemFontCacheTest::updateScore), 0.1f);
+}
+
+void LabelSystemFontCacheTest::updateScore(float dt)
+{
+    // the scores repeat every 20 updates, so the cache ends up holding all of them
+    _score = (_score + 1) % 20;
+    auto score = StringUtils::format("%d", _score * 100);
+    for (auto& label : _labels)
+    {
+        label->setString(score);
+    }
+
+    auto& statistics = StringTextureCache::getInstance()->getStatistics();
+    char info[100];
+    sprintf(info, "hits: %u  misses: %u  cached: %u (%d KB)", statistics.hits, statistics.misses, statistics.cached, (int)(statistics.cachedMemory / 1024));
+    _infoLabel->setString(info);
+}
+
+std::string LabelSystemFontCacheTest::title() const
+{
+    return "New Label + System Font";
+}
+
+std::string LabelSystemFontCacheTest::subtitle() const
+{
+    return "Labels showing the same text share a texture rendered on a worker";
+}
@@ -526,6 +526,43 @@ private:
     Label* label;
 };
 
+class LabelAsyncRasterizationTest : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelAsyncRasterizationTest);
+
+    LabelAsyncRasterizationTest();
+
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void updateString(float dt);
+private:
+    Label* _label;
+    Label* _infoLabel;
+    int _firstLetter;
+    int _savedMaxPageCount;
+    bool _savedAsyncRasterization;
+};
+
+class LabelSystemFontCacheTest : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelSystemFontCacheTest);
+
+    LabelSystemFontCacheTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void updateScore(float dt);
+private:
+    Vector<Label*> _labels;
+    Label* _infoLabel;
+    int _score;
+};
+
 // we don't support linebreak mode
 
 #endif
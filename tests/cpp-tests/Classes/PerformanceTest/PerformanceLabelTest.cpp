@@ -1,10 +1,12 @@
 #include "PerformanceLabelTest.h"
 
+#include <chrono>
+
 enum {
     kMaxNodes = 200,
     kNodesIncrease = 10,
 
-    TEST_COUNT = 5,
+    TEST_COUNT = 6,
 };
 
 enum {
@@ -19,7 +21,8 @@ enum {
     kCaseLabelBMFontUpdate,
     kCaseLabelUpdate,
     kCaseLabelBMFontBigLabels,
-    kCaseLabelBigLabels
+    kCaseLabelBigLabels,
+    kCaseLabelCounterUpdate
 };
 
 #define LongSentencesExample "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\
@@ -87,6 +90,9 @@ void LabelMainScene::initWithSubTest(int nodes)
     _lastRenderedCount = 0;
     _quantityNodes = 0;
     _accumulativeTime = 0.0f;
+    _counter = 0;
+    _setStringCalls = 0;
+    _setStringSeconds = 0;
 
     _labelContainer = Layer::create();
     addChild(_labelContainer);
@@ -158,6 +164,8 @@ std::string LabelMainScene::title() const
         return "Testing LabelBMFont Big Labels";
     case kCaseLabelBigLabels:
         return "Testing Label Big Labels";
+    case kCaseLabelCounterUpdate:
+        return "Testing Label Counter setString";
     default:
         break;
     }
@@ -247,6 +255,19 @@ void LabelMainScene::onIncrease(Ref* sender)
             }
             break;
         }        
+    case kCaseLabelCounterUpdate:
+        {
+            TTFConfig ttfConfig("fonts/arial.ttf", 30, GlyphCollection::DYNAMIC);
+            for( int i=0;i< kNodesIncrease;i++)
+            {
+                auto label = Label::createWithTTF(ttfConfig, "Score: 00000000", TextHAlignment::LEFT);
+                label->setPosition(Vec2((size.width/2 + rand() % 50), ((int)size.height/2 + rand() % 50)));
+                _labelContainer->addChild(label, 1, _quantityNodes);
+
+                _quantityNodes++;
+            }
+            break;
+        }
     default:
         break;
     }
@@ -310,7 +331,7 @@ void LabelMainScene::updateAutoTest(float dt)
 
 void LabelMainScene::updateText(float dt)
 {
-    if(_s_labelCurCase > kCaseLabelUpdate)
+    if(_s_labelCurCase > kCaseLabelUpdate && _s_labelCurCase != kCaseLabelCounterUpdate)
         return;
 
     _accumulativeTime += dt;
@@ -339,6 +360,34 @@ void LabelMainScene::updateText(float dt)
             label->setString(text);
         }
         break;
+    case kCaseLabelCounterUpdate:
+        {
+            typedef std::chrono::high_resolution_clock clock;
+
+            // a score counter changing several times per frame: getContentSize() lays out every string
+            auto start = clock::now();
+            for (int i = 0; i < 10; ++i)
+            {
+                sprintf(text, "Score: %08d", ++_counter);
+                for(const auto &child : children) {
+                    Label* label = (Label*)child;
+                    label->setString(text);
+                    label->getContentSize();
+                }
+            }
+            _setStringSeconds += std::chrono::duration<double>(clock::now() - start).count();
+            _setStringCalls += 10 * static_cast<int>(children.size());
+
+            if (_setStringSeconds > 0.0 && _accumulativeTime >= 1.0f)
+            {
+                auto infoLabel = (Label *) getChildByTag(kTagInfoLayer);
+                infoLabel->setString(StringUtils::format("%u nodes, %.0f setString/s", _quantityNodes, _setStringCalls / _setStringSeconds));
+                _accumulativeTime = 0.0f;
+                _setStringCalls = 0;
+                _setStringSeconds = 0;
+            }
+        }
+        break;
     default:
         break;
     }
@@ -377,6 +426,8 @@ void LabelMainScene::autoShowLabelTests(int curCase,int nodes)
     _lastRenderedCount = 0;
     _quantityNodes = 0;
     _accumulativeTime = 0.0f;
+    _setStringCalls = 0;
+    _setStringSeconds = 0;
     while(_quantityNodes < nodes)
         onIncrease(this);
 }
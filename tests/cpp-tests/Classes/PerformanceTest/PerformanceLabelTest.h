@@ -48,7 +48,7 @@ public:
 
 private:
     static const  int MAX_AUTO_TEST_TIMES  = 35;
-    static const  int MAX_SUB_TEST_NUMS    = 5;
+    static const  int MAX_SUB_TEST_NUMS    = 6;
     
 
     void  dumpProfilerFPS();
@@ -67,6 +67,11 @@ private:
     int            _executeTimes;
 
     float          _accumulativeTime;
+
+    // the counter case measures the setString calls per second
+    int            _counter;
+    int            _setStringCalls;
+    double         _setStringSeconds;
 };
 
 void runLabelTest();
@@ -10,6 +10,8 @@
 #include "PerformanceTextureTest.h"
 #include "../testResource.h"
 
+#include <chrono>
+
 RenderTestLayer::RenderTestLayer()
 : PerformBasicLayer(true, 1, 1)
 {
@@ -53,3 +55,108 @@ void runRendererTest()
     auto scene = RenderTestLayer::scene();
     Director::getInstance()->replaceScene(scene);
 }
+
+////////////////////////////////////////////////////////
+//
+// RenderTransformTestLayer
+//
+////////////////////////////////////////////////////////
+RenderTransformTestLayer::RenderTransformTestLayer()
+: PerformBasicLayer(false)
+, _scalarSeconds(0)
+, _batchSeconds(0)
+, _frames(0)
+, _resultLabel(nullptr)
+{
+}
+
+Scene* RenderTransformTestLayer::scene()
+{
+    auto scene = Scene::create();
+    auto layer = new RenderTransformTestLayer();
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+void RenderTransformTestLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto title = Label::createWithTTF("Quad vertex transform", "fonts/arial.ttf", 32);
+    title->setPosition(Vec2(s.width/2, s.height-50));
+    addChild(title);
+
+    _resultLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _resultLabel->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(_resultLabel);
+
+    _sourceQuads.resize(QUAD_COUNT);
+    for (int i = 0; i < QUAD_COUNT; ++i)
+    {
+        auto& quad = _sourceQuads[i];
+        float x = (float)(i % 100) * 10;
+        float y = (float)(i / 100) * 10;
+        quad.bl.vertices = Vec3(x, y, 0);
+        quad.br.vertices = Vec3(x + 10, y, 0);
+        quad.tl.vertices = Vec3(x, y + 10, 0);
+        quad.tr.vertices = Vec3(x + 10, y + 10, 0);
+    }
+    _quads = _sourceQuads;
+
+    Mat4::createRotationZ(0.3f, &_modelView);
+    _modelView.translate(20, 30, 0);
+    _modelView.scale(1.5f);
+
+    scheduleUpdate();
+}
+
+void RenderTransformTestLayer::update(float dt)
+{
+    typedef std::chrono::high_resolution_clock clock;
+
+    // same loop as Renderer::convertToWorldCoordinates used to run
+    _quads = _sourceQuads;
+    auto start = clock::now();
+    for (auto& quad : _quads)
+    {
+        _modelView.transformPoint(&quad.bl.vertices);
+        _modelView.transformPoint(&quad.br.vertices);
+        _modelView.transformPoint(&quad.tr.vertices);
+        _modelView.transformPoint(&quad.tl.vertices);
+    }
+    _scalarSeconds += std::chrono::duration<double>(clock::now() - start).count();
+
+    _quads = _sourceQuads;
+    start = clock::now();
+    MathUtil::transformVertices(_modelView.m, (float*)&_quads[0].tl.vertices, _quads.size() * 4, sizeof(V3F_C4B_T2F));
+    _batchSeconds += std::chrono::duration<double>(clock::now() - start).count();
+
+    if (++_frames == 60)
+    {
+        double scalarRate = QUAD_COUNT * _frames / _scalarSeconds;
+        double batchRate = QUAD_COUNT * _frames / _batchSeconds;
+
+        auto result = StringUtils::format("Mat4::transformPoint: %.2f M quads/sec\nMathUtil::transformVertices: %.2f M quads/sec",
+                                          scalarRate / 1000000, batchRate / 1000000);
+        _resultLabel->setString(result);
+        CCLOG("%s", result.c_str());
+
+        _scalarSeconds = _batchSeconds = 0;
+        _frames = 0;
+    }
+}
+
+void RenderTransformTestLayer::showCurrentTest()
+{
+
+}
+
+void runRendererTransformTest()
+{
+    auto scene = RenderTransformTestLayer::scene();
+    Director::getInstance()->replaceScene(scene);
+}
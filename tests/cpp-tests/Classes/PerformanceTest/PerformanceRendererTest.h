@@ -24,5 +24,30 @@ public:
     static Scene* scene();
 };
 
+class RenderTransformTestLayer : public PerformBasicLayer
+{
+public:
+    RenderTransformTestLayer();
+
+    virtual void onEnter() override;
+    virtual void showCurrentTest() override;
+    virtual void update(float dt) override;
+
+    static Scene* scene();
+
+protected:
+    static const int QUAD_COUNT = 10000;
+
+    std::vector<V3F_C4B_T2F_Quad> _sourceQuads;
+    std::vector<V3F_C4B_T2F_Quad> _quads;
+    Mat4 _modelView;
+
+    double _scalarSeconds;
+    double _batchSeconds;
+    int _frames;
+    Label* _resultLabel;
+};
+
 void runRendererTest();
+void runRendererTransformTest();
 #endif
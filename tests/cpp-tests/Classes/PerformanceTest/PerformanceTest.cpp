@@ -29,9 +29,11 @@ struct {
 	{ "Particle Test",[](Ref*sender){runParticleTest();} },
 	{ "Sprite Perf Test",[](Ref*sender){runSpriteTest();} },
 	{ "Texture Perf Test",[](Ref*sender){runTextureTest();} },
+    { "Pixel Conversion Perf Test",[](Ref*sender){runPixelConversionTest();} },
 	{ "Touches Perf Test",[](Ref*sender){runTouchesTest();} },
     { "Label Perf Test",[](Ref*sender){runLabelTest();} },
     //{ "Renderer Perf Test",[](Ref*sender){runRendererTest();} },
+    { "Renderer Transform Perf Test",[](Ref*sender){runRendererTransformTest();} },
     { "Container Perf Test", [](Ref* sender ) { runContainerPerformanceTest(); } },
     { "EventDispatcher Perf Test", [](Ref* sender ) { runEventDispatcherPerformanceTest(); } },
     { "Scenario Perf Test", [](Ref* sender ) { runScenarioTest(); } },
@@ -1,4 +1,7 @@
 #include "PerformanceTextureTest.h"
+#include "renderer/ccPixelConversion.h"
+
+#include <chrono>
 
 enum
 {
@@ -361,3 +364,109 @@ void runTextureTest()
     auto scene = TextureTest::scene();
     Director::getInstance()->replaceScene(scene);
 }
+
+////////////////////////////////////////////////////////
+//
+// PixelConversionTest
+//
+////////////////////////////////////////////////////////
+void PixelConversionTest::showCurrentTest()
+{
+    Director::getInstance()->replaceScene(PixelConversionTest::scene());
+}
+
+void PixelConversionTest::performTests()
+{
+    typedef std::chrono::high_resolution_clock clock;
+    const int size = 2048;
+
+    // generated pixels, a 2048x2048 texture isn't supported everywhere and only the CPU side is measured
+    std::vector<unsigned char> rgba(size * size * 4);
+    std::vector<unsigned char> rgb(size * size * 3);
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < rgba.size(); ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        rgba[i] = (unsigned char)(seed >> 16);
+    }
+    for (size_t i = 0, j = 0; i < rgb.size(); i += 3, j += 4)
+    {
+        rgb[i] = rgba[j];
+        rgb[i + 1] = rgba[j + 1];
+        rgb[i + 2] = rgba[j + 2];
+    }
+
+    static const struct
+    {
+        const char* name;
+        Texture2D::PixelFormat from;
+        Texture2D::PixelFormat to;
+    } conversions[] = {
+        { "RGBA8888 -> RGBA4444", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGBA4444 },
+        { "RGBA8888 -> RGB5A1", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGB5A1 },
+        { "RGBA8888 -> RGB565", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGB565 },
+        { "RGBA8888 -> AI88", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::AI88 },
+        { "RGBA8888 -> A8", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::A8 },
+        { "RGB888 -> RGBA8888", Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::RGBA8888 },
+        { "RGB888 -> RGB565", Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::RGB565 },
+    };
+
+    auto supported = PixelConversion::getSupportedInstructionSet();
+    auto previous = PixelConversion::getInstructionSet();
+
+    log("--- %dx%d pixel conversion, supported: %s ---", size, size, PixelConversion::getInstructionSetName(supported));
+    for (int set = (int)PixelConversion::InstructionSet::SCALAR; set <= (int)supported; ++set)
+    {
+        auto instructionSet = (PixelConversion::InstructionSet)set;
+        PixelConversion::setInstructionSet(instructionSet);
+        log("%s", PixelConversion::getInstructionSetName(instructionSet));
+
+        for (const auto& conversion : conversions)
+        {
+            const auto& src = conversion.from == Texture2D::PixelFormat::RGB888 ? rgb : rgba;
+            unsigned char* outData = nullptr;
+            ssize_t outDataLen = 0;
+
+            auto start = clock::now();
+            Texture2D::convertDataToFormat(src.data(), src.size(), conversion.from, conversion.to, &outData, &outDataLen);
+            double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+            log("  %s ms:%f", conversion.name, ms);
+
+            if (outData != src.data())
+                free(outData);
+        }
+
+        std::vector<unsigned char> pixels(rgba);
+        auto start = clock::now();
+        PixelConversion::premultiplyAlpha(pixels.data(), pixels.size());
+        log("  premultiply alpha ms:%f", std::chrono::duration<double, std::milli>(clock::now() - start).count());
+    }
+
+    PixelConversion::setInstructionSet(previous);
+}
+
+std::string PixelConversionTest::title() const
+{
+    return "Pixel Conversion Performance Test";
+}
+
+std::string PixelConversionTest::subtitle() const
+{
+    return "See console for results";
+}
+
+Scene* PixelConversionTest::scene()
+{
+    auto scene = Scene::create();
+    auto layer = new PixelConversionTest();
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+void runPixelConversionTest()
+{
+    auto scene = PixelConversionTest::scene();
+    Director::getInstance()->replaceScene(scene);
+}
@@ -35,6 +35,23 @@ public:
     static Scene* scene();
 };
 
+class PixelConversionTest : public TextureMenuLayer
+{
+public:
+    PixelConversionTest()
+        :TextureMenuLayer(false)
+    {
+    }
+
+    virtual void showCurrentTest() override;
+    virtual void performTests() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    static Scene* scene();
+};
+
 void runTextureTest();
+void runPixelConversionTest();
 
 #endif
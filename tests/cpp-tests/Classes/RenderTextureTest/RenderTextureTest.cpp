@@ -107,8 +107,9 @@ RenderTextureSave::RenderTextureSave()
     // Save Image menu
     MenuItemFont::setFontSize(16);
     auto item1 = MenuItemFont::create("Save Image", CC_CALLBACK_1(RenderTextureSave::saveImage, this));
-    auto item2 = MenuItemFont::create("Clear", CC_CALLBACK_1(RenderTextureSave::clearImage, this));
-    auto menu = Menu::create(item1, item2, NULL);
+    auto item2 = MenuItemFont::create("Save Image Async", CC_CALLBACK_1(RenderTextureSave::saveImageAsync, this));
+    auto item3 = MenuItemFont::create("Clear", CC_CALLBACK_1(RenderTextureSave::clearImage, this));
+    auto menu = Menu::create(item1, item2, item3, NULL);
     this->addChild(menu);
     menu->alignItemsVertically();
     menu->setPosition(Vec2(VisibleRect::rightTop().x - 80, VisibleRect::rightTop().y - 30));
@@ -158,6 +159,32 @@ void RenderTextureSave::saveImage(cocos2d::Ref *sender)
     counter++;
 }
 
+void RenderTextureSave::saveImageAsync(cocos2d::Ref *sender)
+{
+    static int counter = 0;
+
+    char png[30];
+    sprintf(png, "image-async-%d.png", counter);
+
+    // keep the layer alive until the file is written
+    this->retain();
+    _target->saveToFileAsync(png, Image::Format::PNG, true, [this](bool succeeded, const std::string& fullpath)
+    {
+        if (succeeded)
+        {
+            auto sprite = Sprite::create(fullpath);
+            addChild(sprite);
+            sprite->setScale(0.3f);
+            sprite->setPosition(Vec2(VisibleRect::right().x - 40, 40));
+            sprite->setRotation(counter * 3);
+            CCLOG("Image saved %s", fullpath.c_str());
+        }
+        this->release();
+    });
+
+    counter++;
+}
+
 RenderTextureSave::~RenderTextureSave()
 {
     _target->release();
@@ -545,7 +572,7 @@ void RenderTextureTestDepthStencil::draw(Renderer *renderer, const Mat4 &transfo
 void RenderTextureTestDepthStencil::onBeforeClear()
 {
 #if DIRECTX_ENABLED == 0
-    glStencilMask(0xFF);
+    GL::stencilMask(0xFF);
 #endif
 }
 
@@ -553,23 +580,23 @@ void RenderTextureTestDepthStencil::onBeforeStencil()
 {
 #if DIRECTX_ENABLED == 0
     //! mark sprite quad into stencil buffer
-    glEnable(GL_STENCIL_TEST);
-    glStencilFunc(GL_NEVER, 1, 0xFF);
-    glStencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
+    GL::enableStencilTest(true);
+    GL::stencilFunc(GL_NEVER, 1, 0xFF);
+    GL::stencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
 #endif
 }
 
 void RenderTextureTestDepthStencil::onBeforDraw()
 {
 #if DIRECTX_ENABLED == 0
-    glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
+    GL::stencilFunc(GL_NOTEQUAL, 1, 0xFF);
 #endif
 }
 
 void RenderTextureTestDepthStencil::onAfterDraw()
 {
 #if DIRECTX_ENABLED == 0
-    glDisable(GL_STENCIL_TEST);
+    GL::enableStencilTest(false);
 #endif
 }
 
@@ -28,6 +28,7 @@ public:
     void onTouchesMoved(const std::vector<Touch*>& touches, Event* event);
     void clearImage(Ref *pSender);
     void saveImage(Ref *pSender);
+    void saveImageAsync(Ref *pSender);
 
 private:
     RenderTexture *_target;
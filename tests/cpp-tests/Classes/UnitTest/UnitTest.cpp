@@ -8,7 +8,8 @@ static std::function<Layer*()> createFunctions[] = {
     CL(TemplateMapTest),
     CL(ValueTest),
     CL(RefPtrTest),
-    CL(UTFConversionTest)
+    CL(UTFConversionTest),
+    CL(DynamicAtlasTest)
 };
 
 static int sceneIdx = -1;
@@ -816,3 +817,48 @@ std::string UTFConversionTest::subtitle() const
 {
     return "UTF8 <-> UTF16 Conversion Test, no crash";
 }
+
+void DynamicAtlasTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    auto textureCache = Director::getInstance()->getTextureCache();
+    auto atlas = textureCache->getDynamicAtlas();
+    bool wasEnabled = atlas->isEnabled();
+    atlas->setEnabled(true);
+
+    // images already loaded as textures are not packed
+    textureCache->removeTextureForKey("Images/grossini_dance_01.png");
+    textureCache->removeTextureForKey("Images/grossini_dance_02.png");
+
+    auto frame1 = atlas->addImage("Images/grossini_dance_01.png");
+    CCASSERT(frame1 && atlas->isPageTexture(frame1->getTexture()), "");
+
+    auto s = Director::getInstance()->getWinSize();
+    auto sprite = Sprite::createWithSpriteFrame(frame1);
+    sprite->setPosition(Vec2(s.width/3, s.height/2));
+    addChild(sprite);
+
+    // the sprite still displays the removed image, so its region must not be reused
+    Rect rect1 = CC_RECT_POINTS_TO_PIXELS(sprite->getTextureRect());
+    textureCache->removeTextureForKey("Images/grossini_dance_01.png");
+    CCASSERT(!atlas->getSpriteFrame("Images/grossini_dance_01.png"), "");
+
+    auto frame2 = atlas->addImage("Images/grossini_dance_02.png");
+    CCASSERT(frame2 && atlas->isPageTexture(frame2->getTexture()), "");
+    Rect rect2 = CC_RECT_POINTS_TO_PIXELS(frame2->getRect());
+    CCASSERT(frame2->getTexture() != sprite->getTexture() || !rect1.intersectsRect(rect2), "");
+    CCASSERT(sprite->getTextureRect().equals(CC_RECT_PIXELS_TO_POINTS(rect1)), "");
+
+    auto sprite2 = Sprite::createWithSpriteFrame(frame2);
+    sprite2->setPosition(Vec2(s.width*2/3, s.height/2));
+    addChild(sprite2);
+
+    atlas->removeImage("Images/grossini_dance_02.png");
+    atlas->setEnabled(wasEnabled);
+}
+
+std::string DynamicAtlasTest::subtitle() const
+{
+    return "DynamicAtlas keeps the regions still displayed, no assert";
+}
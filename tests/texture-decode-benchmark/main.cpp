@@ -0,0 +1,180 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Decodes ETC1, S3TC and ATITC files with the software decoders of Image, without creating a GL context.
+// Configuration has no GPU info, so Image never keeps the compressed data and always decompresses.
+//
+// usage: texture-decode-benchmark [-n iterations] [files...]
+// Without files, the compressed images of cpp-tests are used.
+// Each file is decoded single threaded with plain C, then with every other combination of
+// instruction set and threading. The output of each combination is checked against the first one.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "platform/CCImage.h"
+#include "renderer/ccPixelConversion.h"
+#include "base/CCThreadPool.h"
+
+USING_NS_CC;
+
+#ifndef SAMPLE_IMAGES_DIR
+#define SAMPLE_IMAGES_DIR ""
+#endif
+
+static const char* s_sampleFiles[] = {
+    "ETC1.pkm",
+    "test_256x256_s3tc_dxt1_mipmaps.dds",
+    "test_256x256_s3tc_dxt3_mipmaps.dds",
+    "test_256x256_s3tc_dxt5_mipmaps.dds",
+    "test_512x512_s3tc_dxt5_with_no_mipmaps.dds",
+    "water_2_dxt1.dds",
+    "water_2_dxt3.dds",
+    "water_2_dxt5.dds",
+    "test_256x256_ATC_RGB_mipmaps.ktx",
+    "test_256x256_ATC_RGBA_Explicit_mipmaps.ktx",
+    "test_256x256_ATC_RGBA_Interpolated_mipmaps.ktx",
+};
+
+static bool readFile(const std::string& path, std::vector<unsigned char>& outData)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    outData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !outData.empty();
+}
+
+// Returns the average time of one decode in milliseconds, or a negative value if the decode failed
+static double decode(const std::vector<unsigned char>& fileData, int iterations, std::vector<unsigned char>& outPixels)
+{
+    double total = 0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        Image* image = new Image();
+        auto start = std::chrono::steady_clock::now();
+        bool ok = image->initWithImageData(fileData.data(), fileData.size());
+        auto end = std::chrono::steady_clock::now();
+        if (!ok)
+        {
+            image->release();
+            return -1;
+        }
+        total += std::chrono::duration<double, std::milli>(end - start).count();
+        if (i == 0)
+        {
+            outPixels.assign(image->getData(), image->getData() + image->getDataLen());
+        }
+        image->release();
+    }
+    return total / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 20;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            iterations = std::max(1, atoi(argv[++i]));
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.empty())
+    {
+        for (const char* name : s_sampleFiles)
+        {
+            files.push_back(std::string(SAMPLE_IMAGES_DIR) + name);
+        }
+    }
+
+    std::vector<PixelConversion::InstructionSet> instructionSets;
+    instructionSets.push_back(PixelConversion::InstructionSet::SCALAR);
+    if (PixelConversion::getSupportedInstructionSet() != PixelConversion::InstructionSet::SCALAR)
+    {
+        instructionSets.push_back(PixelConversion::getSupportedInstructionSet());
+    }
+
+    int failures = 0;
+    for (const auto& path : files)
+    {
+        std::vector<unsigned char> fileData;
+        if (!readFile(path, fileData))
+        {
+            printf("%s: can't read the file\n", path.c_str());
+            ++failures;
+            continue;
+        }
+
+        printf("%s\n", path.c_str());
+        std::vector<unsigned char> reference;
+        bool first = true;
+        for (bool parallel : {false, true})
+        {
+            for (auto instructionSet : instructionSets)
+            {
+                PixelConversion::setInstructionSet(instructionSet);
+                Image::setParallelDecodeEnabled(parallel);
+
+                std::vector<unsigned char> pixels;
+                double time = decode(fileData, iterations, pixels);
+                const char* status = "";
+                if (time < 0)
+                {
+                    status = "  DECODE FAILED";
+                    ++failures;
+                }
+                else if (first)
+                {
+                    reference.swap(pixels);
+                    first = false;
+                }
+                else if (pixels != reference)
+                {
+                    status = "  OUTPUT DIFFERS";
+                    ++failures;
+                }
+                printf("    %-4s %-15s %8.3f ms%s\n", PixelConversion::getInstructionSetName(instructionSet),
+                       parallel ? "thread pool" : "single thread", time, status);
+            }
+        }
+    }
+
+    ThreadPool::destroyInstance();
+    return failures == 0 ? 0 : 1;
+}